@@ -0,0 +1,169 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/import_hash.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+const std::size_t IMPORTS_PER_MODULE = 150;
+
+class Fnv1aHash
+{
+public:
+	void update(const void * data, std::size_t size)
+	{
+		const auto * const bytes = static_cast<const unsigned char *>(data);
+		for (std::size_t i = 0; i < size; ++i) {
+			_hash ^= bytes[i];
+			_hash *= 0x100000001b3;
+		}
+	}
+
+	std::uint64_t digest() const { return _hash; }
+
+private:
+	std::uint64_t _hash = 0xcbf29ce484222325;
+};
+
+std::vector<char> build_import_image(std::size_t import_count)
+{
+	const std::size_t module_count = (import_count + IMPORTS_PER_MODULE - 1) / IMPORTS_PER_MODULE;
+
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	const DWORD idata_rva = builder.next_section_rva();
+
+	std::vector<char> idata ((module_count + 1) * sizeof(ImportDescriptor));
+	const auto append = [&idata] (std::size_t size) {
+		const std::size_t offset = idata.size();
+		idata.resize(offset + size);
+		return offset;
+	};
+
+	for (std::size_t module = 0; module < module_count; ++module) {
+		const std::size_t first_import = module * IMPORTS_PER_MODULE;
+		const std::size_t module_imports = std::min(IMPORTS_PER_MODULE, import_count - first_import);
+		const std::string module_name = module % 8 == 0 ? "WS2_32.dll" : "Module" + std::to_string(module) + ".DLL";
+
+		const std::size_t name_offset = append(module_name.size() + 1);
+		std::copy(module_name.begin(), module_name.end(), idata.begin() + name_offset);
+
+		const std::size_t thunks_offset = append((module_imports + 1) * sizeof(ThunkData<64>));
+		for (std::size_t i = 0; i < module_imports; ++i) {
+			ULONGLONG thunk;
+			if (i % 16 == 0) {
+				thunk = ORDINAL_FLAG<64> | (1 + i % 32);
+			} else {
+				const std::string symbol_name = "ImportedFunction" + std::to_string(first_import + i);
+				if (idata.size() % 2 != 0) append(1);
+				const std::size_t hint_name_offset = append(sizeof(WORD) + symbol_name.size() + 1);
+				std::copy(symbol_name.begin(), symbol_name.end(), idata.begin() + hint_name_offset + sizeof(WORD));
+				thunk = idata_rva + hint_name_offset;
+			}
+			detail::store_le_value<ULONGLONG>(idata.data() + thunks_offset + i * sizeof(ThunkData<64>), thunk);
+		}
+
+		char * const descriptor = idata.data() + module * sizeof(ImportDescriptor);
+		detail::store_le_value<DWORD>(descriptor + offsetof(ImportDescriptor, original_first_thunk), static_cast<DWORD>(idata_rva + thunks_offset));
+		detail::store_le_value<DWORD>(descriptor + offsetof(ImportDescriptor, name), static_cast<DWORD>(idata_rva + name_offset));
+		detail::store_le_value<DWORD>(descriptor + offsetof(ImportDescriptor, first_thunk), static_cast<DWORD>(idata_rva + thunks_offset));
+	}
+
+	builder.add_section(".idata", idata, 0x40000040);
+	builder.set_data_directory(DIRECTORY_ENTRY_IMPORT, idata_rva, static_cast<DWORD>((module_count + 1) * sizeof(ImportDescriptor)));
+	return builder.build_file();
+}
+
+template <class Image>
+std::uint64_t concatenated_import_hash(const Image & image)
+{
+	std::string import_names;
+	for (const auto import_dtor : image.import_descriptors()) {
+		const std::string module_name = import_dtor.name_str();
+		std::string stripped_name { detail::strip_module_extension(module_name) };
+		std::transform(stripped_name.begin(), stripped_name.end(), stripped_name.begin(), detail::to_lower_ascii);
+
+		for (const auto & import_entry : import_dtor.entries()) {
+			std::string symbol_name;
+			if (const auto named_import = std::get_if<typename decltype(import_dtor)::NamedImport>(&import_entry)) {
+				symbol_name = named_import->name;
+			} else {
+				const unsigned int ordinal = std::get<typename decltype(import_dtor)::UnnamedImport>(import_entry).ordinal;
+				const auto known_name = detail::find_ordinal_name(module_name, ordinal);
+				symbol_name = known_name ? std::string(*known_name) : "ord" + std::to_string(ordinal);
+			}
+			std::transform(symbol_name.begin(), symbol_name.end(), symbol_name.begin(), detail::to_lower_ascii);
+
+			if (!import_names.empty()) import_names += ',';
+			import_names += stripped_name + '.' + symbol_name;
+		}
+	}
+
+	Fnv1aHash hash;
+	hash.update(import_names.data(), import_names.size());
+	return hash.digest();
+}
+
+template <class Image>
+std::uint64_t streamed_import_hash(const Image & image)
+{
+	Fnv1aHash hash;
+	return import_hash(image, hash).digest();
+}
+
+template <class Fn>
+double median_milliseconds(unsigned int iterations, std::uint64_t & digest, Fn && fn)
+{
+	std::vector<double> timings;
+	for (unsigned int i = 0; i < iterations; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		digest = fn();
+		const auto stop = std::chrono::steady_clock::now();
+		timings.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+	}
+
+	std::sort(timings.begin(), timings.end());
+	return timings[timings.size() / 2];
+}
+
+}
+
+int main(int argc, char * argv[])
+{
+	const std::size_t import_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 18000;
+	const unsigned int iterations = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 21;
+	if (import_count == 0 || iterations == 0) {
+		std::fprintf(stderr, "usage: %s [import_count] [iterations]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::vector<char> file = build_import_image(import_count);
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+
+	std::uint64_t concatenated_digest = 0, streamed_digest = 0;
+	const double concatenated_ms = median_milliseconds(iterations, concatenated_digest, [&] { return concatenated_import_hash(image); });
+	const double streamed_ms = median_milliseconds(iterations, streamed_digest, [&] { return streamed_import_hash(image); });
+
+	std::printf("imports:      %zu (%zu bytes image, %u iterations, median)\n", import_count, file.size(), iterations);
+	std::printf("concatenated: %8.3f ms  digest %016llx\n", concatenated_ms, static_cast<unsigned long long>(concatenated_digest));
+	std::printf("import_hash:  %8.3f ms  digest %016llx\n", streamed_ms, static_cast<unsigned long long>(streamed_digest));
+
+	if (concatenated_digest != streamed_digest) {
+		std::fprintf(stderr, "digest mismatch\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+#ifndef PEPLUS_AUTHENTICODEDIGEST_HPP_
+#define PEPLUS_AUTHENTICODEDIGEST_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace peplus {
+
+namespace detail {
+
+const std::size_t DIGEST_CHUNK_SIZE = 0x10000;
+
+template <class Hash, unsigned int XX, class MemoryBuffer>
+void hash_digest_range(const FileImage<XX, MemoryBuffer> & image, const DigestRange & digest_range,
+                       std::vector<char> & chunk, Hash & hash)
+{
+	std::size_t remaining_size = digest_range.size;
+	for (std::size_t offset = digest_range.offset; remaining_size != 0; ) {
+		const std::size_t chunk_size = std::min(remaining_size, chunk.size());
+		const std::size_t bytes_read = image.read(FileOffset(offset), chunk_size, chunk.data()).first;
+		if (bytes_read != 0) hash.update(chunk.data(), bytes_read);
+		if (bytes_read < chunk_size) break;
+
+		offset += bytes_read;
+		if (remaining_size != DigestRange::TO_END) remaining_size -= bytes_read;
+	}
+}
+
+}
+
+template <unsigned int XX, class MemoryBuffer>
+std::vector<DigestRange> authenticode_ranges(const FileImage<XX, MemoryBuffer> & image)
+{
+	const auto opt_header = image.optional_header();
+	const std::size_t checksum_offset = static_cast<std::size_t>(opt_header.offset().value())
+	                                  + offsetof(OptionalHeader<XX>, check_sum);
+	const std::size_t headers_end = std::max<std::size_t>(opt_header.size_of_headers, checksum_offset + sizeof(DWORD));
+
+	std::vector<DigestRange> digest_ranges;
+	detail::append_digest_range(digest_ranges, 0, checksum_offset);
+
+	std::size_t certificate_offset = DigestRange::TO_END;
+	std::size_t certificate_end = DigestRange::TO_END;
+	if (opt_header.number_of_rvas_and_sizes > DIRECTORY_ENTRY_SECURITY) {
+		const DataDirectory & security_dir = opt_header.data_directory[DIRECTORY_ENTRY_SECURITY];
+		const std::size_t security_dir_offset = static_cast<std::size_t>(opt_header.offset().value())
+		                                      + offsetof(OptionalHeader<XX>, data_directory)
+		                                      + DIRECTORY_ENTRY_SECURITY * sizeof(DataDirectory);
+		detail::append_digest_range(digest_ranges, checksum_offset + sizeof(DWORD), security_dir_offset);
+		detail::append_digest_range(digest_ranges, security_dir_offset + sizeof(DataDirectory), headers_end);
+		if (security_dir.size != 0) {
+			certificate_offset = security_dir.virtual_address;
+			certificate_end = certificate_offset + security_dir.size;
+		}
+	} else {
+		detail::append_digest_range(digest_ranges, checksum_offset + sizeof(DWORD), headers_end);
+	}
+
+	std::vector<std::pair<std::size_t, std::size_t>> section_extents;
+	for (const auto & section_header : image.section_headers()) {
+		if (section_header.size_of_raw_data != 0)
+			section_extents.emplace_back(section_header.pointer_to_raw_data, section_header.size_of_raw_data);
+	}
+	std::sort(section_extents.begin(), section_extents.end());
+
+	std::size_t hashed_end = headers_end;
+	for (const auto & [section_offset, section_size] : section_extents) {
+		detail::append_digest_range(digest_ranges, section_offset, section_offset + section_size);
+		hashed_end = std::max(hashed_end, section_offset + section_size);
+	}
+
+	detail::append_digest_range(digest_ranges, hashed_end, certificate_offset);
+	if (certificate_end != DigestRange::TO_END)
+		detail::append_digest_range(digest_ranges, std::max(hashed_end, certificate_end), DigestRange::TO_END);
+	return digest_ranges;
+}
+
+template <class Hash, unsigned int XX, class MemoryBuffer>
+Hash & authenticode_digest(const FileImage<XX, MemoryBuffer> & image, Hash & hash)
+{
+	const std::vector<DigestRange> digest_ranges = authenticode_ranges(image);
+
+	if (const std::optional<std::string_view> image_view = image.view()) {
+		for (const DigestRange & digest_range : digest_ranges) {
+			if (digest_range.offset >= image_view->size()) continue;
+			const std::string_view range_data = image_view->substr(digest_range.offset, digest_range.size);
+			hash.update(range_data.data(), range_data.size());
+		}
+		return hash;
+	}
+
+	std::vector<char> chunk (detail::DIGEST_CHUNK_SIZE);
+	for (const DigestRange & digest_range : digest_ranges)
+		detail::hash_digest_range(image, digest_range, chunk, hash);
+	return hash;
+}
+
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef PEPLUS_COFFSYMBOLINDEX_HPP_
+#define PEPLUS_COFFSYMBOLINDEX_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+#include <peplus/detail/image_base.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace peplus {
+
+class CoffSymbolIndex
+{
+public:
+	struct Symbol
+	{
+		DWORD rva;
+		DWORD symbol_index;
+		DWORD name_offset;
+		DWORD name_size;
+		BYTE  storage_class;
+		bool  is_function;
+	};
+
+	CoffSymbolIndex() = default;
+
+	template <unsigned int XX, class Offset, class MemoryBuffer>
+	explicit CoffSymbolIndex(const detail::ImageBase<XX, Offset, MemoryBuffer> & image);
+
+	bool empty() const;
+	std::size_t size() const;
+	const std::vector<Symbol> & symbols() const;
+
+	std::string_view name(const Symbol & symbol) const;
+
+	const Symbol * find(VirtualOffset rva) const;
+
+	template <class InputIt, class OutputIt>
+	OutputIt find(InputIt first, InputIt last, OutputIt result) const;
+
+private:
+	static bool is_indexed_symbol(const CoffSymbol & coff_symbol);
+
+	std::string         _names;
+	std::vector<Symbol> _symbols;
+};
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+CoffSymbolIndex::CoffSymbolIndex(const detail::ImageBase<XX, Offset, MemoryBuffer> & image)
+{
+	std::vector<DWORD> section_rvas;
+	for (const auto & section_header : image.section_headers())
+		section_rvas.push_back(section_header.virtual_address);
+
+	DWORD symbol_index = 0;
+	for (const auto & coff_symbol : image.coff_symbols()) {
+		const DWORD current_index = symbol_index;
+		symbol_index += 1 + coff_symbol.number_of_aux_symbols;
+
+		if (!is_indexed_symbol(coff_symbol)) continue;
+		if (static_cast<std::size_t>(coff_symbol.section_number) > section_rvas.size()) continue;
+
+		const DWORD name_offset = static_cast<DWORD>(_names.size());
+		if (const std::optional<std::string_view> name = coff_symbol.name())
+			_names.append(*name);
+		else
+			_names.append(coff_symbol.name_str());
+
+		_symbols.push_back(Symbol {
+			section_rvas[coff_symbol.section_number - 1] + coff_symbol.value, current_index,
+			name_offset, static_cast<DWORD>(_names.size() - name_offset),
+			coff_symbol.storage_class, coff_symbol.is_function()
+		});
+	}
+
+	std::stable_sort(_symbols.begin(), _symbols.end(), [] (const Symbol & lhs, const Symbol & rhs) {
+		return lhs.rva < rhs.rva;
+	});
+}
+
+inline bool CoffSymbolIndex::empty() const
+{
+	return _symbols.empty();
+}
+
+inline std::size_t CoffSymbolIndex::size() const
+{
+	return _symbols.size();
+}
+
+inline auto CoffSymbolIndex::symbols() const -> const std::vector<Symbol> &
+{
+	return _symbols;
+}
+
+inline std::string_view CoffSymbolIndex::name(const Symbol & symbol) const
+{
+	return std::string_view(_names).substr(symbol.name_offset, symbol.name_size);
+}
+
+inline auto CoffSymbolIndex::find(VirtualOffset rva) const -> const Symbol *
+{
+	if (rva.value() < 0) return nullptr;
+
+	const auto symbol = std::upper_bound(_symbols.begin(), _symbols.end(), static_cast<DWORD>(rva.value()),
+	                                     [] (DWORD rva, const Symbol & symbol) { return rva < symbol.rva; });
+	if (symbol == _symbols.begin()) return nullptr;
+	return &*std::prev(symbol);
+}
+
+template <class InputIt, class OutputIt>
+OutputIt CoffSymbolIndex::find(InputIt first, InputIt last, OutputIt result) const
+{
+	for (; first != last; ++first, ++result)
+		*result = find(*first);
+	return result;
+}
+
+inline bool CoffSymbolIndex::is_indexed_symbol(const CoffSymbol & coff_symbol)
+{
+	if (coff_symbol.section_number <= SYM_UNDEFINED) return false;
+
+	switch (coff_symbol.storage_class) {
+		case SYM_CLASS_EXTERNAL:
+		case SYM_CLASS_LABEL:
+			return true;
+		case SYM_CLASS_STATIC:
+			return coff_symbol.number_of_aux_symbols == 0 || (coff_symbol.type >> SYM_DTYPE_SHIFT) == SYM_DTYPE_FUNCTION;
+		default:
+			return false;
+	}
+}
+
+}
+
+#endif
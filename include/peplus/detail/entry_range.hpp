@@ -25,6 +25,8 @@ public:
 		std::declval<const std::tuple<RuntimeParams...> &>()
 	));
 
+	class end_iterator;
+
 	class iterator : public boost::iterator_facade < iterator, value_type,
 	                                                 boost::single_pass_traversal_tag >
 	{
@@ -9,6 +9,7 @@
 
 #include <boost/endian/conversion.hpp>
 
+#include <cstddef>
 #include <tuple>
 
 namespace peplus::detail {
@@ -28,9 +29,9 @@ public:
 	RelocationEntry operator()(WORD type_offset) const
 	{
 		RelocationEntry relocation_entry;
-		const auto reloc_offset = type_offset & ((2 << 12) - 1);
+		const auto reloc_offset = type_offset & ((1 << 12) - 1);
 		relocation_entry.address = _base_rva + reloc_offset;
-		relocation_entry.type = (type_offset & ((2 << 4) - 1)) >> 12;
+		relocation_entry.type = type_offset >> 12;
 		return relocation_entry;
 	}
 
@@ -58,6 +59,10 @@ public:
 
 	BaseRelocationFacade(const Image & image, offset_type offset);
 
+	std::size_t number_of_entries() const;
+	offset_type type_offsets_offset() const;
+	void read_type_offsets(WORD * into_buffer) const;
+
 	RelocationEntryRange entries() const;
 
 private:
@@ -81,6 +86,28 @@ BaseRelocationFacade<Image, Offset>::BaseRelocationFacade(const Image & image, o
 	: PointedValue<Offset, BaseRelocation> { offset, read_base_relocation_from_image(image, offset) }
 	, _image { &image } {}
 
+template <class Image, class Offset>
+std::size_t BaseRelocationFacade<Image, Offset>::number_of_entries() const
+{
+	if (this->size_of_block < offsetof(BaseRelocation, type_offset)) return 0;
+	return (this->size_of_block - offsetof(BaseRelocation, type_offset)) / sizeof(WORD);
+}
+
+template <class Image, class Offset>
+auto BaseRelocationFacade<Image, Offset>::type_offsets_offset() const -> offset_type
+{
+	return this->offset() + offsetof(BaseRelocation, type_offset);
+}
+
+template <class Image, class Offset>
+void BaseRelocationFacade<Image, Offset>::read_type_offsets(WORD * into_buffer) const
+{
+	const std::size_t number_of_entries = this->number_of_entries();
+	image_do_read(*_image, type_offsets_offset(), number_of_entries * sizeof(WORD), into_buffer);
+	for (std::size_t i = 0; i < number_of_entries; ++i)
+		boost::endian::little_to_native_inplace(into_buffer[i]);
+}
+
 template <class Image, class Offset>
 auto BaseRelocationFacade<Image, Offset>::entries() const -> RelocationEntryRange
 {
@@ -92,9 +119,8 @@ auto BaseRelocationFacade<Image, Offset>::entries() const -> RelocationEntryRang
 template <class Image, class Offset>
 auto BaseRelocationFacade<Image, Offset>::type_offsets() const -> RelTypeOffsetRange
 {
-	const offset_type reltypes_offset = this->offset() + offsetof(BaseRelocation, type_offset);
-	const std::size_t reltypes_size = this->size_of_block - offsetof(BaseRelocation, type_offset);
-	return RelTypeOffsetRange(*_image, reltypes_offset, reltypes_size);
+	const std::size_t reltypes_size = number_of_entries() * sizeof(WORD);
+	return RelTypeOffsetRange(*_image, type_offsets_offset(), reltypes_size);
 }
 
 }
@@ -0,0 +1,112 @@
+#ifndef PEPLUS_DETAIL_FACADES_BOUNDIMPORTFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_BOUNDIMPORTFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/pointed_value.hpp>
+#include <peplus/detail/entry_range.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace peplus::detail {
+
+struct read_bound_forwarder_ref
+{
+	template <class Image, class Offset, class RtParams>
+	static BoundForwarderRef read_value(const Image & image, Offset offset, const RtParams &)
+	{
+		BoundForwarderRef forwarder_ref;
+		image_do_read(image, offset, sizeof(BoundForwarderRef), &forwarder_ref);
+		boost::endian::little_to_native_inplace(forwarder_ref.time_date_stamp   );
+		boost::endian::little_to_native_inplace(forwarder_ref.offset_module_name);
+		boost::endian::little_to_native_inplace(forwarder_ref.reserved          );
+		return forwarder_ref;
+	}
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+class BoundImportDescriptorFacade : public PointedValue<Offset, BoundImportDescriptor>
+{
+public:
+	using offset_type = Offset;
+
+	template <typename T>
+	using Pointed = PointedValue<offset_type, T>;
+
+	using ForwarderRefRange = EntryRange <
+		Image, read_pointed_value<read_bound_forwarder_ref>,
+		fixed_distance_advance_pointer_policy<constexpr_<sizeof(BoundForwarderRef)>>,
+		fixed_distance_stop_iteration_policy<runtime_param<0>>,
+		std::size_t
+	>;
+
+	BoundImportDescriptorFacade(const Image & image, offset_type offset, offset_type directory_offset);
+
+	Pointed<std::string> module_name_str() const;
+
+	ForwarderRefRange forwarder_refs() const;
+	Pointed<std::string> module_name_str(const BoundForwarderRef & forwarder_ref) const;
+
+private:
+	const Image * _image;
+	offset_type   _directory_offset;
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+BoundImportDescriptor read_bound_import_descriptor_from_image(const Image & image, Offset offset)
+{
+	BoundImportDescriptor bound_descriptor;
+	image_do_read(image, offset, sizeof(BoundImportDescriptor), &bound_descriptor);
+	boost::endian::little_to_native_inplace(bound_descriptor.time_date_stamp                );
+	boost::endian::little_to_native_inplace(bound_descriptor.offset_module_name             );
+	boost::endian::little_to_native_inplace(bound_descriptor.number_of_module_forwarder_refs);
+	return bound_descriptor;
+}
+
+template <class Image, class Offset>
+BoundImportDescriptorFacade<Image, Offset>::BoundImportDescriptorFacade(const Image & image, offset_type offset,
+                                                                        offset_type directory_offset)
+	: PointedValue<Offset, BoundImportDescriptor> { offset, read_bound_import_descriptor_from_image(image, offset) }
+	, _image { &image }, _directory_offset { directory_offset } {}
+
+template <class Image, class Offset>
+auto BoundImportDescriptorFacade<Image, Offset>::module_name_str() const -> Pointed<std::string>
+{
+	return _image->read_string(_directory_offset + this->offset_module_name);
+}
+
+template <class Image, class Offset>
+auto BoundImportDescriptorFacade<Image, Offset>::forwarder_refs() const -> ForwarderRefRange
+{
+	const offset_type forwarder_refs_offset = this->offset() + sizeof(BoundImportDescriptor);
+	return ForwarderRefRange(*_image, forwarder_refs_offset, this->number_of_module_forwarder_refs * sizeof(BoundForwarderRef));
+}
+
+template <class Image, class Offset>
+auto BoundImportDescriptorFacade<Image, Offset>::module_name_str(const BoundForwarderRef & forwarder_ref) const -> Pointed<std::string>
+{
+	return _image->read_string(_directory_offset + forwarder_ref.offset_module_name);
+}
+
+struct bound_import_advance_pointer_policy
+{
+	template <class Iterator, class Pointer, class RtParams>
+	static void advance_pointer(Iterator iter, Pointer & p, RtParams)
+	{
+		p += (1 + static_cast<std::size_t>(iter->number_of_module_forwarder_refs)) * sizeof(BoundImportDescriptor);
+	}
+};
+
+constexpr bool operator ==(const BoundImportDescriptor & lhs, const BoundImportDescriptor & rhs)
+{
+	return lhs.time_date_stamp                 == rhs.time_date_stamp
+	    && lhs.offset_module_name              == rhs.offset_module_name
+	    && lhs.number_of_module_forwarder_refs == rhs.number_of_module_forwarder_refs;
+}
+
+}
+
+#endif
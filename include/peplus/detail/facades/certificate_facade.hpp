@@ -0,0 +1,80 @@
+#ifndef PEPLUS_DETAIL_FACADES_CERTIFICATEFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_CERTIFICATEFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/pointed_value.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/image_offset.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace peplus::detail {
+
+template <class Image, class Offset = typename Image::offset_type>
+class CertificateFacade : public PointedValue<Offset, WinCertificate>
+{
+public:
+	using offset_type = Offset;
+
+	CertificateFacade(const Image & image, offset_type offset);
+
+	std::size_t certificate_size() const;
+	offset_type certificate_offset() const;
+
+	std::optional<std::string_view> certificate() const;
+	void read_certificate(void * into_buffer) const;
+
+private:
+	const Image * _image;
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+WinCertificate read_win_certificate_from_image(const Image & image, Offset offset)
+{
+	WinCertificate win_certificate;
+	image_do_read(image, offset, offsetof(WinCertificate, certificate), &win_certificate);
+	boost::endian::little_to_native_inplace(win_certificate.length          );
+	boost::endian::little_to_native_inplace(win_certificate.revision        );
+	boost::endian::little_to_native_inplace(win_certificate.certificate_type);
+	return win_certificate;
+}
+
+template <class Image, class Offset>
+CertificateFacade<Image, Offset>::CertificateFacade(const Image & image, offset_type offset)
+	: PointedValue<Offset, WinCertificate> { offset, read_win_certificate_from_image(image, offset) }
+	, _image { &image } {}
+
+template <class Image, class Offset>
+std::size_t CertificateFacade<Image, Offset>::certificate_size() const
+{
+	if (this->length < offsetof(WinCertificate, certificate)) return 0;
+	return this->length - offsetof(WinCertificate, certificate);
+}
+
+template <class Image, class Offset>
+auto CertificateFacade<Image, Offset>::certificate_offset() const -> offset_type
+{
+	return this->offset() + offsetof(WinCertificate, certificate);
+}
+
+template <class Image, class Offset>
+std::optional<std::string_view> CertificateFacade<Image, Offset>::certificate() const
+{
+	const std::optional<std::string_view> certificate = _image->view(certificate_offset(), certificate_size());
+	if (!certificate || certificate->size() < certificate_size()) return std::nullopt;
+	return certificate;
+}
+
+template <class Image, class Offset>
+void CertificateFacade<Image, Offset>::read_certificate(void * into_buffer) const
+{
+	image_do_read(*_image, certificate_offset(), certificate_size(), into_buffer);
+}
+
+}
+
+#endif
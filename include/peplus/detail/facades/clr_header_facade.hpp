@@ -0,0 +1,739 @@
+#ifndef PEPLUS_DETAIL_FACADES_CLRHEADERFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_CLRHEADERFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/pointed_value.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/image_offset.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace peplus::detail {
+
+const std::size_t MAX_METADATA_COLUMNS = 9;
+const std::size_t MAX_CODED_INDEX_TABLES = 22;
+const BYTE NO_METADATA_TABLE = 0xff;
+
+enum class MetadataColumnType : BYTE
+{
+	Word, Dword, String, Guid, Blob, Table, CodedIndex,
+};
+
+struct MetadataColumnSchema
+{
+	MetadataColumnType type;
+	BYTE               reference;
+};
+
+struct MetadataTableSchema
+{
+	BYTE                 column_count;
+	MetadataColumnSchema columns[MAX_METADATA_COLUMNS];
+};
+
+struct MetadataCodedIndexSchema
+{
+	BYTE tag_bits;
+	BYTE table_count;
+	BYTE tables[MAX_CODED_INDEX_TABLES];
+};
+
+namespace metadata_schema {
+
+constexpr MetadataColumnSchema col_word   { MetadataColumnType::Word,   0 };
+constexpr MetadataColumnSchema col_dword  { MetadataColumnType::Dword,  0 };
+constexpr MetadataColumnSchema col_string { MetadataColumnType::String, 0 };
+constexpr MetadataColumnSchema col_guid   { MetadataColumnType::Guid,   0 };
+constexpr MetadataColumnSchema col_blob   { MetadataColumnType::Blob,   0 };
+
+constexpr MetadataColumnSchema col_table(MetadataTable table)
+{
+	return { MetadataColumnType::Table, static_cast<BYTE>(table) };
+}
+
+constexpr MetadataColumnSchema col_coded(MetadataCodedIndex coded_index)
+{
+	return { MetadataColumnType::CodedIndex, static_cast<BYTE>(coded_index) };
+}
+
+inline constexpr MetadataTableSchema TABLES[NUMBEROF_METADATA_TABLES] = {
+	{ 5, { col_word, col_string, col_guid, col_guid, col_guid } },
+	{ 3, { col_coded(CODED_INDEX_RESOLUTION_SCOPE), col_string, col_string } },
+	{ 6, { col_dword, col_string, col_string, col_coded(CODED_INDEX_TYPE_DEF_OR_REF), col_table(METADATA_TABLE_FIELD), col_table(METADATA_TABLE_METHOD_DEF) } },
+	{ 1, { col_table(METADATA_TABLE_FIELD) } },
+	{ 3, { col_word, col_string, col_blob } },
+	{ 1, { col_table(METADATA_TABLE_METHOD_DEF) } },
+	{ 6, { col_dword, col_word, col_word, col_string, col_blob, col_table(METADATA_TABLE_PARAM) } },
+	{ 1, { col_table(METADATA_TABLE_PARAM) } },
+	{ 3, { col_word, col_word, col_string } },
+	{ 2, { col_table(METADATA_TABLE_TYPE_DEF), col_coded(CODED_INDEX_TYPE_DEF_OR_REF) } },
+	{ 3, { col_coded(CODED_INDEX_MEMBER_REF_PARENT), col_string, col_blob } },
+	{ 3, { col_word, col_coded(CODED_INDEX_HAS_CONSTANT), col_blob } },
+	{ 3, { col_coded(CODED_INDEX_HAS_CUSTOM_ATTRIBUTE), col_coded(CODED_INDEX_CUSTOM_ATTRIBUTE_TYPE), col_blob } },
+	{ 2, { col_coded(CODED_INDEX_HAS_FIELD_MARSHAL), col_blob } },
+	{ 3, { col_word, col_coded(CODED_INDEX_HAS_DECL_SECURITY), col_blob } },
+	{ 3, { col_word, col_dword, col_table(METADATA_TABLE_TYPE_DEF) } },
+	{ 2, { col_dword, col_table(METADATA_TABLE_FIELD) } },
+	{ 1, { col_blob } },
+	{ 2, { col_table(METADATA_TABLE_TYPE_DEF), col_table(METADATA_TABLE_EVENT) } },
+	{ 1, { col_table(METADATA_TABLE_EVENT) } },
+	{ 3, { col_word, col_string, col_coded(CODED_INDEX_TYPE_DEF_OR_REF) } },
+	{ 2, { col_table(METADATA_TABLE_TYPE_DEF), col_table(METADATA_TABLE_PROPERTY) } },
+	{ 1, { col_table(METADATA_TABLE_PROPERTY) } },
+	{ 3, { col_word, col_string, col_blob } },
+	{ 3, { col_word, col_table(METADATA_TABLE_METHOD_DEF), col_coded(CODED_INDEX_HAS_SEMANTICS) } },
+	{ 3, { col_table(METADATA_TABLE_TYPE_DEF), col_coded(CODED_INDEX_METHOD_DEF_OR_REF), col_coded(CODED_INDEX_METHOD_DEF_OR_REF) } },
+	{ 1, { col_string } },
+	{ 1, { col_blob } },
+	{ 4, { col_word, col_coded(CODED_INDEX_MEMBER_FORWARDED), col_string, col_table(METADATA_TABLE_MODULE_REF) } },
+	{ 2, { col_dword, col_table(METADATA_TABLE_FIELD) } },
+	{ 2, { col_dword, col_dword } },
+	{ 1, { col_dword } },
+	{ 9, { col_dword, col_word, col_word, col_word, col_word, col_dword, col_blob, col_string, col_string } },
+	{ 1, { col_dword } },
+	{ 3, { col_dword, col_dword, col_dword } },
+	{ 9, { col_word, col_word, col_word, col_word, col_dword, col_blob, col_string, col_string, col_blob } },
+	{ 2, { col_dword, col_table(METADATA_TABLE_ASSEMBLY_REF) } },
+	{ 4, { col_dword, col_dword, col_dword, col_table(METADATA_TABLE_ASSEMBLY_REF) } },
+	{ 3, { col_dword, col_string, col_blob } },
+	{ 5, { col_dword, col_dword, col_string, col_string, col_coded(CODED_INDEX_IMPLEMENTATION) } },
+	{ 4, { col_dword, col_dword, col_string, col_coded(CODED_INDEX_IMPLEMENTATION) } },
+	{ 2, { col_table(METADATA_TABLE_TYPE_DEF), col_table(METADATA_TABLE_TYPE_DEF) } },
+	{ 4, { col_word, col_word, col_coded(CODED_INDEX_TYPE_OR_METHOD_DEF), col_string } },
+	{ 2, { col_coded(CODED_INDEX_METHOD_DEF_OR_REF), col_blob } },
+	{ 2, { col_table(METADATA_TABLE_GENERIC_PARAM), col_coded(CODED_INDEX_TYPE_DEF_OR_REF) } },
+};
+
+inline constexpr MetadataCodedIndexSchema CODED_INDEXES[NUMBEROF_CODED_INDEXES] = {
+	{ 2, 3, { METADATA_TABLE_TYPE_DEF, METADATA_TABLE_TYPE_REF, METADATA_TABLE_TYPE_SPEC } },
+	{ 2, 3, { METADATA_TABLE_FIELD, METADATA_TABLE_PARAM, METADATA_TABLE_PROPERTY } },
+	{ 5, 22, { METADATA_TABLE_METHOD_DEF, METADATA_TABLE_FIELD, METADATA_TABLE_TYPE_REF, METADATA_TABLE_TYPE_DEF,
+	           METADATA_TABLE_PARAM, METADATA_TABLE_INTERFACE_IMPL, METADATA_TABLE_MEMBER_REF, METADATA_TABLE_MODULE,
+	           METADATA_TABLE_DECL_SECURITY, METADATA_TABLE_PROPERTY, METADATA_TABLE_EVENT, METADATA_TABLE_STAND_ALONE_SIG,
+	           METADATA_TABLE_MODULE_REF, METADATA_TABLE_TYPE_SPEC, METADATA_TABLE_ASSEMBLY, METADATA_TABLE_ASSEMBLY_REF,
+	           METADATA_TABLE_FILE, METADATA_TABLE_EXPORTED_TYPE, METADATA_TABLE_MANIFEST_RESOURCE, METADATA_TABLE_GENERIC_PARAM,
+	           METADATA_TABLE_GENERIC_PARAM_CONSTRAINT, METADATA_TABLE_METHOD_SPEC } },
+	{ 1, 2, { METADATA_TABLE_FIELD, METADATA_TABLE_PARAM } },
+	{ 2, 3, { METADATA_TABLE_TYPE_DEF, METADATA_TABLE_METHOD_DEF, METADATA_TABLE_ASSEMBLY } },
+	{ 3, 5, { METADATA_TABLE_TYPE_DEF, METADATA_TABLE_TYPE_REF, METADATA_TABLE_MODULE_REF, METADATA_TABLE_METHOD_DEF, METADATA_TABLE_TYPE_SPEC } },
+	{ 1, 2, { METADATA_TABLE_EVENT, METADATA_TABLE_PROPERTY } },
+	{ 1, 2, { METADATA_TABLE_METHOD_DEF, METADATA_TABLE_MEMBER_REF } },
+	{ 1, 2, { METADATA_TABLE_FIELD, METADATA_TABLE_METHOD_DEF } },
+	{ 2, 3, { METADATA_TABLE_FILE, METADATA_TABLE_ASSEMBLY_REF, METADATA_TABLE_EXPORTED_TYPE } },
+	{ 3, 5, { NO_METADATA_TABLE, NO_METADATA_TABLE, METADATA_TABLE_METHOD_DEF, METADATA_TABLE_MEMBER_REF, NO_METADATA_TABLE } },
+	{ 2, 4, { METADATA_TABLE_MODULE, METADATA_TABLE_MODULE_REF, METADATA_TABLE_ASSEMBLY_REF, METADATA_TABLE_TYPE_REF } },
+	{ 1, 2, { METADATA_TABLE_TYPE_DEF, METADATA_TABLE_METHOD_DEF } },
+};
+
+}
+
+struct MetadataToken
+{
+	MetadataTable table;
+	DWORD         row;
+};
+
+inline std::optional<MetadataToken> decode_coded_index(MetadataCodedIndex coded_index, DWORD value)
+{
+	if (coded_index >= NUMBEROF_CODED_INDEXES) return std::nullopt;
+
+	const MetadataCodedIndexSchema & schema = metadata_schema::CODED_INDEXES[coded_index];
+	const DWORD tag = value & ((1u << schema.tag_bits) - 1);
+	if (tag >= schema.table_count || schema.tables[tag] == NO_METADATA_TABLE) return std::nullopt;
+	return MetadataToken { static_cast<MetadataTable>(schema.tables[tag]), value >> schema.tag_bits };
+}
+
+inline DWORD load_metadata_index(const char * from, std::size_t size)
+{
+	return size == sizeof(WORD) ? load_le_value<WORD>(from) : load_le_value<DWORD>(from);
+}
+
+class MetadataColumnView
+{
+public:
+	class const_iterator;
+
+	MetadataColumnView() = default;
+	MetadataColumnView(const char * data, std::size_t row_count, std::size_t row_size, std::size_t column_size);
+
+	bool empty() const;
+	std::size_t size() const;
+	std::size_t column_size() const;
+
+	DWORD operator [](std::size_t row) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	const char  * _data        = nullptr;
+	std::size_t   _row_count   = 0;
+	std::size_t   _row_size    = 0;
+	std::size_t   _column_size = 0;
+};
+
+class MetadataColumnView::const_iterator
+{
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type        = DWORD;
+	using difference_type   = std::ptrdiff_t;
+	using pointer           = void;
+	using reference         = DWORD;
+
+	const_iterator() = default;
+	const_iterator(const MetadataColumnView & column, std::size_t row) : _column { &column }, _row { row } {}
+
+	DWORD operator *() const { return (*_column)[_row]; }
+	DWORD operator [](difference_type n) const { return (*_column)[_row + n]; }
+
+	const_iterator & operator ++() { ++_row; return *this; }
+	const_iterator & operator --() { --_row; return *this; }
+	const_iterator operator ++(int) { const_iterator tmp = *this; ++_row; return tmp; }
+	const_iterator operator --(int) { const_iterator tmp = *this; --_row; return tmp; }
+
+	const_iterator & operator +=(difference_type n) { _row += n; return *this; }
+	const_iterator & operator -=(difference_type n) { _row -= n; return *this; }
+	const_iterator operator +(difference_type n) const { return const_iterator(*_column, _row + n); }
+	const_iterator operator -(difference_type n) const { return const_iterator(*_column, _row - n); }
+	difference_type operator -(const const_iterator & rhs) const { return static_cast<difference_type>(_row - rhs._row); }
+
+	bool operator ==(const const_iterator & rhs) const { return _row == rhs._row; }
+	bool operator !=(const const_iterator & rhs) const { return _row != rhs._row; }
+	bool operator <(const const_iterator & rhs) const { return _row < rhs._row; }
+	bool operator >(const const_iterator & rhs) const { return _row > rhs._row; }
+	bool operator <=(const const_iterator & rhs) const { return _row <= rhs._row; }
+	bool operator >=(const const_iterator & rhs) const { return _row >= rhs._row; }
+
+private:
+	const MetadataColumnView * _column = nullptr;
+	std::size_t                _row    = 0;
+};
+
+class MetadataTableView
+{
+public:
+	MetadataTableView() = default;
+
+	bool empty() const;
+	std::size_t size() const;
+	std::size_t row_size() const;
+	std::size_t column_count() const;
+	std::size_t column_size(std::size_t column) const;
+
+	std::string_view row(std::size_t index) const;
+	DWORD get(std::size_t row, std::size_t column) const;
+
+	MetadataColumnView column(std::size_t column) const;
+
+private:
+	friend class MetadataFacade;
+
+	const char                                   * _data         = nullptr;
+	std::size_t                                    _row_count    = 0;
+	std::size_t                                    _row_size     = 0;
+	std::size_t                                    _column_count = 0;
+	std::array<BYTE, MAX_METADATA_COLUMNS>         _column_offsets {};
+	std::array<BYTE, MAX_METADATA_COLUMNS>         _column_sizes {};
+};
+
+class MetadataFacade
+{
+public:
+	struct Stream
+	{
+		std::string_view name;
+		std::string_view data;
+	};
+
+	explicit MetadataFacade(std::string_view metadata, std::shared_ptr<const std::string> storage = nullptr);
+
+	WORD major_version() const;
+	WORD minor_version() const;
+	std::string_view version() const;
+
+	const std::vector<Stream> & streams() const;
+	std::optional<std::string_view> stream(std::string_view name) const;
+
+	std::string_view strings_heap() const;
+	std::string_view blob_heap() const;
+	std::string_view guid_heap() const;
+	std::string_view user_strings_heap() const;
+
+	std::optional<std::string_view> string(DWORD index) const;
+	std::optional<std::string_view> blob(DWORD index) const;
+	std::optional<std::string_view> user_string(DWORD index) const;
+	std::optional<Guid> guid(DWORD index) const;
+
+	BYTE heap_sizes() const;
+	ULONGLONG valid_tables() const;
+	ULONGLONG sorted_tables() const;
+
+	bool has_table(MetadataTable table) const;
+	std::size_t row_count(MetadataTable table) const;
+	const MetadataTableView & table(MetadataTable table) const;
+
+private:
+	static std::optional<std::string_view> read_blob(std::string_view heap, DWORD index);
+
+	void parse_tables(std::string_view tables);
+	std::size_t column_size(const MetadataColumnSchema & column) const;
+
+	std::shared_ptr<const std::string>                         _storage;
+	std::string_view                                           _metadata;
+	WORD                                                       _major_version;
+	WORD                                                       _minor_version;
+	std::string_view                                           _version;
+	std::vector<Stream>                                        _streams;
+	std::string_view                                           _strings_heap;
+	std::string_view                                           _blob_heap;
+	std::string_view                                           _guid_heap;
+	std::string_view                                           _user_strings_heap;
+	BYTE                                                       _heap_sizes = 0;
+	ULONGLONG                                                  _valid_tables = 0;
+	ULONGLONG                                                  _sorted_tables = 0;
+	std::array<MetadataTableView, NUMBEROF_METADATA_TABLES>    _tables;
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+class ClrHeaderFacade : public PointedValue<Offset, Cor20Header>
+{
+public:
+	using offset_type = Offset;
+
+	ClrHeaderFacade(const Image & image, offset_type offset);
+
+	bool is_il_only() const;
+	bool is_strong_name_signed() const;
+	bool has_native_entry_point() const;
+
+	std::optional<MetadataFacade> metadata_root() const;
+
+private:
+	const Image * _image;
+};
+
+inline MetadataColumnView::MetadataColumnView(const char * data, std::size_t row_count, std::size_t row_size, std::size_t column_size)
+	: _data { data }, _row_count { row_count }, _row_size { row_size }, _column_size { column_size } {}
+
+inline bool MetadataColumnView::empty() const
+{
+	return _row_count == 0;
+}
+
+inline std::size_t MetadataColumnView::size() const
+{
+	return _row_count;
+}
+
+inline std::size_t MetadataColumnView::column_size() const
+{
+	return _column_size;
+}
+
+inline DWORD MetadataColumnView::operator [](std::size_t row) const
+{
+	return load_metadata_index(_data + row * _row_size, _column_size);
+}
+
+inline auto MetadataColumnView::begin() const -> const_iterator
+{
+	return const_iterator(*this, 0);
+}
+
+inline auto MetadataColumnView::end() const -> const_iterator
+{
+	return const_iterator(*this, _row_count);
+}
+
+inline bool MetadataTableView::empty() const
+{
+	return _row_count == 0;
+}
+
+inline std::size_t MetadataTableView::size() const
+{
+	return _row_count;
+}
+
+inline std::size_t MetadataTableView::row_size() const
+{
+	return _row_size;
+}
+
+inline std::size_t MetadataTableView::column_count() const
+{
+	return _column_count;
+}
+
+inline std::size_t MetadataTableView::column_size(std::size_t column) const
+{
+	return _column_sizes[column];
+}
+
+inline std::string_view MetadataTableView::row(std::size_t index) const
+{
+	return std::string_view(_data + index * _row_size, _row_size);
+}
+
+inline DWORD MetadataTableView::get(std::size_t row, std::size_t column) const
+{
+	return load_metadata_index(_data + row * _row_size + _column_offsets[column], _column_sizes[column]);
+}
+
+inline MetadataColumnView MetadataTableView::column(std::size_t column) const
+{
+	return MetadataColumnView(_data + _column_offsets[column], _row_count, _row_size, _column_sizes[column]);
+}
+
+inline MetadataFacade::MetadataFacade(std::string_view metadata, std::shared_ptr<const std::string> storage)
+	: _storage { std::move(storage) }, _metadata { metadata }
+{
+	const std::size_t version_offset = offsetof(MetadataRoot, version);
+	if (_metadata.size() < version_offset || load_le_value<DWORD>(_metadata.data()) != METADATA_SIGNATURE)
+		throw std::runtime_error("Invalid metadata root");
+
+	_major_version = load_le_value<WORD>(_metadata.data() + offsetof(MetadataRoot, major_version));
+	_minor_version = load_le_value<WORD>(_metadata.data() + offsetof(MetadataRoot, minor_version));
+
+	const DWORD version_length = load_le_value<DWORD>(_metadata.data() + offsetof(MetadataRoot, length));
+	const std::size_t flags_offset = version_offset + version_length;
+	if (version_length > _metadata.size() || flags_offset + 2 * sizeof(WORD) > _metadata.size())
+		throw std::runtime_error("Invalid metadata root");
+
+	_version = _metadata.substr(version_offset, version_length);
+	_version = _version.substr(0, _version.find('\0'));
+
+	const WORD number_of_streams = load_le_value<WORD>(_metadata.data() + flags_offset + sizeof(WORD));
+	std::size_t header_offset = flags_offset + 2 * sizeof(WORD);
+	_streams.reserve(number_of_streams);
+
+	std::string_view tables_stream;
+	for (WORD i = 0; i < number_of_streams; ++i) {
+		const std::size_t name_offset = header_offset + offsetof(MetadataStreamHeader, name);
+		if (name_offset > _metadata.size()) throw std::runtime_error("Invalid metadata stream header");
+
+		const std::size_t name_size = _metadata.find('\0', name_offset) - name_offset;
+		if (name_offset + name_size >= _metadata.size()) throw std::runtime_error("Invalid metadata stream header");
+
+		const DWORD stream_offset = load_le_value<DWORD>(_metadata.data() + header_offset);
+		const DWORD stream_size = load_le_value<DWORD>(_metadata.data() + header_offset + sizeof(DWORD));
+		if (stream_offset > _metadata.size() || stream_size > _metadata.size() - stream_offset)
+			throw std::runtime_error("Invalid metadata stream header");
+
+		const Stream stream { _metadata.substr(name_offset, name_size), _metadata.substr(stream_offset, stream_size) };
+		_streams.push_back(stream);
+		header_offset = (name_offset + name_size + 1 + 3) & ~std::size_t(3);
+
+		if (stream.name == "#Strings")
+			_strings_heap = stream.data;
+		else if (stream.name == "#Blob")
+			_blob_heap = stream.data;
+		else if (stream.name == "#GUID")
+			_guid_heap = stream.data;
+		else if (stream.name == "#US")
+			_user_strings_heap = stream.data;
+		else if (stream.name == "#~" || stream.name == "#-")
+			tables_stream = stream.data;
+	}
+
+	parse_tables(tables_stream);
+}
+
+inline WORD MetadataFacade::major_version() const
+{
+	return _major_version;
+}
+
+inline WORD MetadataFacade::minor_version() const
+{
+	return _minor_version;
+}
+
+inline std::string_view MetadataFacade::version() const
+{
+	return _version;
+}
+
+inline auto MetadataFacade::streams() const -> const std::vector<Stream> &
+{
+	return _streams;
+}
+
+inline std::optional<std::string_view> MetadataFacade::stream(std::string_view name) const
+{
+	const auto stream = std::find_if(_streams.begin(), _streams.end(), [name] (const Stream & stream) {
+		return stream.name == name;
+	});
+	if (stream == _streams.end()) return std::nullopt;
+	return stream->data;
+}
+
+inline std::string_view MetadataFacade::strings_heap() const
+{
+	return _strings_heap;
+}
+
+inline std::string_view MetadataFacade::blob_heap() const
+{
+	return _blob_heap;
+}
+
+inline std::string_view MetadataFacade::guid_heap() const
+{
+	return _guid_heap;
+}
+
+inline std::string_view MetadataFacade::user_strings_heap() const
+{
+	return _user_strings_heap;
+}
+
+inline std::optional<std::string_view> MetadataFacade::string(DWORD index) const
+{
+	if (index >= _strings_heap.size()) return std::nullopt;
+
+	const std::size_t string_end = _strings_heap.find('\0', index);
+	if (string_end == std::string_view::npos) return std::nullopt;
+	return _strings_heap.substr(index, string_end - index);
+}
+
+inline std::optional<std::string_view> MetadataFacade::blob(DWORD index) const
+{
+	return read_blob(_blob_heap, index);
+}
+
+inline std::optional<std::string_view> MetadataFacade::user_string(DWORD index) const
+{
+	const std::optional<std::string_view> user_string = read_blob(_user_strings_heap, index);
+	if (!user_string || user_string->empty()) return user_string;
+	return user_string->substr(0, user_string->size() & ~std::size_t(1));
+}
+
+inline std::optional<Guid> MetadataFacade::guid(DWORD index) const
+{
+	if (index == 0 || index > _guid_heap.size() / sizeof(Guid)) return std::nullopt;
+
+	const char * const guid_data = _guid_heap.data() + (index - 1) * sizeof(Guid);
+	Guid guid;
+	guid.data1 = load_le_value<DWORD>(guid_data);
+	guid.data2 = load_le_value<WORD>(guid_data + 4);
+	guid.data3 = load_le_value<WORD>(guid_data + 6);
+	std::memcpy(guid.data4, guid_data + 8, sizeof(guid.data4));
+	return guid;
+}
+
+inline BYTE MetadataFacade::heap_sizes() const
+{
+	return _heap_sizes;
+}
+
+inline ULONGLONG MetadataFacade::valid_tables() const
+{
+	return _valid_tables;
+}
+
+inline ULONGLONG MetadataFacade::sorted_tables() const
+{
+	return _sorted_tables;
+}
+
+inline bool MetadataFacade::has_table(MetadataTable table) const
+{
+	return table < NUMBEROF_METADATA_TABLES && (_valid_tables >> table & 1) != 0;
+}
+
+inline std::size_t MetadataFacade::row_count(MetadataTable table) const
+{
+	return table < NUMBEROF_METADATA_TABLES ? _tables[table].size() : 0;
+}
+
+inline const MetadataTableView & MetadataFacade::table(MetadataTable table) const
+{
+	return _tables.at(table);
+}
+
+inline std::optional<std::string_view> MetadataFacade::read_blob(std::string_view heap, DWORD index)
+{
+	if (index >= heap.size()) return std::nullopt;
+
+	const auto first_byte = static_cast<BYTE>(heap[index]);
+	std::size_t length_size, blob_size;
+	if ((first_byte & 0x80) == 0) {
+		length_size = 1;
+		blob_size = first_byte;
+	} else if ((first_byte & 0xc0) == 0x80) {
+		if (heap.size() - index < 2) return std::nullopt;
+		length_size = 2;
+		blob_size = (first_byte & 0x3fu) << 8 | static_cast<BYTE>(heap[index + 1]);
+	} else if ((first_byte & 0xe0) == 0xc0) {
+		if (heap.size() - index < 4) return std::nullopt;
+		length_size = 4;
+		blob_size = (first_byte & 0x1fu) << 24 | static_cast<BYTE>(heap[index + 1]) << 16
+		          | static_cast<BYTE>(heap[index + 2]) << 8 | static_cast<BYTE>(heap[index + 3]);
+	} else {
+		return std::nullopt;
+	}
+
+	if (blob_size > heap.size() - index - length_size) return std::nullopt;
+	return heap.substr(index + length_size, blob_size);
+}
+
+inline void MetadataFacade::parse_tables(std::string_view tables)
+{
+	if (tables.empty()) return;
+
+	const std::size_t rows_offset = offsetof(MetadataTablesHeader, rows);
+	if (tables.size() < rows_offset) throw std::runtime_error("Invalid metadata tables header");
+
+	_heap_sizes = static_cast<BYTE>(tables[offsetof(MetadataTablesHeader, heap_sizes)]);
+	_valid_tables = load_le_value<ULONGLONG>(tables.data() + offsetof(MetadataTablesHeader, valid));
+	_sorted_tables = load_le_value<ULONGLONG>(tables.data() + offsetof(MetadataTablesHeader, sorted));
+	if ((_valid_tables >> NUMBEROF_METADATA_TABLES) != 0) throw std::runtime_error("Unsupported metadata tables");
+
+	std::size_t data_offset = rows_offset;
+	for (std::size_t table = 0; table < NUMBEROF_METADATA_TABLES; ++table) {
+		if ((_valid_tables >> table & 1) == 0) continue;
+		if (data_offset + sizeof(DWORD) > tables.size()) throw std::runtime_error("Invalid metadata tables header");
+		_tables[table]._row_count = load_le_value<DWORD>(tables.data() + data_offset);
+		data_offset += sizeof(DWORD);
+	}
+	if ((_heap_sizes & METADATA_HEAP_EXTRA_DATA) != 0) data_offset += sizeof(DWORD);
+
+	for (std::size_t table = 0; table < NUMBEROF_METADATA_TABLES; ++table) {
+		MetadataTableView & table_view = _tables[table];
+		const MetadataTableSchema & schema = metadata_schema::TABLES[table];
+
+		table_view._column_count = schema.column_count;
+		for (std::size_t column = 0; column < schema.column_count; ++column) {
+			table_view._column_offsets[column] = static_cast<BYTE>(table_view._row_size);
+			table_view._column_sizes[column] = static_cast<BYTE>(column_size(schema.columns[column]));
+			table_view._row_size += table_view._column_sizes[column];
+		}
+
+		if (data_offset > tables.size() || table_view._row_count > (tables.size() - data_offset) / table_view._row_size)
+			throw std::runtime_error("Invalid metadata tables");
+		table_view._data = tables.data() + data_offset;
+		data_offset += table_view._row_count * table_view._row_size;
+	}
+}
+
+inline std::size_t MetadataFacade::column_size(const MetadataColumnSchema & column) const
+{
+	switch (column.type) {
+		case MetadataColumnType::Word:
+			return sizeof(WORD);
+		case MetadataColumnType::Dword:
+			return sizeof(DWORD);
+		case MetadataColumnType::String:
+			return (_heap_sizes & METADATA_HEAP_STRING_WIDE) != 0 ? sizeof(DWORD) : sizeof(WORD);
+		case MetadataColumnType::Guid:
+			return (_heap_sizes & METADATA_HEAP_GUID_WIDE) != 0 ? sizeof(DWORD) : sizeof(WORD);
+		case MetadataColumnType::Blob:
+			return (_heap_sizes & METADATA_HEAP_BLOB_WIDE) != 0 ? sizeof(DWORD) : sizeof(WORD);
+		case MetadataColumnType::Table:
+			return _tables[column.reference].size() < 0x10000 ? sizeof(WORD) : sizeof(DWORD);
+		case MetadataColumnType::CodedIndex: {
+			const MetadataCodedIndexSchema & schema = metadata_schema::CODED_INDEXES[column.reference];
+			std::size_t max_row_count = 0;
+			for (std::size_t i = 0; i < schema.table_count; ++i) {
+				if (schema.tables[i] != NO_METADATA_TABLE)
+					max_row_count = std::max(max_row_count, _tables[schema.tables[i]].size());
+			}
+			return max_row_count < (std::size_t(1) << (16 - schema.tag_bits)) ? sizeof(WORD) : sizeof(DWORD);
+		}
+	}
+	return sizeof(DWORD);
+}
+
+template <class Image, class Offset = typename Image::offset_type>
+Cor20Header read_cor20_header_from_image(const Image & image, Offset offset)
+{
+	Cor20Header cor20_header;
+	image_do_read(image, offset, sizeof(Cor20Header), &cor20_header);
+	boost::endian::little_to_native_inplace(cor20_header.cb                                        );
+	boost::endian::little_to_native_inplace(cor20_header.major_runtime_version                     );
+	boost::endian::little_to_native_inplace(cor20_header.minor_runtime_version                     );
+	boost::endian::little_to_native_inplace(cor20_header.metadata.virtual_address                  );
+	boost::endian::little_to_native_inplace(cor20_header.metadata.size                             );
+	boost::endian::little_to_native_inplace(cor20_header.flags                                     );
+	boost::endian::little_to_native_inplace(cor20_header.entry_point_token                         );
+	boost::endian::little_to_native_inplace(cor20_header.resources.virtual_address                 );
+	boost::endian::little_to_native_inplace(cor20_header.resources.size                            );
+	boost::endian::little_to_native_inplace(cor20_header.strong_name_signature.virtual_address     );
+	boost::endian::little_to_native_inplace(cor20_header.strong_name_signature.size                );
+	boost::endian::little_to_native_inplace(cor20_header.code_manager_table.virtual_address        );
+	boost::endian::little_to_native_inplace(cor20_header.code_manager_table.size                   );
+	boost::endian::little_to_native_inplace(cor20_header.vtable_fixups.virtual_address             );
+	boost::endian::little_to_native_inplace(cor20_header.vtable_fixups.size                        );
+	boost::endian::little_to_native_inplace(cor20_header.export_address_table_jumps.virtual_address);
+	boost::endian::little_to_native_inplace(cor20_header.export_address_table_jumps.size           );
+	boost::endian::little_to_native_inplace(cor20_header.managed_native_header.virtual_address     );
+	boost::endian::little_to_native_inplace(cor20_header.managed_native_header.size                );
+	return cor20_header;
+}
+
+template <class Image, class Offset>
+ClrHeaderFacade<Image, Offset>::ClrHeaderFacade(const Image & image, offset_type offset)
+	: PointedValue<Offset, Cor20Header> { offset, read_cor20_header_from_image(image, offset) }
+	, _image { &image } {}
+
+template <class Image, class Offset>
+bool ClrHeaderFacade<Image, Offset>::is_il_only() const
+{
+	return (this->flags & COMIMAGE_FLAGS_ILONLY) != 0;
+}
+
+template <class Image, class Offset>
+bool ClrHeaderFacade<Image, Offset>::is_strong_name_signed() const
+{
+	return (this->flags & COMIMAGE_FLAGS_STRONGNAMESIGNED) != 0;
+}
+
+template <class Image, class Offset>
+bool ClrHeaderFacade<Image, Offset>::has_native_entry_point() const
+{
+	return (this->flags & COMIMAGE_FLAGS_NATIVE_ENTRYPOINT) != 0;
+}
+
+template <class Image, class Offset>
+std::optional<MetadataFacade> ClrHeaderFacade<Image, Offset>::metadata_root() const
+{
+	if (this->metadata.virtual_address == 0 || this->metadata.size < offsetof(MetadataRoot, version)) return std::nullopt;
+
+	const std::optional<offset_type> metadata_offset = to_image_offset(*_image, VirtualOffset(this->metadata.virtual_address));
+	if (!metadata_offset) return std::nullopt;
+
+	if (const std::optional<std::string_view> metadata_view = _image->view(*metadata_offset, this->metadata.size))
+		return MetadataFacade(*metadata_view);
+
+	const std::size_t chunk_size = 0x10000;
+	auto storage = std::make_shared<std::string>();
+	while (storage->size() < this->metadata.size) {
+		const std::size_t storage_size = storage->size();
+		const std::size_t bytes_wanted = std::min<std::size_t>(chunk_size, this->metadata.size - storage_size);
+		storage->resize(storage_size + bytes_wanted);
+		const std::size_t bytes_read = _image->read(*metadata_offset + storage_size, bytes_wanted, storage->data() + storage_size).first;
+		storage->resize(storage_size + bytes_read);
+		if (bytes_read < bytes_wanted) break;
+	}
+
+	const std::string_view metadata_view = *storage;
+	return MetadataFacade(metadata_view, std::move(storage));
+}
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef PEPLUS_DETAIL_FACADES_COFFSYMBOLFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_COFFSYMBOLFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/pointed_value.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace peplus::detail {
+
+template <class Image, class Offset = typename Image::offset_type>
+class CoffSymbolFacade : public PointedValue<Offset, CoffSymbol>
+{
+public:
+	using offset_type = Offset;
+
+	template <typename T>
+	using Pointed = PointedValue<offset_type, T>;
+
+	CoffSymbolFacade(const Image & image, offset_type offset, offset_type string_table_offset);
+
+	bool has_long_name() const;
+	bool is_function() const;
+
+	std::optional<std::string_view> name() const;
+	Pointed<std::string> name_str() const;
+
+	offset_type aux_symbol_offset(std::size_t index) const;
+	void read_aux_symbols(void * into_buffer) const;
+
+private:
+	offset_type long_name_offset() const;
+
+	const Image * _image;
+	offset_type   _string_table_offset;
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+CoffSymbol read_coff_symbol_from_image(const Image & image, Offset offset)
+{
+	char symbol_data[SIZEOF_SYMBOL];
+	image_do_read(image, offset, SIZEOF_SYMBOL, symbol_data);
+
+	CoffSymbol coff_symbol;
+	std::memcpy(coff_symbol.short_name, symbol_data, SIZEOF_SHORT_NAME);
+	coff_symbol.value = load_le_value<DWORD>(symbol_data + 8);
+	coff_symbol.section_number = static_cast<std::int16_t>(load_le_value<WORD>(symbol_data + 12));
+	coff_symbol.type = load_le_value<WORD>(symbol_data + 14);
+	coff_symbol.storage_class = static_cast<BYTE>(symbol_data[16]);
+	coff_symbol.number_of_aux_symbols = static_cast<BYTE>(symbol_data[17]);
+	return coff_symbol;
+}
+
+template <class Image, class Offset>
+CoffSymbolFacade<Image, Offset>::CoffSymbolFacade(const Image & image, offset_type offset, offset_type string_table_offset)
+	: PointedValue<Offset, CoffSymbol> { offset, read_coff_symbol_from_image(image, offset) }
+	, _image { &image }, _string_table_offset { string_table_offset } {}
+
+template <class Image, class Offset>
+bool CoffSymbolFacade<Image, Offset>::has_long_name() const
+{
+	return load_le_value<DWORD>(reinterpret_cast<const char *>(this->short_name)) == 0;
+}
+
+template <class Image, class Offset>
+bool CoffSymbolFacade<Image, Offset>::is_function() const
+{
+	return (this->type >> SYM_DTYPE_SHIFT) == SYM_DTYPE_FUNCTION;
+}
+
+template <class Image, class Offset>
+std::optional<std::string_view> CoffSymbolFacade<Image, Offset>::name() const
+{
+	if (!has_long_name()) {
+		const std::optional<std::string_view> short_name = _image->view(this->offset(), SIZEOF_SHORT_NAME);
+		if (!short_name) return std::nullopt;
+		return short_name->substr(0, short_name->find('\0'));
+	}
+
+	const std::optional<std::string_view> long_name = _image->view(long_name_offset(), std::string_view::npos);
+	if (!long_name) return std::nullopt;
+
+	const std::size_t name_size = long_name->find('\0');
+	if (name_size == std::string_view::npos) return std::nullopt;
+	return long_name->substr(0, name_size);
+}
+
+template <class Image, class Offset>
+auto CoffSymbolFacade<Image, Offset>::name_str() const -> Pointed<std::string>
+{
+	if (has_long_name()) return _image->read_string(long_name_offset());
+
+	const char * const short_name = reinterpret_cast<const char *>(this->short_name);
+	const auto name_size = static_cast<std::size_t>(std::find(short_name, short_name + SIZEOF_SHORT_NAME, '\0') - short_name);
+	return Pointed<std::string>(this->offset(), std::string(short_name, name_size));
+}
+
+template <class Image, class Offset>
+auto CoffSymbolFacade<Image, Offset>::aux_symbol_offset(std::size_t index) const -> offset_type
+{
+	return this->offset() + (1 + index) * SIZEOF_SYMBOL;
+}
+
+template <class Image, class Offset>
+void CoffSymbolFacade<Image, Offset>::read_aux_symbols(void * into_buffer) const
+{
+	image_do_read(*_image, aux_symbol_offset(0), this->number_of_aux_symbols * SIZEOF_SYMBOL, into_buffer);
+}
+
+template <class Image, class Offset>
+auto CoffSymbolFacade<Image, Offset>::long_name_offset() const -> offset_type
+{
+	return _string_table_offset + load_le_value<DWORD>(reinterpret_cast<const char *>(this->short_name) + 4);
+}
+
+struct coff_symbol_advance_pointer_policy
+{
+	template <class Iterator, class Pointer, class RtParams>
+	static void advance_pointer(Iterator iter, Pointer & p, RtParams)
+	{
+		p += (1 + static_cast<std::size_t>(iter->number_of_aux_symbols)) * SIZEOF_SYMBOL;
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef PEPLUS_DETAIL_FACADES_DEBUGDIRECTORYFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_DEBUGDIRECTORYFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/pointed_value.hpp>
+#include <peplus/detail/entry_range.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/image_offset.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace peplus::detail {
+
+struct CodeViewInfo
+{
+	DWORD cv_signature;
+	Guid  guid;
+	DWORD signature;
+	DWORD age;
+};
+
+struct SymbolKey
+{
+	static constexpr std::size_t MAX_SIZE = 2 * sizeof(Guid) + 2 * sizeof(DWORD);
+
+	std::array<char, MAX_SIZE> data;
+	std::size_t                size;
+
+	std::string_view str() const;
+};
+
+template <class Offset>
+struct PogoEntryInfo
+{
+	DWORD                              start_rva;
+	DWORD                              size;
+	PointedValue<Offset, std::string> name;
+};
+
+struct read_pogo_entry
+{
+	template <class Image, class Offset, class RtParams>
+	static PogoEntryInfo<Offset> read_value(const Image & image, Offset offset, const RtParams &)
+	{
+		DWORD entry_header[2];
+		image_do_read(image, offset, sizeof(entry_header), entry_header);
+		boost::endian::little_to_native_inplace(entry_header[0]);
+		boost::endian::little_to_native_inplace(entry_header[1]);
+		return PogoEntryInfo<Offset> { entry_header[0], entry_header[1],
+		                               image.read_string(offset + offsetof(PogoEntry, name)) };
+	}
+};
+
+struct pogo_entry_advance_pointer_policy
+{
+	template <class Iterator, class Pointer, class RtParams>
+	static void advance_pointer(Iterator iter, Pointer & p, RtParams)
+	{
+		p += offsetof(PogoEntry, name) + ((iter->name.size() + 1 + 3) & ~std::size_t(3));
+	}
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+class DebugDirectoryFacade : public PointedValue<Offset, DebugDirectory>
+{
+public:
+	using offset_type = Offset;
+
+	template <typename T>
+	using Pointed = PointedValue<offset_type, T>;
+
+	using PogoEntryRange = EntryRange <
+		Image, read_pointed_value<read_pogo_entry>,
+		pogo_entry_advance_pointer_policy,
+		bounded_distance_stop_iteration_policy<runtime_param<0>>,
+		std::size_t
+	>;
+
+	DebugDirectoryFacade(const Image & image, offset_type offset);
+
+	std::optional<offset_type> data_offset() const;
+	std::optional<std::string_view> data() const;
+	void read_data(void * into_buffer) const;
+
+	std::optional<CodeViewInfo> codeview() const;
+	std::optional<Pointed<std::string>> pdb_file_name() const;
+	std::optional<SymbolKey> symbol_key() const;
+
+	std::optional<DWORD> pogo_signature() const;
+	PogoEntryRange pogo_entries() const;
+
+	std::size_t repro_hash_size() const;
+	std::optional<std::string_view> repro_hash() const;
+	void read_repro_hash(void * into_buffer) const;
+
+private:
+	std::size_t codeview_header_size(DWORD cv_signature) const;
+
+	const Image * _image;
+};
+
+inline std::string_view SymbolKey::str() const
+{
+	return std::string_view(data.data(), size);
+}
+
+inline char * format_hex(char * into, std::uint64_t value, unsigned int digits)
+{
+	static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+	if (digits == 0) {
+		for (std::uint64_t rest = value >> 4; rest != 0; rest >>= 4) ++digits;
+		++digits;
+	}
+	for (unsigned int i = digits; i > 0; --i) {
+		into[i - 1] = HEX_DIGITS[value & 0xf];
+		value >>= 4;
+	}
+	return into + digits;
+}
+
+template <class Image, class Offset = typename Image::offset_type>
+DebugDirectory read_debug_directory_from_image(const Image & image, Offset offset)
+{
+	DebugDirectory debug_directory;
+	image_do_read(image, offset, sizeof(DebugDirectory), &debug_directory);
+	boost::endian::little_to_native_inplace(debug_directory.characteristics    );
+	boost::endian::little_to_native_inplace(debug_directory.time_date_stamp    );
+	boost::endian::little_to_native_inplace(debug_directory.major_version      );
+	boost::endian::little_to_native_inplace(debug_directory.minor_version      );
+	boost::endian::little_to_native_inplace(debug_directory.type               );
+	boost::endian::little_to_native_inplace(debug_directory.size_of_data       );
+	boost::endian::little_to_native_inplace(debug_directory.address_of_raw_data);
+	boost::endian::little_to_native_inplace(debug_directory.pointer_to_raw_data);
+	return debug_directory;
+}
+
+template <class Image, class Offset>
+DebugDirectoryFacade<Image, Offset>::DebugDirectoryFacade(const Image & image, offset_type offset)
+	: PointedValue<Offset, DebugDirectory> { offset, read_debug_directory_from_image(image, offset) }
+	, _image { &image } {}
+
+template <class Image, class Offset>
+auto DebugDirectoryFacade<Image, Offset>::data_offset() const -> std::optional<offset_type>
+{
+	if constexpr (std::is_same_v<offset_type, FileOffset>) {
+		if (this->pointer_to_raw_data == 0) return std::nullopt;
+		return FileOffset(this->pointer_to_raw_data);
+	} else {
+		if (this->address_of_raw_data == 0) return std::nullopt;
+		return to_image_offset(*_image, VirtualOffset(this->address_of_raw_data));
+	}
+}
+
+template <class Image, class Offset>
+std::optional<std::string_view> DebugDirectoryFacade<Image, Offset>::data() const
+{
+	const std::optional<offset_type> data_offset = this->data_offset();
+	if (!data_offset) return std::nullopt;
+
+	const std::optional<std::string_view> data = _image->view(*data_offset, this->size_of_data);
+	if (!data || data->size() < this->size_of_data) return std::nullopt;
+	return data;
+}
+
+template <class Image, class Offset>
+void DebugDirectoryFacade<Image, Offset>::read_data(void * into_buffer) const
+{
+	const std::optional<offset_type> data_offset = this->data_offset();
+	if (!data_offset) throw std::runtime_error("Debug data not present in image");
+	image_do_read(*_image, *data_offset, this->size_of_data, into_buffer);
+}
+
+template <class Image, class Offset>
+std::optional<CodeViewInfo> DebugDirectoryFacade<Image, Offset>::codeview() const
+{
+	if (this->type != DEBUG_TYPE_CODEVIEW || this->size_of_data < sizeof(DWORD)) return std::nullopt;
+
+	const std::optional<offset_type> data_offset = this->data_offset();
+	if (!data_offset) return std::nullopt;
+
+	char cv_header[offsetof(CvInfoPdb70, pdb_file_name)];
+	image_do_read(*_image, *data_offset, sizeof(DWORD), cv_header);
+	const DWORD cv_signature = load_le_value<DWORD>(cv_header);
+	const std::size_t header_size = codeview_header_size(cv_signature);
+	if (header_size == 0 || this->size_of_data < header_size) return std::nullopt;
+
+	image_do_read(*_image, *data_offset, header_size, cv_header);
+	CodeViewInfo codeview_info {};
+	codeview_info.cv_signature = cv_signature;
+	if (cv_signature == CV_SIGNATURE_RSDS) {
+		const char * const guid = cv_header + offsetof(CvInfoPdb70, signature);
+		codeview_info.guid.data1 = load_le_value<DWORD>(guid + offsetof(Guid, data1));
+		codeview_info.guid.data2 = load_le_value<WORD>(guid + offsetof(Guid, data2));
+		codeview_info.guid.data3 = load_le_value<WORD>(guid + offsetof(Guid, data3));
+		std::memcpy(codeview_info.guid.data4, guid + offsetof(Guid, data4), sizeof(codeview_info.guid.data4));
+		codeview_info.age = load_le_value<DWORD>(cv_header + offsetof(CvInfoPdb70, age));
+	} else {
+		codeview_info.signature = load_le_value<DWORD>(cv_header + offsetof(CvInfoPdb20, signature));
+		codeview_info.age = load_le_value<DWORD>(cv_header + offsetof(CvInfoPdb20, age));
+	}
+	return codeview_info;
+}
+
+template <class Image, class Offset>
+auto DebugDirectoryFacade<Image, Offset>::pdb_file_name() const -> std::optional<Pointed<std::string>>
+{
+	const std::optional<CodeViewInfo> codeview_info = codeview();
+	if (!codeview_info) return std::nullopt;
+
+	const offset_type pdb_file_name_offset = *data_offset() + codeview_header_size(codeview_info->cv_signature);
+	return _image->read_string(pdb_file_name_offset);
+}
+
+template <class Image, class Offset>
+std::optional<SymbolKey> DebugDirectoryFacade<Image, Offset>::symbol_key() const
+{
+	const std::optional<CodeViewInfo> codeview_info = codeview();
+	if (!codeview_info) return std::nullopt;
+
+	SymbolKey symbol_key;
+	char * key_end = symbol_key.data.data();
+	if (codeview_info->cv_signature == CV_SIGNATURE_RSDS) {
+		key_end = format_hex(key_end, codeview_info->guid.data1, 2 * sizeof(DWORD));
+		key_end = format_hex(key_end, codeview_info->guid.data2, 2 * sizeof(WORD));
+		key_end = format_hex(key_end, codeview_info->guid.data3, 2 * sizeof(WORD));
+		for (BYTE guid_byte : codeview_info->guid.data4)
+			key_end = format_hex(key_end, guid_byte, 2 * sizeof(BYTE));
+	} else {
+		key_end = format_hex(key_end, codeview_info->signature, 2 * sizeof(DWORD));
+	}
+	key_end = format_hex(key_end, codeview_info->age, 0);
+	symbol_key.size = static_cast<std::size_t>(key_end - symbol_key.data.data());
+	return symbol_key;
+}
+
+template <class Image, class Offset>
+std::optional<DWORD> DebugDirectoryFacade<Image, Offset>::pogo_signature() const
+{
+	if (this->type != DEBUG_TYPE_POGO || this->size_of_data < sizeof(DWORD)) return std::nullopt;
+
+	const std::optional<offset_type> data_offset = this->data_offset();
+	if (!data_offset) return std::nullopt;
+
+	return read_trivial_le_value<DWORD>::read_value(*_image, *data_offset, std::tuple<>());
+}
+
+template <class Image, class Offset>
+auto DebugDirectoryFacade<Image, Offset>::pogo_entries() const -> PogoEntryRange
+{
+	const std::optional<offset_type> data_offset = this->data_offset();
+	if (this->type != DEBUG_TYPE_POGO || this->size_of_data < sizeof(DWORD) || !data_offset)
+		return PogoEntryRange(*_image, offset_type(0), 0);
+
+	const std::size_t entries_size = (this->size_of_data - sizeof(DWORD)) & ~std::size_t(3);
+	return PogoEntryRange(*_image, *data_offset + sizeof(DWORD), entries_size);
+}
+
+template <class Image, class Offset>
+std::size_t DebugDirectoryFacade<Image, Offset>::repro_hash_size() const
+{
+	if (this->type != DEBUG_TYPE_REPRO || this->size_of_data < sizeof(DWORD)) return 0;
+
+	const std::optional<offset_type> data_offset = this->data_offset();
+	if (!data_offset) return 0;
+
+	const DWORD hash_size = read_trivial_le_value<DWORD>::read_value(*_image, *data_offset, std::tuple<>());
+	return std::min<std::size_t>(hash_size, this->size_of_data - sizeof(DWORD));
+}
+
+template <class Image, class Offset>
+std::optional<std::string_view> DebugDirectoryFacade<Image, Offset>::repro_hash() const
+{
+	const std::size_t hash_size = repro_hash_size();
+	if (hash_size == 0) return std::nullopt;
+
+	const std::optional<std::string_view> repro_hash = _image->view(*data_offset() + sizeof(DWORD), hash_size);
+	if (!repro_hash || repro_hash->size() < hash_size) return std::nullopt;
+	return repro_hash;
+}
+
+template <class Image, class Offset>
+void DebugDirectoryFacade<Image, Offset>::read_repro_hash(void * into_buffer) const
+{
+	const std::size_t hash_size = repro_hash_size();
+	if (hash_size != 0) image_do_read(*_image, *data_offset() + sizeof(DWORD), hash_size, into_buffer);
+}
+
+template <class Image, class Offset>
+std::size_t DebugDirectoryFacade<Image, Offset>::codeview_header_size(DWORD cv_signature) const
+{
+	switch (cv_signature) {
+		case CV_SIGNATURE_RSDS: return offsetof(CvInfoPdb70, pdb_file_name);
+		case CV_SIGNATURE_NB10: return offsetof(CvInfoPdb20, pdb_file_name);
+		default:                return 0;
+	}
+}
+
+}
+
+#endif
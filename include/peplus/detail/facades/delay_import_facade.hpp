@@ -0,0 +1,192 @@
+#ifndef PEPLUS_DETAIL_FACADES_DELAYIMPORTFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_DELAYIMPORTFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/pointed_value.hpp>
+#include <peplus/detail/entry_range.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/image_offset.hpp>
+#include <peplus/detail/transform_range.hpp>
+#include <peplus/detail/facades/import_descriptor_facade.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace peplus::detail {
+
+template <unsigned int XX, class Image>
+class DelayImportDescriptorFacade : public DelayLoadDescriptor
+{
+public:
+	using offset_type = typename Image::offset_type;
+
+	template <typename T>
+	using Pointed = PointedValue<offset_type, T>;
+
+	using NamedImport = typename ImportDescriptorFacade<XX, Image>::NamedImport;
+	using UnnamedImport = typename ImportDescriptorFacade<XX, Image>::UnnamedImport;
+	using ImportEntry = typename ImportDescriptorFacade<XX, Image>::ImportEntry;
+	using ThunkDataRange = typename ImportDescriptorFacade<XX, Image>::ThunkDataRange;
+
+	class thunk_data_to_import_entry_transformer;
+
+	using ImportEntryRange = TransformRange <
+		thunk_data_to_import_entry_transformer, ThunkDataRange
+	>;
+
+	DelayImportDescriptorFacade(const Image & image, offset_type offset);
+
+	bool is_rva_based() const;
+	ULONG_PTR<XX> address_bias() const;
+	VirtualOffset to_rva(ULONG_PTR<XX> address) const;
+
+	Pointed<std::string> name_str() const;
+
+	ThunkDataRange thunks() const;
+	ThunkDataRange original_thunks() const;
+	ThunkDataRange bound_thunks() const;
+
+	ImportEntryRange entries() const;
+
+	bool is_named_import(const ImportEntry & import_entry) const;
+	bool is_unnamed_import(const ImportEntry & import_entry) const;
+
+private:
+	ThunkDataRange thunks_at(DWORD address) const;
+
+	const Image * _image;
+};
+
+template <unsigned int XX, class Image>
+class DelayImportDescriptorFacade<XX, Image>::thunk_data_to_import_entry_transformer
+{
+public:
+	thunk_data_to_import_entry_transformer(const Image & image, ULONG_PTR<XX> address_bias)
+		: _image { &image }, _address_bias { address_bias } {}
+
+	ImportEntry operator()(const ThunkData<XX> & thunk_data) const
+	{
+		if ((thunk_data.ordinal & ORDINAL_FLAG<XX>) != 0) {
+			const auto ordinal = thunk_data.ordinal & ~ORDINAL_FLAG<XX>;
+			return UnnamedImport { static_cast<unsigned int>(ordinal) };
+		} else {
+			const VirtualOffset hint_name_rva ( thunk_data.address_of_data - _address_bias );
+			const VirtualOffset name_rva = hint_name_rva + offsetof(ImportByName, name);
+			return NamedImport { _image->read_string(name_rva) };
+		}
+	}
+
+private:
+	const Image * _image;
+	ULONG_PTR<XX> _address_bias;
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+DelayLoadDescriptor read_delay_load_descriptor_from_image(const Image & image, Offset offset)
+{
+	DelayLoadDescriptor delay_descriptor;
+	image_do_read(image, offset, sizeof(DelayLoadDescriptor), &delay_descriptor);
+	boost::endian::little_to_native_inplace(delay_descriptor.attributes                    );
+	boost::endian::little_to_native_inplace(delay_descriptor.dll_name_rva                  );
+	boost::endian::little_to_native_inplace(delay_descriptor.module_handle_rva             );
+	boost::endian::little_to_native_inplace(delay_descriptor.import_address_table_rva      );
+	boost::endian::little_to_native_inplace(delay_descriptor.import_name_table_rva         );
+	boost::endian::little_to_native_inplace(delay_descriptor.bound_import_address_table_rva);
+	boost::endian::little_to_native_inplace(delay_descriptor.unload_information_table_rva  );
+	boost::endian::little_to_native_inplace(delay_descriptor.time_date_stamp               );
+	return delay_descriptor;
+}
+
+template <unsigned int XX, class Image>
+DelayImportDescriptorFacade<XX, Image>::DelayImportDescriptorFacade(const Image & image, offset_type offset)
+	: DelayLoadDescriptor { read_delay_load_descriptor_from_image(image, offset) }
+	, _image { &image } {}
+
+template <unsigned int XX, class Image>
+bool DelayImportDescriptorFacade<XX, Image>::is_rva_based() const
+{
+	return (this->attributes & DELAYLOAD_RVA_BASED) != 0;
+}
+
+template <unsigned int XX, class Image>
+ULONG_PTR<XX> DelayImportDescriptorFacade<XX, Image>::address_bias() const
+{
+	return is_rva_based() ? 0 : _image->optional_header().image_base;
+}
+
+template <unsigned int XX, class Image>
+VirtualOffset DelayImportDescriptorFacade<XX, Image>::to_rva(ULONG_PTR<XX> address) const
+{
+	return VirtualOffset(static_cast<std::ptrdiff_t>(address - address_bias()));
+}
+
+template <unsigned int XX, class Image>
+auto DelayImportDescriptorFacade<XX, Image>::name_str() const -> Pointed<std::string>
+{
+	return _image->read_string(to_rva(this->dll_name_rva));
+}
+
+template <unsigned int XX, class Image>
+auto DelayImportDescriptorFacade<XX, Image>::thunks() const -> ThunkDataRange
+{
+	return thunks_at(this->import_address_table_rva);
+}
+
+template <unsigned int XX, class Image>
+auto DelayImportDescriptorFacade<XX, Image>::original_thunks() const -> ThunkDataRange
+{
+	return thunks_at(this->import_name_table_rva);
+}
+
+template <unsigned int XX, class Image>
+auto DelayImportDescriptorFacade<XX, Image>::bound_thunks() const -> ThunkDataRange
+{
+	return thunks_at(this->bound_import_address_table_rva);
+}
+
+template <unsigned int XX, class Image>
+auto DelayImportDescriptorFacade<XX, Image>::entries() const -> ImportEntryRange
+{
+	thunk_data_to_import_entry_transformer to_import_entries { *_image, address_bias() };
+	return ImportEntryRange(original_thunks(), std::move(to_import_entries));
+}
+
+template <unsigned int XX, class Image>
+bool DelayImportDescriptorFacade<XX, Image>::is_named_import(const ImportEntry & import_entry) const
+{
+	return import_entry.index() == 0;
+}
+
+template <unsigned int XX, class Image>
+bool DelayImportDescriptorFacade<XX, Image>::is_unnamed_import(const ImportEntry & import_entry) const
+{
+	return import_entry.index() == 1;
+}
+
+template <unsigned int XX, class Image>
+auto DelayImportDescriptorFacade<XX, Image>::thunks_at(DWORD address) const -> ThunkDataRange
+{
+	if (address == 0) return ThunkDataRange(*_image, offset_type(0), false);
+
+	const std::optional<offset_type> thunks_offset = to_image_offset(*_image, to_rva(address));
+	return ThunkDataRange(*_image, thunks_offset.value_or(offset_type(0)), thunks_offset.has_value());
+}
+
+constexpr bool operator ==(const DelayLoadDescriptor & lhs, const DelayLoadDescriptor & rhs)
+{
+	return lhs.attributes                     == rhs.attributes
+	    && lhs.dll_name_rva                   == rhs.dll_name_rva
+	    && lhs.module_handle_rva              == rhs.module_handle_rva
+	    && lhs.import_address_table_rva       == rhs.import_address_table_rva
+	    && lhs.import_name_table_rva          == rhs.import_name_table_rva
+	    && lhs.bound_import_address_table_rva == rhs.bound_import_address_table_rva
+	    && lhs.unload_information_table_rva   == rhs.unload_information_table_rva
+	    && lhs.time_date_stamp                == rhs.time_date_stamp;
+}
+
+}
+
+#endif
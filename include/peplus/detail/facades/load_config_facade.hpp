@@ -0,0 +1,210 @@
+#ifndef PEPLUS_DETAIL_FACADES_LOADCONFIGFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_LOADCONFIGFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/pointed_value.hpp>
+#include <peplus/detail/entry_range.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/image_offset.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace peplus::detail {
+
+template <unsigned int XX, class Image>
+class LoadConfigDirectoryFacade : public LoadConfigDirectory<XX>
+{
+public:
+	using offset_type = typename Image::offset_type;
+
+	using SEHandlerRange = EntryRange <
+		Image, read_pointed_trivial_le_value_as<VirtualOffset, DWORD>,
+		fixed_distance_advance_pointer_policy<constexpr_<sizeof(DWORD)>>,
+		fixed_distance_stop_iteration_policy<runtime_param<0>>,
+		std::size_t
+	>;
+
+	using GuardCFFunctionRange = EntryRange <
+		Image, read_pointed_trivial_le_value_as<VirtualOffset, DWORD>,
+		fixed_distance_advance_pointer_policy<runtime_param<1>>,
+		fixed_distance_stop_iteration_policy<runtime_param<0>>,
+		std::size_t, std::size_t
+	>;
+
+	LoadConfigDirectoryFacade(const Image & image, offset_type offset);
+
+	SEHandlerRange se_handlers() const;
+
+	std::size_t guard_cf_function_stride() const;
+	std::size_t guard_cf_function_table_count() const;
+	GuardCFFunctionRange guard_cf_functions() const;
+	std::size_t read_guard_cf_functions(DWORD * into_buffer) const;
+
+private:
+	std::optional<offset_type> va_to_image_offset(ULONG_PTR<XX> va) const;
+	std::size_t available_size(offset_type offset) const;
+
+	const Image * _image;
+};
+
+template <unsigned int XX, class Image, class Offset = typename Image::offset_type>
+LoadConfigDirectory<XX> read_load_config_directory_from_image(const Image & image, Offset offset)
+{
+	DWORD directory_size;
+	image_do_read(image, offset, sizeof(DWORD), &directory_size);
+	boost::endian::little_to_native_inplace(directory_size);
+	if (directory_size < sizeof(DWORD)) throw std::runtime_error("Invalid load config directory");
+
+	LoadConfigDirectory<XX> load_config {};
+	image_do_read(image, offset, std::min<std::size_t>(directory_size, sizeof(LoadConfigDirectory<XX>)), &load_config);
+	boost::endian::little_to_native_inplace(load_config.size                                          );
+	boost::endian::little_to_native_inplace(load_config.time_date_stamp                               );
+	boost::endian::little_to_native_inplace(load_config.major_version                                 );
+	boost::endian::little_to_native_inplace(load_config.minor_version                                 );
+	boost::endian::little_to_native_inplace(load_config.global_flags_clear                            );
+	boost::endian::little_to_native_inplace(load_config.global_flags_set                              );
+	boost::endian::little_to_native_inplace(load_config.critical_section_default_timeout              );
+	boost::endian::little_to_native_inplace(load_config.de_commit_free_block_threshold                );
+	boost::endian::little_to_native_inplace(load_config.de_commit_total_free_threshold                );
+	boost::endian::little_to_native_inplace(load_config.lock_prefix_table                             );
+	boost::endian::little_to_native_inplace(load_config.maximum_allocation_size                       );
+	boost::endian::little_to_native_inplace(load_config.virtual_memory_threshold                      );
+	boost::endian::little_to_native_inplace(load_config.process_heap_flags                            );
+	boost::endian::little_to_native_inplace(load_config.process_affinity_mask                         );
+	boost::endian::little_to_native_inplace(load_config.csd_version                                   );
+	boost::endian::little_to_native_inplace(load_config.dependent_load_flags                          );
+	boost::endian::little_to_native_inplace(load_config.edit_list                                     );
+	boost::endian::little_to_native_inplace(load_config.security_cookie                               );
+	boost::endian::little_to_native_inplace(load_config.se_handler_table                              );
+	boost::endian::little_to_native_inplace(load_config.se_handler_count                              );
+	boost::endian::little_to_native_inplace(load_config.guard_cf_check_function_pointer               );
+	boost::endian::little_to_native_inplace(load_config.guard_cf_dispatch_function_pointer            );
+	boost::endian::little_to_native_inplace(load_config.guard_cf_function_table                       );
+	boost::endian::little_to_native_inplace(load_config.guard_cf_function_count                       );
+	boost::endian::little_to_native_inplace(load_config.guard_flags                                   );
+	boost::endian::little_to_native_inplace(load_config.code_integrity.flags                          );
+	boost::endian::little_to_native_inplace(load_config.code_integrity.catalog                        );
+	boost::endian::little_to_native_inplace(load_config.code_integrity.catalog_offset                 );
+	boost::endian::little_to_native_inplace(load_config.code_integrity.reserved                       );
+	boost::endian::little_to_native_inplace(load_config.guard_address_taken_iat_entry_table           );
+	boost::endian::little_to_native_inplace(load_config.guard_address_taken_iat_entry_count           );
+	boost::endian::little_to_native_inplace(load_config.guard_long_jump_target_table                  );
+	boost::endian::little_to_native_inplace(load_config.guard_long_jump_target_count                  );
+	boost::endian::little_to_native_inplace(load_config.dynamic_value_reloc_table                     );
+	boost::endian::little_to_native_inplace(load_config.chpe_metadata_pointer                         );
+	boost::endian::little_to_native_inplace(load_config.guard_rf_failure_routine                      );
+	boost::endian::little_to_native_inplace(load_config.guard_rf_failure_routine_function_pointer     );
+	boost::endian::little_to_native_inplace(load_config.dynamic_value_reloc_table_offset              );
+	boost::endian::little_to_native_inplace(load_config.dynamic_value_reloc_table_section             );
+	boost::endian::little_to_native_inplace(load_config.reserved_2                                    );
+	boost::endian::little_to_native_inplace(load_config.guard_rf_verify_stack_pointer_function_pointer);
+	boost::endian::little_to_native_inplace(load_config.hot_patch_table_offset                        );
+	boost::endian::little_to_native_inplace(load_config.reserved_3                                    );
+	boost::endian::little_to_native_inplace(load_config.enclave_configuration_pointer                 );
+	boost::endian::little_to_native_inplace(load_config.volatile_metadata_pointer                     );
+	boost::endian::little_to_native_inplace(load_config.guard_eh_continuation_table                   );
+	boost::endian::little_to_native_inplace(load_config.guard_eh_continuation_count                   );
+	return load_config;
+}
+
+template <unsigned int XX, class Image>
+LoadConfigDirectoryFacade<XX, Image>::LoadConfigDirectoryFacade(const Image & image, offset_type offset)
+	: LoadConfigDirectory<XX> { read_load_config_directory_from_image<XX>(image, offset) }
+	, _image { &image } {}
+
+template <unsigned int XX, class Image>
+auto LoadConfigDirectoryFacade<XX, Image>::se_handlers() const -> SEHandlerRange
+{
+	const std::optional<offset_type> table_offset = va_to_image_offset(this->se_handler_table);
+	if (!table_offset) return SEHandlerRange(*_image, offset_type(0), 0);
+	return SEHandlerRange(*_image, *table_offset, static_cast<std::size_t>(this->se_handler_count) * sizeof(DWORD));
+}
+
+template <unsigned int XX, class Image>
+std::size_t LoadConfigDirectoryFacade<XX, Image>::guard_cf_function_stride() const
+{
+	return sizeof(DWORD) + ((this->guard_flags & GUARD_CF_FUNCTION_TABLE_SIZE_MASK) >> GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT);
+}
+
+template <unsigned int XX, class Image>
+std::size_t LoadConfigDirectoryFacade<XX, Image>::guard_cf_function_table_count() const
+{
+	const std::optional<offset_type> table_offset = va_to_image_offset(this->guard_cf_function_table);
+	if (!table_offset) return 0;
+
+	const std::size_t stride = guard_cf_function_stride();
+	if (this->guard_cf_function_count > std::numeric_limits<std::size_t>::max() / stride)
+		throw std::runtime_error("Invalid guard CF function count");
+	return std::min(static_cast<std::size_t>(this->guard_cf_function_count), available_size(*table_offset) / stride);
+}
+
+template <unsigned int XX, class Image>
+auto LoadConfigDirectoryFacade<XX, Image>::guard_cf_functions() const -> GuardCFFunctionRange
+{
+	const std::size_t stride = guard_cf_function_stride();
+	const std::size_t count = guard_cf_function_table_count();
+	if (count == 0) return GuardCFFunctionRange(*_image, offset_type(0), 0, stride);
+	return GuardCFFunctionRange(*_image, *va_to_image_offset(this->guard_cf_function_table), count * stride, stride);
+}
+
+template <unsigned int XX, class Image>
+std::size_t LoadConfigDirectoryFacade<XX, Image>::read_guard_cf_functions(DWORD * into_buffer) const
+{
+	const std::size_t count = guard_cf_function_table_count();
+	if (count == 0) return 0;
+
+	const offset_type table_offset = *va_to_image_offset(this->guard_cf_function_table);
+	const std::size_t stride = guard_cf_function_stride();
+	if (stride == sizeof(DWORD)) {
+		image_do_read(*_image, table_offset, count * sizeof(DWORD), into_buffer);
+		for (std::size_t i = 0; i < count; ++i)
+			boost::endian::little_to_native_inplace(into_buffer[i]);
+		return count;
+	}
+
+	std::vector<char> table_data (count * stride);
+	image_do_read(*_image, table_offset, table_data.size(), table_data.data());
+	for (std::size_t i = 0; i < count; ++i)
+		into_buffer[i] = load_le_value<DWORD>(table_data.data() + i * stride);
+	return count;
+}
+
+template <unsigned int XX, class Image>
+auto LoadConfigDirectoryFacade<XX, Image>::va_to_image_offset(ULONG_PTR<XX> va) const -> std::optional<offset_type>
+{
+	const ULONG_PTR<XX> image_base = _image->optional_header().image_base;
+	if (va == 0 || va < image_base) return std::nullopt;
+	return to_image_offset(*_image, VirtualOffset(static_cast<std::ptrdiff_t>(va - image_base)));
+}
+
+template <unsigned int XX, class Image>
+std::size_t LoadConfigDirectoryFacade<XX, Image>::available_size(offset_type offset) const
+{
+	if (offset.value() < 0) return 0;
+	const std::size_t table_offset = static_cast<std::size_t>(offset.value());
+
+	std::size_t size = 0;
+	const std::size_t headers_size = _image->optional_header().size_of_headers;
+	if (table_offset < headers_size) size = headers_size - table_offset;
+	for (const auto & section_header : _image->section_headers()) {
+		const auto [section_offset, section_size] = section_extent(*_image, section_header);
+		if (section_offset <= table_offset && table_offset - section_offset < section_size)
+			size = std::max(size, section_offset + section_size - table_offset);
+	}
+
+	if (const std::optional<std::string_view> image_view = _image->view())
+		size = std::min(size, table_offset < image_view->size() ? image_view->size() - table_offset : 0);
+	return size;
+}
+
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef PEPLUS_DETAIL_FACADES_RICHHEADERFACADE_HPP_
+#define PEPLUS_DETAIL_FACADES_RICHHEADERFACADE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace peplus::detail {
+
+const std::size_t RICH_SCAN_SIZE = 0x1000;
+const std::size_t RICH_PADDING_SIZE = 3 * sizeof(DWORD);
+
+struct RichEntry
+{
+	WORD  product_id;
+	WORD  build;
+	DWORD count;
+};
+
+template <class Image, class Offset = typename Image::offset_type>
+class RichHeaderFacade
+{
+public:
+	using offset_type = Offset;
+
+	static constexpr std::size_t MAX_ENTRIES = 128;
+	static constexpr std::size_t MAX_CLEAR_DATA_SIZE = sizeof(DWORD) + RICH_PADDING_SIZE + MAX_ENTRIES * sizeof(RichHeaderEntry);
+
+	RichHeaderFacade(const Image & image, offset_type offset);
+
+	offset_type offset() const;
+	DWORD key() const;
+
+	std::size_t size() const;
+	const RichEntry * begin() const;
+	const RichEntry * end() const;
+	const RichEntry & operator [](std::size_t index) const;
+
+	DWORD compute_checksum() const;
+	bool is_valid() const;
+
+	std::size_t clear_data(char * into_buffer) const;
+
+	template <class Hash>
+	Hash & hash(Hash & hash) const;
+
+private:
+	const Image                        * _image;
+	offset_type                          _offset;
+	DWORD                                _key;
+	std::array<DWORD, 3>                 _padding;
+	std::size_t                          _size = 0;
+	std::array<RichEntry, MAX_ENTRIES>   _entries;
+};
+
+inline DWORD rotate_left(DWORD value, unsigned int shift)
+{
+	shift &= 31;
+	return shift == 0 ? value : (value << shift) | (value >> (32 - shift));
+}
+
+template <class Image, class Offset = typename Image::offset_type>
+std::optional<Offset> find_rich_header(const Image & image, std::size_t stub_end)
+{
+	const std::size_t stub_begin = sizeof(DosHeader);
+	if (stub_end < stub_begin + 2 * sizeof(DWORD)) return std::nullopt;
+
+	const std::size_t window_begin = (std::max(stub_begin, stub_end > RICH_SCAN_SIZE ? stub_end - RICH_SCAN_SIZE : 0) + 3) & ~std::size_t(3);
+	std::array<char, RICH_SCAN_SIZE> window_buffer;
+	std::string_view window;
+	if (const std::optional<std::string_view> stub_view = image.view(Offset(window_begin), stub_end - window_begin)) {
+		window = *stub_view;
+	} else {
+		const std::size_t bytes_read = image.read(Offset(window_begin), stub_end - window_begin, window_buffer.data()).first;
+		window = std::string_view(window_buffer.data(), bytes_read);
+	}
+	if (window.size() < 2 * sizeof(DWORD)) return std::nullopt;
+
+	for (std::size_t rich_pos = (window.size() - 2 * sizeof(DWORD)) & ~std::size_t(3); ; rich_pos -= sizeof(DWORD)) {
+		if (load_le_value<DWORD>(window.data() + rich_pos) == RICH_SIGNATURE) {
+			const DWORD key = load_le_value<DWORD>(window.data() + rich_pos + sizeof(DWORD));
+			for (std::size_t dans_pos = rich_pos; dans_pos >= sizeof(DWORD); ) {
+				dans_pos -= sizeof(DWORD);
+				if ((load_le_value<DWORD>(window.data() + dans_pos) ^ key) == DANS_SIGNATURE)
+					return Offset(window_begin + dans_pos);
+			}
+			return std::nullopt;
+		}
+		if (rich_pos == 0) return std::nullopt;
+	}
+}
+
+template <class Image, class Offset>
+RichHeaderFacade<Image, Offset>::RichHeaderFacade(const Image & image, offset_type offset)
+	: _image { &image }, _offset { offset }
+{
+	std::array<char, MAX_CLEAR_DATA_SIZE + 2 * sizeof(DWORD)> header_data;
+	const std::size_t bytes_read = image.read(offset, header_data.size(), header_data.data()).first;
+	if (bytes_read < sizeof(DWORD) + RICH_PADDING_SIZE) throw std::runtime_error("Invalid rich header");
+
+	_key = load_le_value<DWORD>(header_data.data()) ^ DANS_SIGNATURE;
+	for (std::size_t i = 0; i < _padding.size(); ++i)
+		_padding[i] = load_le_value<DWORD>(header_data.data() + sizeof(DWORD) * (1 + i)) ^ _key;
+
+	for (std::size_t entry_pos = sizeof(DWORD) + RICH_PADDING_SIZE; ; entry_pos += sizeof(RichHeaderEntry)) {
+		if (entry_pos + sizeof(RichHeaderEntry) > bytes_read) throw std::runtime_error("Invalid rich header");
+
+		const DWORD comp_id = load_le_value<DWORD>(header_data.data() + entry_pos);
+		const DWORD count = load_le_value<DWORD>(header_data.data() + entry_pos + sizeof(DWORD));
+		if (comp_id == RICH_SIGNATURE && count == _key) break;
+		if (_size == MAX_ENTRIES) throw std::runtime_error("Invalid rich header");
+
+		const DWORD clear_comp_id = comp_id ^ _key;
+		_entries[_size++] = RichEntry { static_cast<WORD>(clear_comp_id >> 16), static_cast<WORD>(clear_comp_id), count ^ _key };
+	}
+}
+
+template <class Image, class Offset>
+auto RichHeaderFacade<Image, Offset>::offset() const -> offset_type
+{
+	return _offset;
+}
+
+template <class Image, class Offset>
+DWORD RichHeaderFacade<Image, Offset>::key() const
+{
+	return _key;
+}
+
+template <class Image, class Offset>
+std::size_t RichHeaderFacade<Image, Offset>::size() const
+{
+	return _size;
+}
+
+template <class Image, class Offset>
+const RichEntry * RichHeaderFacade<Image, Offset>::begin() const
+{
+	return _entries.data();
+}
+
+template <class Image, class Offset>
+const RichEntry * RichHeaderFacade<Image, Offset>::end() const
+{
+	return _entries.data() + _size;
+}
+
+template <class Image, class Offset>
+const RichEntry & RichHeaderFacade<Image, Offset>::operator [](std::size_t index) const
+{
+	return _entries[index];
+}
+
+template <class Image, class Offset>
+DWORD RichHeaderFacade<Image, Offset>::compute_checksum() const
+{
+	const std::size_t header_offset = static_cast<std::size_t>(_offset.value());
+	DWORD checksum = static_cast<DWORD>(header_offset);
+
+	std::array<char, RICH_SCAN_SIZE> chunk;
+	for (std::size_t chunk_offset = 0; chunk_offset < header_offset; chunk_offset += chunk.size()) {
+		const std::size_t chunk_size = std::min(chunk.size(), header_offset - chunk_offset);
+		image_do_read(*_image, Offset(chunk_offset), chunk_size, chunk.data());
+		for (std::size_t i = 0; i < chunk_size; ++i) {
+			const std::size_t byte_offset = chunk_offset + i;
+			if (byte_offset >= offsetof(DosHeader, e_lfanew) && byte_offset < offsetof(DosHeader, e_lfanew) + sizeof(DWORD)) continue;
+			checksum += rotate_left(static_cast<BYTE>(chunk[i]), static_cast<unsigned int>(byte_offset));
+		}
+	}
+
+	for (const RichEntry & entry : *this)
+		checksum += rotate_left(DWORD(entry.product_id) << 16 | entry.build, entry.count);
+	return checksum;
+}
+
+template <class Image, class Offset>
+bool RichHeaderFacade<Image, Offset>::is_valid() const
+{
+	return compute_checksum() == _key;
+}
+
+template <class Image, class Offset>
+std::size_t RichHeaderFacade<Image, Offset>::clear_data(char * into_buffer) const
+{
+	char * data_end = into_buffer;
+	store_le_value<DWORD>(data_end, DANS_SIGNATURE), data_end += sizeof(DWORD);
+	for (DWORD padding : _padding)
+		store_le_value<DWORD>(data_end, padding), data_end += sizeof(DWORD);
+	for (const RichEntry & entry : *this) {
+		store_le_value<DWORD>(data_end, DWORD(entry.product_id) << 16 | entry.build), data_end += sizeof(DWORD);
+		store_le_value<DWORD>(data_end, entry.count), data_end += sizeof(DWORD);
+	}
+	return static_cast<std::size_t>(data_end - into_buffer);
+}
+
+template <class Image, class Offset> template <class Hash>
+Hash & RichHeaderFacade<Image, Offset>::hash(Hash & hash) const
+{
+	std::array<char, MAX_CLEAR_DATA_SIZE> clear_data;
+	hash.update(clear_data.data(), this->clear_data(clear_data.data()));
+	return hash;
+}
+
+}
+
+#endif
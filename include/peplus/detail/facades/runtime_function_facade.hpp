@@ -27,6 +27,9 @@ struct read_unwind_code
 	}
 };
 
+template <class Image>
+class RuntimeFunctionFacade;
+
 template <class Image, class Offset = typename Image::offset_type>
 class UnwindInfoFacade : public PointedValue<Offset, UnwindInfo>
 {
@@ -45,9 +48,14 @@ public:
 	UnwindInfoFacade(const Image & image, offset_type offset);
 
 	UnwindCodeRange codes() const;
+	void read_code_slots(WORD * into_buffer) const;
+
 	std::optional<Pointed<VirtualOffset>> handler() const;
+	std::optional<RuntimeFunctionFacade<Image>> chained_function() const;
 
 private:
+	Offset trailing_data_offset() const;
+
 	const Image * _image;
 };
 
@@ -118,21 +126,42 @@ auto UnwindInfoFacade<Image, Offset>::codes() const -> UnwindCodeRange
 	return UnwindCodeRange(*_image, codes_offset, this->count_of_codes);
 }
 
+template <class Image, class Offset>
+void UnwindInfoFacade<Image, Offset>::read_code_slots(WORD * into_buffer) const
+{
+	const Offset codes_offset = this->offset() + offsetof(UnwindInfo, unwind_code);
+	image_do_read(*_image, codes_offset, this->count_of_codes * sizeof(WORD), into_buffer);
+	for (unsigned int i = 0; i < this->count_of_codes; ++i)
+		boost::endian::little_to_native_inplace(into_buffer[i]);
+}
+
 template <class Image, class Offset>
 auto UnwindInfoFacade<Image, Offset>::handler() const -> std::optional<Pointed<VirtualOffset>>
 {
 	if ((this->flags & UNW_FLAG_CHAININFO) != 0) return std::nullopt;
 	if ((this->flags & (UNW_FLAG_EHANDLER | UNW_FLAG_UHANDLER)) == 0) return std::nullopt;
 
-	const Offset codes_offset = this->offset() + offsetof(UnwindInfo, unwind_code);
-	const Offset data_offset = codes_offset + this->count_of_codes * sizeof(UnwindCode);
-
-	unsigned long handler;
-	image_do_read(*_image, data_offset, sizeof(unsigned long), &handler);
+	DWORD handler;
+	const Offset data_offset = trailing_data_offset();
+	image_do_read(*_image, data_offset, sizeof(DWORD), &handler);
 	const VirtualOffset handler_rva { boost::endian::little_to_native(handler) };
 	return Pointed<VirtualOffset>(data_offset, handler_rva);
 }
 
+template <class Image, class Offset>
+auto UnwindInfoFacade<Image, Offset>::chained_function() const -> std::optional<RuntimeFunctionFacade<Image>>
+{
+	if ((this->flags & UNW_FLAG_CHAININFO) == 0) return std::nullopt;
+	return RuntimeFunctionFacade<Image>(*_image, trailing_data_offset());
+}
+
+template <class Image, class Offset>
+Offset UnwindInfoFacade<Image, Offset>::trailing_data_offset() const
+{
+	const Offset codes_offset = this->offset() + offsetof(UnwindInfo, unwind_code);
+	return codes_offset + ((this->count_of_codes + 1) & ~1u) * sizeof(UnwindCode);
+}
+
 }
 
 #endif
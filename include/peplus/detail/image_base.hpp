@@ -7,9 +7,17 @@
 #include <peplus/detail/image_offset.hpp>
 #include <peplus/detail/image_helpers.hpp>
 #include <peplus/detail/facades/base_relocation_facade.hpp>
+#include <peplus/detail/facades/bound_import_facade.hpp>
+#include <peplus/detail/facades/certificate_facade.hpp>
+#include <peplus/detail/facades/clr_header_facade.hpp>
+#include <peplus/detail/facades/coff_symbol_facade.hpp>
+#include <peplus/detail/facades/debug_directory_facade.hpp>
+#include <peplus/detail/facades/delay_import_facade.hpp>
 #include <peplus/detail/facades/export_directory_facade.hpp>
 #include <peplus/detail/facades/import_descriptor_facade.hpp>
+#include <peplus/detail/facades/load_config_facade.hpp>
 #include <peplus/detail/facades/resource_directory_facade.hpp>
+#include <peplus/detail/facades/rich_header_facade.hpp>
 #include <peplus/detail/facades/runtime_function_facade.hpp>
 #include <peplus/detail/facades/tls_directory_facade.hpp>
 
@@ -19,6 +27,7 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <type_traits>
 #include <utility>
@@ -64,6 +73,22 @@ public:
 		default_value_stop_iteration_policy<ImportDescriptor>
 	>;
 
+	using DelayImportDescriptorRange = EntryRange <
+		ImageBase, read_pointed_value<read_proxy_object<DelayImportDescriptorFacade<XX, ImageBase>>>,
+		fixed_distance_advance_pointer_policy<constexpr_<sizeof(DelayLoadDescriptor)>>,
+		either_stop_iteration_policy < bounded_distance_stop_iteration_policy<runtime_param<0>>,
+		                               default_value_stop_iteration_policy<DelayLoadDescriptor> >,
+		std::size_t
+	>;
+
+	using BoundImportDescriptorRange = EntryRange <
+		ImageBase, read_proxy_object<BoundImportDescriptorFacade<ImageBase>, runtime_param<1>>,
+		bound_import_advance_pointer_policy,
+		either_stop_iteration_policy < bounded_distance_stop_iteration_policy<runtime_param<0>>,
+		                               default_value_stop_iteration_policy<BoundImportDescriptor> >,
+		std::size_t, Offset
+	>;
+
 	using BaseRelocationRange = EntryRange <
 		ImageBase, read_proxy_object<BaseRelocationFacade<ImageBase>>,
 		base_relocation_advance_pointer_policy,
@@ -72,12 +97,26 @@ public:
 	>;
 
 	using DebugDirectoryRange = EntryRange <
-		ImageBase, read_pointed_value<read_debug_directory>,
+		ImageBase, read_proxy_object<DebugDirectoryFacade<ImageBase>>,
 		fixed_distance_advance_pointer_policy<constexpr_<sizeof(DebugDirectory)>>,
 		fixed_distance_stop_iteration_policy<runtime_param<0>>,
 		std::size_t
 	>;
 
+	using CertificateRange = EntryRange <
+		ImageBase, read_proxy_object<CertificateFacade<ImageBase>>,
+		certificate_advance_pointer_policy,
+		bounded_distance_stop_iteration_policy<runtime_param<0>>,
+		std::size_t
+	>;
+
+	using CoffSymbolRange = EntryRange <
+		ImageBase, read_proxy_object<CoffSymbolFacade<ImageBase>, runtime_param<1>>,
+		coff_symbol_advance_pointer_policy,
+		bounded_distance_stop_iteration_policy<runtime_param<0>>,
+		std::size_t, Offset
+	>;
+
 	using RuntimeFunctionRange = EntryRange <
 		ImageBase, read_pointed_value<read_proxy_object<RuntimeFunctionFacade<ImageBase>>>,
 		fixed_distance_advance_pointer_policy<constexpr_<sizeof(RuntimeFunction)>>,
@@ -101,15 +140,27 @@ public:
 	SectionHeaderRange section_headers() const;
 	BaseRelocationRange base_relocations() const;
 	DebugDirectoryRange debug_directories() const;
+	CertificateRange certificates() const;
+	CoffSymbolRange coff_symbols() const;
 	RuntimeFunctionRange exception_entries() const;
 	ImportDescriptorRange import_descriptors() const;
+	DelayImportDescriptorRange delay_import_descriptors() const;
+	BoundImportDescriptorRange bound_import_descriptors() const;
 
 	std::optional<Pointed<std::string>> copyright_str() const;
 
+	std::optional<RichHeaderFacade<ImageBase>> rich_header() const;
+	std::optional<ClrHeaderFacade<ImageBase>> clr_header() const;
 	std::optional<ResourceDirectoryFacade<ImageBase>> resource_directory() const;
 	std::optional<Pointed<TlsDirectoryFacade<XX, ImageBase>>> tls_directory() const;
+	std::optional<Pointed<LoadConfigDirectoryFacade<XX, ImageBase>>> load_config_directory() const;
 	std::optional<Pointed<ExportDirectoryFacade<ImageBase>>> export_directory() const;
 
+	std::optional<Pointed<RuntimeFunctionFacade<ImageBase>>> find_function(VirtualOffset rva) const;
+
+	template <class InputIt, class OutputIt>
+	OutputIt find_functions(InputIt first, InputIt last, OutputIt result) const;
+
 	std::optional<FileOffset> to_file_offset(VirtualOffset rva) const;
 	std::optional<VirtualOffset> to_virtual_offset(FileOffset offs) const;
 
@@ -124,7 +175,17 @@ public:
 	template <class DataOffset>
 	std::pair<std::size_t, Offset> read(DataOffset offset, std::size_t size, void * into_buffer) const;
 
+	const buffer_type & buffer() const;
+
+	std::optional<std::string_view> view() const;
+
+	template <class DataOffset>
+	std::optional<std::string_view> view(DataOffset offset, std::size_t size) const;
+
 private:
+	std::pair<Offset, std::size_t> runtime_function_table() const;
+	Pointed<RuntimeFunctionFacade<ImageBase>> runtime_function_at(Offset table_offset, std::size_t index) const;
+
 	void do_read_from_buffer(std::size_t offset, std::size_t size, void * into_buffer) const;
 
 	buffer_type _image_data;
@@ -341,6 +402,32 @@ auto ImageBase<XX, Offset, MemoryBuffer>::debug_directories() const -> DebugDire
 	return DebugDirectoryRange(*this, *data_offset, data_dir->size);
 }
 
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::certificates() const -> CertificateRange
+{
+	const std::optional<Pointed<DataDirectory>> data_dir = data_directory(DIRECTORY_ENTRY_SECURITY);
+	if (!data_dir || data_dir->size == 0) return CertificateRange(*this, Offset(0), 0);
+
+	const std::optional<Offset> data_offset = to_image_offset(*this, FileOffset(data_dir->virtual_address));
+	if (!data_offset) return CertificateRange(*this, Offset(0), 0);
+
+	return CertificateRange(*this, *data_offset, data_dir->size);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::coff_symbols() const -> CoffSymbolRange
+{
+	const Pointed<FileHeader> file_header = this->file_header();
+	if (file_header.pointer_to_symbol_table == 0 || file_header.number_of_symbols == 0)
+		return CoffSymbolRange(*this, Offset(0), 0, Offset(0));
+
+	const std::optional<Offset> table_offset = to_image_offset(*this, FileOffset(file_header.pointer_to_symbol_table));
+	if (!table_offset) return CoffSymbolRange(*this, Offset(0), 0, Offset(0));
+
+	const std::size_t table_size = file_header.number_of_symbols * SIZEOF_SYMBOL;
+	return CoffSymbolRange(*this, *table_offset, table_size, *table_offset + table_size);
+}
+
 template <unsigned int XX, class Offset, class MemoryBuffer>
 auto ImageBase<XX, Offset, MemoryBuffer>::exception_entries() const -> RuntimeFunctionRange
 {
@@ -365,6 +452,51 @@ auto ImageBase<XX, Offset, MemoryBuffer>::import_descriptors() const -> ImportDe
 	return ImportDescriptorRange(*this, *data_offset);
 }
 
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::delay_import_descriptors() const -> DelayImportDescriptorRange
+{
+	const std::optional<Pointed<DataDirectory>> data_dir = data_directory(DIRECTORY_ENTRY_DELAYIMPORT);
+	if (!data_dir || data_dir->size < sizeof(DelayLoadDescriptor)) return DelayImportDescriptorRange(*this, Offset(0), 0);
+
+	const std::optional<Offset> data_offset = to_image_offset(*this, VirtualOffset(data_dir->virtual_address));
+	if (!data_offset) return DelayImportDescriptorRange(*this, Offset(0), 0);
+
+	return DelayImportDescriptorRange(*this, *data_offset, data_dir->size);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::bound_import_descriptors() const -> BoundImportDescriptorRange
+{
+	const std::optional<Pointed<DataDirectory>> data_dir = data_directory(DIRECTORY_ENTRY_BOUNDIMPORT);
+	if (!data_dir || data_dir->size < sizeof(BoundImportDescriptor)) return BoundImportDescriptorRange(*this, Offset(0), 0, Offset(0));
+
+	const std::optional<Offset> data_offset = to_image_offset(*this, VirtualOffset(data_dir->virtual_address));
+	if (!data_offset) return BoundImportDescriptorRange(*this, Offset(0), 0, Offset(0));
+
+	return BoundImportDescriptorRange(*this, *data_offset, data_dir->size, *data_offset);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::rich_header() const -> std::optional<RichHeaderFacade<ImageBase>>
+{
+	const std::optional<Offset> header_offset = find_rich_header(*this, dos_header().e_lfanew);
+	if (!header_offset) return std::nullopt;
+
+	return RichHeaderFacade<ImageBase>(*this, *header_offset);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::clr_header() const -> std::optional<ClrHeaderFacade<ImageBase>>
+{
+	const std::optional<Pointed<DataDirectory>> data_dir = data_directory(DIRECTORY_ENTRY_COMDESCRIPTOR);
+	if (!data_dir || data_dir->size < sizeof(Cor20Header)) return std::nullopt;
+
+	const std::optional<Offset> data_offset = to_image_offset(*this, VirtualOffset(data_dir->virtual_address));
+	if (!data_offset) return std::nullopt;
+
+	return ClrHeaderFacade<ImageBase>(*this, *data_offset);
+}
+
 template <unsigned int XX, class Offset, class MemoryBuffer>
 auto ImageBase<XX, Offset, MemoryBuffer>::resource_directory() const -> std::optional<ResourceDirectoryFacade<ImageBase>>
 {
@@ -390,6 +522,19 @@ auto ImageBase<XX, Offset, MemoryBuffer>::tls_directory() const -> std::optional
 	return PointedValue(*data_offset, std::move(tls_directory));
 }
 
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::load_config_directory() const -> std::optional<Pointed<LoadConfigDirectoryFacade<XX, ImageBase>>>
+{
+	const std::optional<Pointed<DataDirectory>> data_dir = data_directory(DIRECTORY_ENTRY_LOADCONFIG);
+	if (!data_dir || data_dir->size < sizeof(DWORD)) return std::nullopt;
+
+	const std::optional<Offset> data_offset = to_image_offset(*this, VirtualOffset(data_dir->virtual_address));
+	if (!data_offset) return std::nullopt;
+
+	LoadConfigDirectoryFacade<XX, ImageBase> load_config { *this, *data_offset };
+	return PointedValue(*data_offset, std::move(load_config));
+}
+
 template <unsigned int XX, class Offset, class MemoryBuffer>
 auto ImageBase<XX, Offset, MemoryBuffer>::export_directory() const -> std::optional<Pointed<ExportDirectoryFacade<ImageBase>>>
 {
@@ -404,6 +549,53 @@ auto ImageBase<XX, Offset, MemoryBuffer>::export_directory() const -> std::optio
 	return PointedValue(*data_offset, std::move(export_dir));
 }
 
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::find_function(VirtualOffset rva) const -> std::optional<Pointed<RuntimeFunctionFacade<ImageBase>>>
+{
+	const auto [table_offset, number_of_functions] = runtime_function_table();
+
+	std::size_t first = 0, count = number_of_functions;
+	while (count > 0) {
+		const std::size_t step = count / 2;
+		const RuntimeFunction runtime_function = read_runtime_function_from_image(*this, table_offset + (first + step) * sizeof(RuntimeFunction));
+		if (VirtualOffset(runtime_function.begin_address) <= rva) {
+			first += step + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
+	}
+
+	if (first == 0) return std::nullopt;
+
+	auto runtime_function = runtime_function_at(table_offset, first - 1);
+	if (rva < VirtualOffset(runtime_function.end_address)) return runtime_function;
+	return std::nullopt;
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class InputIt, class OutputIt>
+OutputIt ImageBase<XX, Offset, MemoryBuffer>::find_functions(InputIt first, InputIt last, OutputIt result) const
+{
+	const auto [table_offset, number_of_functions] = runtime_function_table();
+
+	std::size_t index = 0;
+	std::optional<Pointed<RuntimeFunctionFacade<ImageBase>>> runtime_function;
+	for (; first != last; ++first) {
+		const VirtualOffset rva { *first };
+		while (index < number_of_functions && (!runtime_function || VirtualOffset(runtime_function->end_address) <= rva))
+			runtime_function = runtime_function_at(table_offset, index++);
+
+		if (runtime_function && VirtualOffset(runtime_function->begin_address) <= rva
+		                     && rva < VirtualOffset(runtime_function->end_address)) {
+			*result++ = runtime_function;
+		} else {
+			*result++ = std::nullopt;
+		}
+	}
+
+	return result;
+}
+
 template <unsigned int XX, class Offset, class MemoryBuffer>
 auto ImageBase<XX, Offset, MemoryBuffer>::copyright_str() const -> std::optional<Pointed<std::string>>
 {
@@ -420,7 +612,8 @@ auto ImageBase<XX, Offset, MemoryBuffer>::data_directory(DirectoryEntryIndex ind
 	if (index >= NUMBEROF_DIRECTORY_ENTRIES) return std::nullopt;
 
 	const DataDirectory & data_dir = opt_header.data_directory[index];
-	const Offset datadir_offset = opt_header.offset() + offsetof(OptionalHeader<XX>, data_directory[index]);
+	const Offset datadir_offset = opt_header.offset() + offsetof(OptionalHeader<XX>, data_directory)
+	                                                  + index * sizeof(DataDirectory);
 	if (data_dir.virtual_address == 0 || data_dir.size == 0) return std::nullopt;
 
 	return PointedValue(datadir_offset, data_dir);
@@ -501,6 +694,54 @@ std::pair<std::size_t, Offset> ImageBase<XX, Offset, MemoryBuffer>::read(DataOff
 	return std::pair(bytes_read, *data_offset);
 }
 
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::buffer() const -> const buffer_type &
+{
+	return _image_data;
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::optional<std::string_view> ImageBase<XX, Offset, MemoryBuffer>::view() const
+{
+	if constexpr (has_buffer_view<MemoryBuffer>::value) {
+		return MemoryBuffer::view(_image_data);
+	} else {
+		return std::nullopt;
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class DataOffset>
+std::optional<std::string_view> ImageBase<XX, Offset, MemoryBuffer>::view(DataOffset offset, std::size_t size) const
+{
+	const std::optional<std::string_view> image_view = view();
+	if (!image_view) return std::nullopt;
+
+	const std::optional<Offset> data_offset = to_image_offset(*this, offset);
+	if (!data_offset || data_offset->value() < 0 || static_cast<std::size_t>(data_offset->value()) > image_view->size())
+		return std::nullopt;
+
+	return image_view->substr(static_cast<std::size_t>(data_offset->value()), size);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::pair<Offset, std::size_t> ImageBase<XX, Offset, MemoryBuffer>::runtime_function_table() const
+{
+	const std::optional<Pointed<DataDirectory>> data_dir = data_directory(DIRECTORY_ENTRY_EXCEPTION);
+	if (!data_dir) return std::pair(Offset(0), 0);
+
+	const std::optional<Offset> data_offset = to_image_offset(*this, VirtualOffset(data_dir->virtual_address));
+	if (!data_offset) return std::pair(Offset(0), 0);
+
+	return std::pair(*data_offset, data_dir->size / sizeof(RuntimeFunction));
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+auto ImageBase<XX, Offset, MemoryBuffer>::runtime_function_at(Offset table_offset, std::size_t index) const -> Pointed<RuntimeFunctionFacade<ImageBase>>
+{
+	const Offset function_offset = table_offset + index * sizeof(RuntimeFunction);
+	return PointedValue(function_offset, RuntimeFunctionFacade<ImageBase>(*this, function_offset));
+}
+
 template <unsigned int XX, class Offset, class MemoryBuffer>
 void ImageBase<XX, Offset, MemoryBuffer>::do_read_from_buffer(std::size_t offset, std::size_t size, void * into_buffer) const
 {
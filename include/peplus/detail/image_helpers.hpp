@@ -3,15 +3,29 @@
 
 #include <peplus/headers.hpp>
 #include <peplus/pointed_value.hpp>
+#include <peplus/detail/image_offset.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <boost/endian/conversion.hpp>
 
 namespace peplus::detail {
 
+const std::size_t MEMORY_PAGE_SIZE = 0x1000;
+
 template <auto X>
 struct constexpr_
 {
@@ -25,6 +39,28 @@ struct runtime_param
 	static constexpr std::size_t index = I;
 };
 
+template <class MemoryBuffer, class = void>
+struct has_buffer_view : std::false_type {};
+
+template <class MemoryBuffer>
+struct has_buffer_view<MemoryBuffer, std::void_t<decltype(
+	MemoryBuffer::view(std::declval<const typename MemoryBuffer::value_type &>()))>> : std::true_type {};
+
+template <typename T>
+T load_le_value(const char * from)
+{
+	T value;
+	std::memcpy(&value, from, sizeof(T));
+	return boost::endian::little_to_native(value);
+}
+
+template <typename T>
+void store_le_value(char * into, T value)
+{
+	boost::endian::native_to_little_inplace(value);
+	std::memcpy(into, &value, sizeof(T));
+}
+
 template <class Image, class Offset>
 void image_do_read(const Image & image, Offset offset, std::size_t size, void * into_buffer)
 {
@@ -32,6 +68,73 @@ void image_do_read(const Image & image, Offset offset, std::size_t size, void *
 	if (bytes_read < size) throw std::runtime_error("Malformed image");
 }
 
+inline char to_lower_ascii(char value)
+{
+	return value >= 'A' && value <= 'Z' ? static_cast<char>(value - 'A' + 'a') : value;
+}
+
+inline bool equals_ignore_case(std::string_view lhs, std::string_view rhs)
+{
+	return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [] (char lhs_char, char rhs_char) {
+		return to_lower_ascii(lhs_char) == to_lower_ascii(rhs_char);
+	});
+}
+
+const std::size_t SECTION_READ_CHUNK_SIZE = 0x10000;
+
+inline std::string_view section_name(const SectionHeader & section_header)
+{
+	const char * const name = reinterpret_cast<const char *>(section_header.name);
+	return std::string_view(name, static_cast<std::size_t>(std::find(name, name + SIZEOF_SHORT_NAME, '\0') - name));
+}
+
+template <class Image>
+std::pair<std::size_t, std::size_t> section_extent(const Image &, const SectionHeader & section_header)
+{
+	if constexpr (std::is_same_v<typename Image::offset_type, FileOffset>)
+		return { section_header.pointer_to_raw_data, section_header.size_of_raw_data };
+	else
+		return { section_header.virtual_address, section_header.virtual_size != 0 ? section_header.virtual_size
+		                                                                          : section_header.size_of_raw_data };
+}
+
+template <class Image>
+std::string_view section_data(const Image & image, const SectionHeader & section_header, std::string & buffer)
+{
+	using Offset = typename Image::offset_type;
+	const auto [section_offset, section_size] = section_extent(image, section_header);
+
+	if (const std::optional<std::string_view> image_view = image.view()) {
+		if (section_offset >= image_view->size()) return std::string_view();
+		return image_view->substr(section_offset, section_size);
+	}
+
+	buffer.clear();
+	while (buffer.size() < section_size) {
+		const std::size_t buffer_size = buffer.size();
+		const std::size_t bytes_wanted = std::min(SECTION_READ_CHUNK_SIZE, section_size - buffer_size);
+		buffer.resize(buffer_size + bytes_wanted);
+		const std::size_t bytes_read = image.read(Offset(section_offset + buffer_size), bytes_wanted, buffer.data() + buffer_size).first;
+		buffer.resize(buffer_size + bytes_read);
+		if (bytes_read < bytes_wanted) break;
+	}
+	return buffer;
+}
+
+struct DigestRange
+{
+	static constexpr std::size_t TO_END = std::numeric_limits<std::size_t>::max();
+
+	std::size_t offset;
+	std::size_t size;
+};
+
+inline void append_digest_range(std::vector<DigestRange> & digest_ranges, std::size_t begin, std::size_t end)
+{
+	if (end > begin)
+		digest_ranges.push_back(DigestRange { begin, end == DigestRange::TO_END ? DigestRange::TO_END : end - begin });
+}
+
 template <typename T>
 struct read_trivial_le_value
 {
@@ -135,25 +238,6 @@ using read_pointed_trivial_le_value_as = read_pointed_value <
 	read_value_as<R, read_trivial_le_value<T>>
 >;
 
-struct read_debug_directory
-{
-	template <class Image, class Offset, class RtParams>
-	static DebugDirectory read_value(const Image & image, Offset offset, const RtParams &)
-	{
-		DebugDirectory debug_directory;
-		image_do_read(image, offset, sizeof(DebugDirectory), &debug_directory);
-		boost::endian::little_to_native_inplace(debug_directory.characteristics    );
-		boost::endian::little_to_native_inplace(debug_directory.time_date_stamp    );
-		boost::endian::little_to_native_inplace(debug_directory.major_version      );
-		boost::endian::little_to_native_inplace(debug_directory.minor_version      );
-		boost::endian::little_to_native_inplace(debug_directory.type               );
-		boost::endian::little_to_native_inplace(debug_directory.size_of_data       );
-		boost::endian::little_to_native_inplace(debug_directory.address_of_raw_data);
-		boost::endian::little_to_native_inplace(debug_directory.pointer_to_raw_data);
-		return debug_directory;
-	}
-};
-
 template <typename Distance>
 struct fixed_distance_advance_pointer_policy;
 
@@ -210,6 +294,19 @@ struct fixed_distance_stop_iteration_policy<runtime_param<I>>
 	}
 };
 
+template <typename Distance>
+struct bounded_distance_stop_iteration_policy;
+
+template <std::size_t I>
+struct bounded_distance_stop_iteration_policy<runtime_param<I>>
+{
+	template <class Iterator, class Ptrdiff, class RtParams>
+	static bool is_end_iterator(Iterator, Ptrdiff pd, RtParams rt_params)
+	{
+		return pd >= std::get<I>(rt_params);
+	}
+};
+
 template <class... StopIterationPolicies>
 struct either_stop_iteration_policy
 {
@@ -238,10 +335,23 @@ struct base_relocation_advance_pointer_policy
 	template <class Iterator, class Pointer, class RtParams>
 	static void advance_pointer(Iterator iter, Pointer & p, RtParams)
 	{
+		if (iter->size_of_block < offsetof(BaseRelocation, type_offset))
+			throw std::runtime_error("Invalid base relocation block");
 		p += iter->size_of_block;
 	}
 };
 
+struct certificate_advance_pointer_policy
+{
+	template <class Iterator, class Pointer, class RtParams>
+	static void advance_pointer(Iterator iter, Pointer & p, RtParams)
+	{
+		if (iter->length < offsetof(WinCertificate, certificate))
+			throw std::runtime_error("Invalid certificate entry");
+		p += (static_cast<std::size_t>(iter->length) + 7) & ~std::size_t(7);
+	}
+};
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+#ifndef PEPLUS_DETAIL_PARALLELFOR_HPP_
+#define PEPLUS_DETAIL_PARALLELFOR_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace peplus::detail {
+
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned int thread_count);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool & operator=(const ThreadPool &) = delete;
+
+	static ThreadPool & shared();
+
+	unsigned int size() const;
+	void submit(std::function<void()> job);
+
+private:
+	void run_jobs();
+
+	std::mutex                        _mutex;
+	std::condition_variable           _job_available;
+	std::deque<std::function<void()>> _jobs;
+	bool                              _stopping = false;
+	std::vector<std::thread>          _threads;
+};
+
+struct ParallelForState
+{
+	explicit ParallelForState(std::size_t task_count);
+
+	std::size_t              task_count;
+	std::atomic<std::size_t> next_task { 0 };
+	std::mutex               mutex;
+	std::condition_variable  helpers_done;
+	unsigned int             active_helpers = 0;
+	bool                     closed = false;
+	std::exception_ptr       error;
+};
+
+inline ThreadPool::ThreadPool(unsigned int thread_count)
+{
+	for (unsigned int i = 0; i < thread_count; ++i)
+		_threads.emplace_back(&ThreadPool::run_jobs, this);
+}
+
+inline ThreadPool::~ThreadPool()
+{
+	{
+		const std::lock_guard lock { _mutex };
+		_stopping = true;
+	}
+	_job_available.notify_all();
+	for (std::thread & thread : _threads)
+		thread.join();
+}
+
+inline ThreadPool & ThreadPool::shared()
+{
+	static ThreadPool thread_pool { std::max(1u, std::thread::hardware_concurrency()) };
+	return thread_pool;
+}
+
+inline unsigned int ThreadPool::size() const
+{
+	return static_cast<unsigned int>(_threads.size());
+}
+
+inline void ThreadPool::submit(std::function<void()> job)
+{
+	{
+		const std::lock_guard lock { _mutex };
+		_jobs.push_back(std::move(job));
+	}
+	_job_available.notify_one();
+}
+
+inline void ThreadPool::run_jobs()
+{
+	for (;;) {
+		std::function<void()> job;
+		{
+			std::unique_lock lock { _mutex };
+			_job_available.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+			if (_jobs.empty()) return;
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+		job();
+	}
+}
+
+inline ParallelForState::ParallelForState(std::size_t task_count)
+	: task_count { task_count } {}
+
+template <class Fn>
+void run_parallel_tasks(ParallelForState & state, Fn & fn)
+{
+	try {
+		for (std::size_t task = state.next_task++; task < state.task_count; task = state.next_task++)
+			fn(task);
+	} catch (...) {
+		state.next_task = state.task_count;
+		const std::lock_guard lock { state.mutex };
+		if (!state.error) state.error = std::current_exception();
+	}
+}
+
+template <class Fn>
+void parallel_for(std::size_t task_count, unsigned int thread_count, Fn && fn)
+{
+	const std::size_t worker_count = std::max<std::size_t>(1, std::min<std::size_t>(thread_count, task_count));
+	if (worker_count == 1) {
+		for (std::size_t task = 0; task < task_count; ++task)
+			fn(task);
+		return;
+	}
+
+	ThreadPool & thread_pool = ThreadPool::shared();
+	const auto state = std::make_shared<ParallelForState>(task_count);
+	const std::size_t helper_count = std::min<std::size_t>(worker_count - 1, thread_pool.size());
+	for (std::size_t i = 0; i < helper_count; ++i) {
+		thread_pool.submit([state, &fn] {
+			{
+				const std::lock_guard lock { state->mutex };
+				if (state->closed) return;
+				++state->active_helpers;
+			}
+			run_parallel_tasks(*state, fn);
+			{
+				const std::lock_guard lock { state->mutex };
+				--state->active_helpers;
+			}
+			state->helpers_done.notify_all();
+		});
+	}
+	run_parallel_tasks(*state, fn);
+
+	std::unique_lock lock { state->mutex };
+	state->closed = true;
+	state->helpers_done.wait(lock, [&state] { return state->active_helpers == 0; });
+	if (state->error) std::rethrow_exception(state->error);
+}
+
+}
+
+#endif
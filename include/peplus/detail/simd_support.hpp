@@ -0,0 +1,44 @@
+#ifndef PEPLUS_DETAIL_SIMDSUPPORT_HPP_
+#define PEPLUS_DETAIL_SIMDSUPPORT_HPP_
+
+#if !defined(PEPLUS_NO_SIMD)
+
+#if defined(__AVX2__)
+#define PEPLUS_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__)
+#define PEPLUS_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <cstdint>
+
+namespace peplus::detail {
+
+inline unsigned int count_trailing_zeros(std::uint32_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return static_cast<unsigned int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+	return static_cast<unsigned int>(__builtin_ctz(value));
+#else
+	unsigned int count = 0;
+	for (; (value & 1) == 0; value >>= 1)
+		++count;
+	return count;
+#endif
+}
+
+}
+
+#endif
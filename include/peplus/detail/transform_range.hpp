@@ -22,6 +22,8 @@ public:
 		Fn, typename std::iterator_traits<range_iterator>::value_type
 	>;
 
+	class end_iterator;
+
 	class iterator : public boost::iterator_facade < iterator, const value_type,
 	                                                 boost::single_pass_traversal_tag >
 	{
@@ -0,0 +1,100 @@
+#ifndef PEPLUS_GUARDCFTABLE_HPP_
+#define PEPLUS_GUARDCFTABLE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+#include <peplus/detail/image_base.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+namespace peplus {
+
+class GuardCFTable
+{
+public:
+	GuardCFTable() = default;
+
+	template <unsigned int XX, class Offset, class MemoryBuffer>
+	explicit GuardCFTable(const detail::ImageBase<XX, Offset, MemoryBuffer> & image);
+
+	bool empty() const;
+	std::size_t size() const;
+	const std::vector<DWORD> & targets() const;
+
+	bool contains(VirtualOffset rva) const;
+
+	template <class InputIt, class OutputIt>
+	OutputIt contains(InputIt first, InputIt last, OutputIt result) const;
+
+private:
+	std::vector<DWORD> _targets;
+};
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+GuardCFTable::GuardCFTable(const detail::ImageBase<XX, Offset, MemoryBuffer> & image)
+{
+	const auto load_config = image.load_config_directory();
+	if (!load_config || (load_config->guard_flags & GUARD_CF_FUNCTION_TABLE_PRESENT) == 0) return;
+
+	_targets.resize(load_config->guard_cf_function_table_count());
+	_targets.resize(load_config->read_guard_cf_functions(_targets.data()));
+	if (!std::is_sorted(_targets.begin(), _targets.end()))
+		std::sort(_targets.begin(), _targets.end());
+	_targets.erase(std::unique(_targets.begin(), _targets.end()), _targets.end());
+}
+
+inline bool GuardCFTable::empty() const
+{
+	return _targets.empty();
+}
+
+inline std::size_t GuardCFTable::size() const
+{
+	return _targets.size();
+}
+
+inline const std::vector<DWORD> & GuardCFTable::targets() const
+{
+	return _targets;
+}
+
+inline bool GuardCFTable::contains(VirtualOffset rva) const
+{
+	if (rva.value() < 0) return false;
+	return std::binary_search(_targets.begin(), _targets.end(), static_cast<DWORD>(rva.value()));
+}
+
+template <class InputIt, class OutputIt>
+OutputIt GuardCFTable::contains(InputIt first, InputIt last, OutputIt result) const
+{
+	auto target = _targets.begin();
+	DWORD previous_rva_value = 0;
+	for (; first != last; ++first, ++result) {
+		const VirtualOffset rva = *first;
+		if (rva.value() < 0) {
+			*result = false;
+			continue;
+		}
+
+		const DWORD rva_value = static_cast<DWORD>(rva.value());
+		if (rva_value < previous_rva_value) target = _targets.begin();
+		previous_rva_value = rva_value;
+
+		std::ptrdiff_t step = 1;
+		while (step < _targets.end() - target && target[step] < rva_value) {
+			target += step;
+			step *= 2;
+		}
+		target = std::lower_bound(target, target + std::min(step, _targets.end() - target), rva_value);
+		*result = target != _targets.end() && *target == rva_value;
+	}
+	return result;
+}
+
+}
+
+#endif
@@ -68,6 +68,15 @@ struct DosHeader
 	DWORD e_lfanew;
 };
 
+const DWORD RICH_SIGNATURE = 0x68636952;
+const DWORD DANS_SIGNATURE = 0x536e6144;
+
+struct RichHeaderEntry
+{
+	DWORD comp_id;
+	DWORD count;
+};
+
 enum FileMachine
 {
 	FILE_MACHINE_I386  = 0x014c,
@@ -325,6 +334,59 @@ struct SectionHeader
 	DWORD     characteristics;
 };
 
+const std::size_t SIZEOF_SYMBOL = 18;
+
+enum SymbolSectionNumber : std::int16_t
+{
+	SYM_UNDEFINED = 0,
+	SYM_ABSOLUTE  = -1,
+	SYM_DEBUG     = -2,
+};
+
+enum SymbolStorageClass : BYTE
+{
+	SYM_CLASS_END_OF_FUNCTION  = 0xff,
+	SYM_CLASS_NULL             = 0,
+	SYM_CLASS_AUTOMATIC        = 1,
+	SYM_CLASS_EXTERNAL         = 2,
+	SYM_CLASS_STATIC           = 3,
+	SYM_CLASS_REGISTER         = 4,
+	SYM_CLASS_EXTERNAL_DEF     = 5,
+	SYM_CLASS_LABEL            = 6,
+	SYM_CLASS_UNDEFINED_LABEL  = 7,
+	SYM_CLASS_MEMBER_OF_STRUCT = 8,
+	SYM_CLASS_ARGUMENT         = 9,
+	SYM_CLASS_STRUCT_TAG       = 10,
+	SYM_CLASS_MEMBER_OF_UNION  = 11,
+	SYM_CLASS_UNION_TAG        = 12,
+	SYM_CLASS_TYPE_DEFINITION  = 13,
+	SYM_CLASS_UNDEFINED_STATIC = 14,
+	SYM_CLASS_ENUM_TAG         = 15,
+	SYM_CLASS_MEMBER_OF_ENUM   = 16,
+	SYM_CLASS_REGISTER_PARAM   = 17,
+	SYM_CLASS_BIT_FIELD        = 18,
+	SYM_CLASS_BLOCK            = 100,
+	SYM_CLASS_FUNCTION         = 101,
+	SYM_CLASS_END_OF_STRUCT    = 102,
+	SYM_CLASS_FILE             = 103,
+	SYM_CLASS_SECTION          = 104,
+	SYM_CLASS_WEAK_EXTERNAL    = 105,
+	SYM_CLASS_CLR_TOKEN        = 107,
+};
+
+const WORD SYM_DTYPE_FUNCTION = 2;
+const unsigned int SYM_DTYPE_SHIFT = 4;
+
+struct CoffSymbol
+{
+	BYTE         short_name[SIZEOF_SHORT_NAME];
+	DWORD        value;
+	std::int16_t section_number;
+	WORD         type;
+	BYTE         storage_class;
+	BYTE         number_of_aux_symbols;
+};
+
 struct ExportDirectory
 {
 	DWORD characteristics;
@@ -400,6 +462,34 @@ struct ImportByName
 	char name[1];
 };
 
+const DWORD DELAYLOAD_RVA_BASED = 0x1;
+
+struct DelayLoadDescriptor
+{
+	DWORD attributes;
+	DWORD dll_name_rva;
+	DWORD module_handle_rva;
+	DWORD import_address_table_rva;
+	DWORD import_name_table_rva;
+	DWORD bound_import_address_table_rva;
+	DWORD unload_information_table_rva;
+	DWORD time_date_stamp;
+};
+
+struct BoundImportDescriptor
+{
+	DWORD time_date_stamp;
+	WORD  offset_module_name;
+	WORD  number_of_module_forwarder_refs;
+};
+
+struct BoundForwarderRef
+{
+	DWORD time_date_stamp;
+	WORD  offset_module_name;
+	WORD  reserved;
+};
+
 enum RelocationType
 {
 	REL_BASED_ABSOLUTE       = 0,
@@ -500,6 +590,68 @@ struct DebugDirectory
 	DWORD pointer_to_raw_data;
 };
 
+enum DebugType : DWORD
+{
+	DEBUG_TYPE_UNKNOWN               = 0,
+	DEBUG_TYPE_COFF                  = 1,
+	DEBUG_TYPE_CODEVIEW              = 2,
+	DEBUG_TYPE_FPO                   = 3,
+	DEBUG_TYPE_MISC                  = 4,
+	DEBUG_TYPE_EXCEPTION             = 5,
+	DEBUG_TYPE_FIXUP                 = 6,
+	DEBUG_TYPE_OMAP_TO_SRC           = 7,
+	DEBUG_TYPE_OMAP_FROM_SRC         = 8,
+	DEBUG_TYPE_BORLAND               = 9,
+	DEBUG_TYPE_RESERVED10            = 10,
+	DEBUG_TYPE_CLSID                 = 11,
+	DEBUG_TYPE_VC_FEATURE            = 12,
+	DEBUG_TYPE_POGO                  = 13,
+	DEBUG_TYPE_ILTCG                 = 14,
+	DEBUG_TYPE_MPX                   = 15,
+	DEBUG_TYPE_REPRO                 = 16,
+	DEBUG_TYPE_EX_DLLCHARACTERISTICS = 20,
+};
+
+struct Guid
+{
+	DWORD data1;
+	WORD  data2;
+	WORD  data3;
+	BYTE  data4[8];
+};
+
+const DWORD CV_SIGNATURE_NB10 = 0x3031424e;
+const DWORD CV_SIGNATURE_RSDS = 0x53445352;
+
+struct CvInfoPdb20
+{
+	DWORD cv_signature;
+	DWORD offset;
+	DWORD signature;
+	DWORD age;
+	char  pdb_file_name[1];
+};
+
+struct CvInfoPdb70
+{
+	DWORD cv_signature;
+	Guid  signature;
+	DWORD age;
+	char  pdb_file_name[1];
+};
+
+const DWORD POGO_SIGNATURE_LTCG = 0x4c544347;
+const DWORD POGO_SIGNATURE_PGI  = 0x50474900;
+const DWORD POGO_SIGNATURE_PGO  = 0x50474f00;
+const DWORD POGO_SIGNATURE_PGU  = 0x50475500;
+
+struct PogoEntry
+{
+	DWORD start_rva;
+	DWORD size;
+	char  name[1];
+};
+
 template <unsigned int XX>
 struct TlsDirectory
 {
@@ -533,15 +685,19 @@ enum {
 };
 
 enum {
-	UWOP_PUSH_NONVOL,
-	UWOP_ALLOC_LARGE,
-	UWOP_ALLOC_SMALL,
-	UWOP_SET_FPREG,
-	UWOP_SAVE_NONVOL,
-	UWOP_SAVE_NONVOL_FAR,
-	UWOP_SAVE_XMM128,
-	UWOP_SAVE_XMM128_FAR,
-	UWOP_PUSH_MACHFRAME,
+	UWOP_PUSH_NONVOL     = 0,
+	UWOP_ALLOC_LARGE     = 1,
+	UWOP_ALLOC_SMALL     = 2,
+	UWOP_SET_FPREG       = 3,
+	UWOP_SAVE_NONVOL     = 4,
+	UWOP_SAVE_NONVOL_FAR = 5,
+	UWOP_SAVE_XMM        = 6,
+	UWOP_EPILOG          = 6,
+	UWOP_SAVE_XMM_FAR    = 7,
+	UWOP_SPARE_CODE      = 7,
+	UWOP_SAVE_XMM128     = 8,
+	UWOP_SAVE_XMM128_FAR = 9,
+	UWOP_PUSH_MACHFRAME  = 10,
 };
 
 struct UnwindCode
@@ -573,6 +729,345 @@ struct ScopeTable
 	} scope_record[1];
 };
 
+struct LoadConfigCodeIntegrity
+{
+	WORD  flags;
+	WORD  catalog;
+	DWORD catalog_offset;
+	DWORD reserved;
+};
+
+enum GuardFlags : DWORD
+{
+	GUARD_CF_INSTRUMENTED                    = 0x00000100,
+	GUARD_CFW_INSTRUMENTED                   = 0x00000200,
+	GUARD_CF_FUNCTION_TABLE_PRESENT          = 0x00000400,
+	GUARD_SECURITY_COOKIE_UNUSED             = 0x00000800,
+	GUARD_PROTECT_DELAYLOAD_IAT              = 0x00001000,
+	GUARD_DELAYLOAD_IAT_IN_ITS_OWN_SECTION   = 0x00002000,
+	GUARD_CF_EXPORT_SUPPRESSION_INFO_PRESENT = 0x00004000,
+	GUARD_CF_ENABLE_EXPORT_SUPPRESSION       = 0x00008000,
+	GUARD_CF_LONGJUMP_TABLE_PRESENT          = 0x00010000,
+	GUARD_RF_INSTRUMENTED                    = 0x00020000,
+	GUARD_RF_ENABLE                          = 0x00040000,
+	GUARD_RF_STRICT                          = 0x00080000,
+	GUARD_RETPOLINE_PRESENT                  = 0x00100000,
+	GUARD_EH_CONTINUATION_TABLE_PRESENT      = 0x00400000,
+	GUARD_CF_FUNCTION_TABLE_SIZE_MASK        = 0xf0000000,
+};
+
+const unsigned int GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT = 28;
+
+template <unsigned int>
+struct LoadConfigDirectory;
+
+template <>
+struct LoadConfigDirectory<32>
+{
+	DWORD                   size;
+	DWORD                   time_date_stamp;
+	WORD                    major_version;
+	WORD                    minor_version;
+	DWORD                   global_flags_clear;
+	DWORD                   global_flags_set;
+	DWORD                   critical_section_default_timeout;
+	DWORD                   de_commit_free_block_threshold;
+	DWORD                   de_commit_total_free_threshold;
+	DWORD                   lock_prefix_table;
+	DWORD                   maximum_allocation_size;
+	DWORD                   virtual_memory_threshold;
+	DWORD                   process_heap_flags;
+	DWORD                   process_affinity_mask;
+	WORD                    csd_version;
+	WORD                    dependent_load_flags;
+	DWORD                   edit_list;
+	DWORD                   security_cookie;
+	DWORD                   se_handler_table;
+	DWORD                   se_handler_count;
+	DWORD                   guard_cf_check_function_pointer;
+	DWORD                   guard_cf_dispatch_function_pointer;
+	DWORD                   guard_cf_function_table;
+	DWORD                   guard_cf_function_count;
+	DWORD                   guard_flags;
+	LoadConfigCodeIntegrity code_integrity;
+	DWORD                   guard_address_taken_iat_entry_table;
+	DWORD                   guard_address_taken_iat_entry_count;
+	DWORD                   guard_long_jump_target_table;
+	DWORD                   guard_long_jump_target_count;
+	DWORD                   dynamic_value_reloc_table;
+	DWORD                   chpe_metadata_pointer;
+	DWORD                   guard_rf_failure_routine;
+	DWORD                   guard_rf_failure_routine_function_pointer;
+	DWORD                   dynamic_value_reloc_table_offset;
+	WORD                    dynamic_value_reloc_table_section;
+	WORD                    reserved_2;
+	DWORD                   guard_rf_verify_stack_pointer_function_pointer;
+	DWORD                   hot_patch_table_offset;
+	DWORD                   reserved_3;
+	DWORD                   enclave_configuration_pointer;
+	DWORD                   volatile_metadata_pointer;
+	DWORD                   guard_eh_continuation_table;
+	DWORD                   guard_eh_continuation_count;
+};
+
+template <>
+struct LoadConfigDirectory<64>
+{
+	DWORD                   size;
+	DWORD                   time_date_stamp;
+	WORD                    major_version;
+	WORD                    minor_version;
+	DWORD                   global_flags_clear;
+	DWORD                   global_flags_set;
+	DWORD                   critical_section_default_timeout;
+	ULONGLONG               de_commit_free_block_threshold;
+	ULONGLONG               de_commit_total_free_threshold;
+	ULONGLONG               lock_prefix_table;
+	ULONGLONG               maximum_allocation_size;
+	ULONGLONG               virtual_memory_threshold;
+	ULONGLONG               process_affinity_mask;
+	DWORD                   process_heap_flags;
+	WORD                    csd_version;
+	WORD                    dependent_load_flags;
+	ULONGLONG               edit_list;
+	ULONGLONG               security_cookie;
+	ULONGLONG               se_handler_table;
+	ULONGLONG               se_handler_count;
+	ULONGLONG               guard_cf_check_function_pointer;
+	ULONGLONG               guard_cf_dispatch_function_pointer;
+	ULONGLONG               guard_cf_function_table;
+	ULONGLONG               guard_cf_function_count;
+	DWORD                   guard_flags;
+	LoadConfigCodeIntegrity code_integrity;
+	ULONGLONG               guard_address_taken_iat_entry_table;
+	ULONGLONG               guard_address_taken_iat_entry_count;
+	ULONGLONG               guard_long_jump_target_table;
+	ULONGLONG               guard_long_jump_target_count;
+	ULONGLONG               dynamic_value_reloc_table;
+	ULONGLONG               chpe_metadata_pointer;
+	ULONGLONG               guard_rf_failure_routine;
+	ULONGLONG               guard_rf_failure_routine_function_pointer;
+	DWORD                   dynamic_value_reloc_table_offset;
+	WORD                    dynamic_value_reloc_table_section;
+	WORD                    reserved_2;
+	ULONGLONG               guard_rf_verify_stack_pointer_function_pointer;
+	DWORD                   hot_patch_table_offset;
+	DWORD                   reserved_3;
+	ULONGLONG               enclave_configuration_pointer;
+	ULONGLONG               volatile_metadata_pointer;
+	ULONGLONG               guard_eh_continuation_table;
+	ULONGLONG               guard_eh_continuation_count;
+};
+
+enum {
+	WIN_CERT_REVISION_1_0 = 0x0100,
+	WIN_CERT_REVISION_2_0 = 0x0200,
+};
+
+enum {
+	WIN_CERT_TYPE_X509             = 0x0001,
+	WIN_CERT_TYPE_PKCS_SIGNED_DATA = 0x0002,
+	WIN_CERT_TYPE_RESERVED_1       = 0x0003,
+	WIN_CERT_TYPE_TS_STACK_SIGNED  = 0x0004,
+};
+
+struct WinCertificate
+{
+	DWORD length;
+	WORD  revision;
+	WORD  certificate_type;
+	BYTE  certificate[1];
+};
+
+enum ComImageFlags : DWORD
+{
+	COMIMAGE_FLAGS_ILONLY            = 0x00000001,
+	COMIMAGE_FLAGS_32BITREQUIRED     = 0x00000002,
+	COMIMAGE_FLAGS_IL_LIBRARY        = 0x00000004,
+	COMIMAGE_FLAGS_STRONGNAMESIGNED  = 0x00000008,
+	COMIMAGE_FLAGS_NATIVE_ENTRYPOINT = 0x00000010,
+	COMIMAGE_FLAGS_TRACKDEBUGDATA    = 0x00010000,
+	COMIMAGE_FLAGS_32BITPREFERRED    = 0x00020000,
+};
+
+struct Cor20Header
+{
+	DWORD         cb;
+	WORD          major_runtime_version;
+	WORD          minor_runtime_version;
+	DataDirectory metadata;
+	DWORD         flags;
+	union {
+		DWORD     entry_point_token;
+		DWORD     entry_point_rva;
+	};
+	DataDirectory resources;
+	DataDirectory strong_name_signature;
+	DataDirectory code_manager_table;
+	DataDirectory vtable_fixups;
+	DataDirectory export_address_table_jumps;
+	DataDirectory managed_native_header;
+};
+
+const DWORD METADATA_SIGNATURE = 0x424a5342;
+
+struct MetadataRoot
+{
+	DWORD signature;
+	WORD  major_version;
+	WORD  minor_version;
+	DWORD reserved;
+	DWORD length;
+	char  version[1];
+};
+
+struct MetadataStreamHeader
+{
+	DWORD offset;
+	DWORD size;
+	char  name[1];
+};
+
+enum MetadataHeapSizes : BYTE
+{
+	METADATA_HEAP_STRING_WIDE = 0x01,
+	METADATA_HEAP_GUID_WIDE   = 0x02,
+	METADATA_HEAP_BLOB_WIDE   = 0x04,
+	METADATA_HEAP_EXTRA_DATA  = 0x40,
+};
+
+struct MetadataTablesHeader
+{
+	DWORD     reserved_0;
+	BYTE      major_version;
+	BYTE      minor_version;
+	BYTE      heap_sizes;
+	BYTE      reserved_1;
+	ULONGLONG valid;
+	ULONGLONG sorted;
+	DWORD     rows[1];
+};
+
+const std::size_t NUMBEROF_METADATA_TABLES = 0x2d;
+
+enum MetadataTable : unsigned
+{
+	METADATA_TABLE_MODULE                   = 0x00,
+	METADATA_TABLE_TYPE_REF                 = 0x01,
+	METADATA_TABLE_TYPE_DEF                 = 0x02,
+	METADATA_TABLE_FIELD_PTR                = 0x03,
+	METADATA_TABLE_FIELD                    = 0x04,
+	METADATA_TABLE_METHOD_PTR               = 0x05,
+	METADATA_TABLE_METHOD_DEF               = 0x06,
+	METADATA_TABLE_PARAM_PTR                = 0x07,
+	METADATA_TABLE_PARAM                    = 0x08,
+	METADATA_TABLE_INTERFACE_IMPL           = 0x09,
+	METADATA_TABLE_MEMBER_REF               = 0x0a,
+	METADATA_TABLE_CONSTANT                 = 0x0b,
+	METADATA_TABLE_CUSTOM_ATTRIBUTE         = 0x0c,
+	METADATA_TABLE_FIELD_MARSHAL            = 0x0d,
+	METADATA_TABLE_DECL_SECURITY            = 0x0e,
+	METADATA_TABLE_CLASS_LAYOUT             = 0x0f,
+	METADATA_TABLE_FIELD_LAYOUT             = 0x10,
+	METADATA_TABLE_STAND_ALONE_SIG          = 0x11,
+	METADATA_TABLE_EVENT_MAP                = 0x12,
+	METADATA_TABLE_EVENT_PTR                = 0x13,
+	METADATA_TABLE_EVENT                    = 0x14,
+	METADATA_TABLE_PROPERTY_MAP             = 0x15,
+	METADATA_TABLE_PROPERTY_PTR             = 0x16,
+	METADATA_TABLE_PROPERTY                 = 0x17,
+	METADATA_TABLE_METHOD_SEMANTICS         = 0x18,
+	METADATA_TABLE_METHOD_IMPL              = 0x19,
+	METADATA_TABLE_MODULE_REF               = 0x1a,
+	METADATA_TABLE_TYPE_SPEC                = 0x1b,
+	METADATA_TABLE_IMPL_MAP                 = 0x1c,
+	METADATA_TABLE_FIELD_RVA                = 0x1d,
+	METADATA_TABLE_ENC_LOG                  = 0x1e,
+	METADATA_TABLE_ENC_MAP                  = 0x1f,
+	METADATA_TABLE_ASSEMBLY                 = 0x20,
+	METADATA_TABLE_ASSEMBLY_PROCESSOR       = 0x21,
+	METADATA_TABLE_ASSEMBLY_OS              = 0x22,
+	METADATA_TABLE_ASSEMBLY_REF             = 0x23,
+	METADATA_TABLE_ASSEMBLY_REF_PROCESSOR   = 0x24,
+	METADATA_TABLE_ASSEMBLY_REF_OS          = 0x25,
+	METADATA_TABLE_FILE                     = 0x26,
+	METADATA_TABLE_EXPORTED_TYPE            = 0x27,
+	METADATA_TABLE_MANIFEST_RESOURCE        = 0x28,
+	METADATA_TABLE_NESTED_CLASS             = 0x29,
+	METADATA_TABLE_GENERIC_PARAM            = 0x2a,
+	METADATA_TABLE_METHOD_SPEC              = 0x2b,
+	METADATA_TABLE_GENERIC_PARAM_CONSTRAINT = 0x2c,
+};
+
+enum MetadataCodedIndex : unsigned
+{
+	CODED_INDEX_TYPE_DEF_OR_REF,
+	CODED_INDEX_HAS_CONSTANT,
+	CODED_INDEX_HAS_CUSTOM_ATTRIBUTE,
+	CODED_INDEX_HAS_FIELD_MARSHAL,
+	CODED_INDEX_HAS_DECL_SECURITY,
+	CODED_INDEX_MEMBER_REF_PARENT,
+	CODED_INDEX_HAS_SEMANTICS,
+	CODED_INDEX_METHOD_DEF_OR_REF,
+	CODED_INDEX_MEMBER_FORWARDED,
+	CODED_INDEX_IMPLEMENTATION,
+	CODED_INDEX_CUSTOM_ATTRIBUTE_TYPE,
+	CODED_INDEX_RESOLUTION_SCOPE,
+	CODED_INDEX_TYPE_OR_METHOD_DEF,
+};
+
+const std::size_t NUMBEROF_CODED_INDEXES = 13;
+
+enum : unsigned {
+	MODULE_GENERATION, MODULE_NAME, MODULE_MVID, MODULE_ENC_ID, MODULE_ENC_BASE_ID,
+};
+
+enum : unsigned {
+	TYPE_REF_RESOLUTION_SCOPE, TYPE_REF_NAME, TYPE_REF_NAMESPACE,
+};
+
+enum : unsigned {
+	TYPE_DEF_FLAGS, TYPE_DEF_NAME, TYPE_DEF_NAMESPACE, TYPE_DEF_EXTENDS, TYPE_DEF_FIELD_LIST, TYPE_DEF_METHOD_LIST,
+};
+
+enum : unsigned {
+	FIELD_FLAGS, FIELD_NAME, FIELD_SIGNATURE,
+};
+
+enum : unsigned {
+	METHOD_DEF_RVA, METHOD_DEF_IMPL_FLAGS, METHOD_DEF_FLAGS, METHOD_DEF_NAME, METHOD_DEF_SIGNATURE, METHOD_DEF_PARAM_LIST,
+};
+
+enum : unsigned {
+	PARAM_FLAGS, PARAM_SEQUENCE, PARAM_NAME,
+};
+
+enum : unsigned {
+	MEMBER_REF_CLASS, MEMBER_REF_NAME, MEMBER_REF_SIGNATURE,
+};
+
+enum : unsigned {
+	CUSTOM_ATTRIBUTE_PARENT, CUSTOM_ATTRIBUTE_TYPE, CUSTOM_ATTRIBUTE_VALUE,
+};
+
+enum : unsigned {
+	MODULE_REF_NAME,
+};
+
+enum : unsigned {
+	IMPL_MAP_MAPPING_FLAGS, IMPL_MAP_MEMBER_FORWARDED, IMPL_MAP_IMPORT_NAME, IMPL_MAP_IMPORT_SCOPE,
+};
+
+enum : unsigned {
+	ASSEMBLY_HASH_ALG_ID, ASSEMBLY_MAJOR_VERSION, ASSEMBLY_MINOR_VERSION, ASSEMBLY_BUILD_NUMBER,
+	ASSEMBLY_REVISION_NUMBER, ASSEMBLY_FLAGS, ASSEMBLY_PUBLIC_KEY, ASSEMBLY_NAME, ASSEMBLY_CULTURE,
+};
+
+enum : unsigned {
+	ASSEMBLY_REF_MAJOR_VERSION, ASSEMBLY_REF_MINOR_VERSION, ASSEMBLY_REF_BUILD_NUMBER, ASSEMBLY_REF_REVISION_NUMBER,
+	ASSEMBLY_REF_FLAGS, ASSEMBLY_REF_PUBLIC_KEY_OR_TOKEN, ASSEMBLY_REF_NAME, ASSEMBLY_REF_CULTURE, ASSEMBLY_REF_HASH_VALUE,
+};
+
 using NtHeaders32 = NtHeaders<32>;
 using NtHeaders64 = NtHeaders<64>;
 
@@ -585,6 +1080,9 @@ using TlsDirectory64 = TlsDirectory<64>;
 using OptionalHeader32 = OptionalHeader<32>;
 using OptionalHeader64 = OptionalHeader<64>;
 
+using LoadConfigDirectory32 = LoadConfigDirectory<32>;
+using LoadConfigDirectory64 = LoadConfigDirectory<64>;
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+#ifndef PEPLUS_IMAGECARVER_HPP_
+#define PEPLUS_IMAGECARVER_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/parallel_for.hpp>
+#include <peplus/detail/simd_support.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace peplus {
+
+struct CarvedImage
+{
+	std::size_t  offset;
+	std::size_t  size;
+	unsigned int bitness;
+	LocalBuffer  buffer;
+
+	template <unsigned int XX>
+	FileImage<XX, local_buffer> image() const;
+};
+
+namespace detail {
+
+const std::size_t CARVE_CHUNK_SIZE = 0x1000000;
+
+template <class Function>
+void find_dos_signatures(const char * data, std::size_t data_size, std::size_t begin, std::size_t end,
+                         Function && function)
+{
+	end = std::min(end, data_size > 0 ? data_size - 1 : 0);
+
+	std::size_t offset = begin;
+#ifdef PEPLUS_HAS_SSE2
+	const __m128i first_byte = _mm_set1_epi8(static_cast<char>(DOS_SIGNATURE & 0xff));
+	const __m128i second_byte = _mm_set1_epi8(static_cast<char>(DOS_SIGNATURE >> 8));
+	for (; offset + 16 <= end; offset += 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset));
+		const __m128i next_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset + 1));
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(
+			_mm_cmpeq_epi8(block, first_byte), _mm_cmpeq_epi8(next_block, second_byte))));
+		while (mask != 0) {
+			const unsigned int bit = count_trailing_zeros(mask);
+			function(offset + bit);
+			mask &= mask - 1;
+		}
+	}
+#endif
+	while (offset < end) {
+		const void * const found = std::memchr(data + offset, DOS_SIGNATURE & 0xff, end - offset);
+		if (!found) break;
+		offset = static_cast<std::size_t>(static_cast<const char *>(found) - data);
+		if (static_cast<unsigned char>(data[offset + 1]) == (DOS_SIGNATURE >> 8))
+			function(offset);
+		++offset;
+	}
+}
+
+template <unsigned int XX>
+std::size_t carved_image_extent(const char * image_data, std::size_t available_size, std::size_t nt_offset)
+{
+	NtHeaders<XX> nt_headers;
+	std::memcpy(&nt_headers, image_data + nt_offset, sizeof(NtHeaders<XX>));
+	const auto & file_header = nt_headers.file_header;
+	const auto & opt_header = nt_headers.optional_header;
+
+	const std::size_t section_table_offset = nt_offset + offsetof(NtHeaders<XX>, optional_header)
+	                                       + boost::endian::little_to_native(file_header.size_of_optional_header);
+	const std::size_t number_of_sections = boost::endian::little_to_native(file_header.number_of_sections);
+
+	std::size_t extent = std::max<std::size_t>(boost::endian::little_to_native(opt_header.size_of_headers),
+	                                           section_table_offset + number_of_sections * sizeof(SectionHeader));
+	for (std::size_t i = 0; i < number_of_sections; ++i) {
+		const std::size_t header_offset = section_table_offset + i * sizeof(SectionHeader);
+		if (header_offset + sizeof(SectionHeader) > available_size) break;
+
+		const char * const section_header = image_data + header_offset;
+		const std::size_t raw_size = load_le_value<DWORD>(section_header + offsetof(SectionHeader, size_of_raw_data));
+		const std::size_t raw_offset = load_le_value<DWORD>(section_header + offsetof(SectionHeader, pointer_to_raw_data));
+		if (raw_size != 0) extent = std::max(extent, raw_offset + raw_size);
+	}
+
+	if (boost::endian::little_to_native(opt_header.number_of_rvas_and_sizes) > DIRECTORY_ENTRY_SECURITY) {
+		const DataDirectory & security_dir = opt_header.data_directory[DIRECTORY_ENTRY_SECURITY];
+		const std::size_t certificate_size = boost::endian::little_to_native(security_dir.size);
+		const std::size_t certificate_offset = boost::endian::little_to_native(security_dir.virtual_address);
+		if (certificate_size != 0) extent = std::max(extent, certificate_offset + certificate_size);
+	}
+
+	return std::min(extent, available_size);
+}
+
+inline std::optional<CarvedImage> probe_carved_image(const char * data, std::size_t data_size, std::size_t offset)
+{
+	const char * const image_data = data + offset;
+	const std::size_t available_size = data_size - offset;
+	if (available_size < sizeof(DosHeader)) return std::nullopt;
+
+	const std::size_t nt_offset = load_le_value<DWORD>(image_data + offsetof(DosHeader, e_lfanew));
+	const std::size_t magic_offset = nt_offset + offsetof(NtHeaders<32>, optional_header);
+	if (magic_offset + sizeof(WORD) > available_size) return std::nullopt;
+	if (load_le_value<DWORD>(image_data + nt_offset) != NT_SIGNATURE) return std::nullopt;
+
+	const WORD magic = load_le_value<WORD>(image_data + magic_offset);
+	if (magic == OPTIONAL_HDR64_MAGIC && nt_offset + sizeof(NtHeaders<64>) <= available_size) {
+		const std::size_t size = carved_image_extent<64>(image_data, available_size, nt_offset);
+		return CarvedImage { offset, size, 64, LocalBuffer(image_data, size) };
+	}
+	if (magic == OPTIONAL_HDR32_MAGIC && nt_offset + sizeof(NtHeaders<32>) <= available_size) {
+		const std::size_t size = carved_image_extent<32>(image_data, available_size, nt_offset);
+		return CarvedImage { offset, size, 32, LocalBuffer(image_data, size) };
+	}
+
+	return std::nullopt;
+}
+
+}
+
+template <unsigned int XX>
+FileImage<XX, local_buffer> CarvedImage::image() const
+{
+	if (bitness != XX) throw std::runtime_error("Image bitness mismatch");
+	return FileImage<XX, local_buffer>(buffer);
+}
+
+inline std::vector<CarvedImage> carve_images(const void * data, std::size_t data_size,
+                                             unsigned int thread_count = std::thread::hardware_concurrency())
+{
+	const char * const bytes = static_cast<const char *>(data);
+	const std::size_t chunk_count = (data_size + detail::CARVE_CHUNK_SIZE - 1) / detail::CARVE_CHUNK_SIZE;
+	std::vector<std::vector<CarvedImage>> chunk_images (chunk_count);
+	detail::parallel_for(chunk_count, thread_count, [&] (std::size_t chunk) {
+		const std::size_t chunk_begin = chunk * detail::CARVE_CHUNK_SIZE;
+		const std::size_t chunk_end = std::min(chunk_begin + detail::CARVE_CHUNK_SIZE, data_size);
+		detail::find_dos_signatures(bytes, data_size, chunk_begin, chunk_end, [&] (std::size_t offset) {
+			if (auto carved_image = detail::probe_carved_image(bytes, data_size, offset))
+				chunk_images[chunk].push_back(*carved_image);
+		});
+	});
+
+	std::vector<CarvedImage> carved_images;
+	for (std::vector<CarvedImage> & images : chunk_images)
+		std::move(images.begin(), images.end(), std::back_inserter(carved_images));
+
+	std::sort(carved_images.begin(), carved_images.end(), [] (const CarvedImage & lhs, const CarvedImage & rhs) {
+		return lhs.offset < rhs.offset;
+	});
+
+	return carved_images;
+}
+
+}
+
+#endif
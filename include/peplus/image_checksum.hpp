@@ -0,0 +1,189 @@
+#ifndef PEPLUS_IMAGECHECKSUM_HPP_
+#define PEPLUS_IMAGECHECKSUM_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/simd_support.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace peplus {
+
+class ChecksumCalculator
+{
+public:
+	static constexpr std::size_t CHUNK_SIZE = 0x10000;
+
+	explicit ChecksumCalculator(std::size_t checksum_offset);
+
+	void update(const void * data, std::size_t size);
+
+	std::size_t size() const;
+	DWORD value() const;
+
+private:
+	void add_bytes(const char * data, std::size_t size);
+	void add_zero_bytes(std::size_t size);
+
+	std::size_t   _checksum_offset;
+	std::size_t   _size = 0;
+	std::uint64_t _sum = 0;
+	BYTE          _pending_byte = 0;
+};
+
+namespace detail {
+
+inline std::uint64_t sum_le_words(const char * data, std::size_t size)
+{
+	std::uint64_t sum = 0;
+	std::size_t offset = 0;
+#if defined(PEPLUS_HAS_AVX2)
+	const __m256i low_mask = _mm256_set1_epi32(0xffff);
+	while (offset + 32 <= size) {
+		const std::size_t block_end = offset + std::min<std::size_t>((size - offset) / 32, 0x8000) * 32;
+		__m256i accumulator = _mm256_setzero_si256();
+		for (; offset < block_end; offset += 32) {
+			const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + offset));
+			accumulator = _mm256_add_epi32(accumulator, _mm256_and_si256(words, low_mask));
+			accumulator = _mm256_add_epi32(accumulator, _mm256_srli_epi32(words, 16));
+		}
+		alignas(32) std::array<std::uint32_t, 8> lanes;
+		_mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()), accumulator);
+		for (std::uint32_t lane : lanes) sum += lane;
+	}
+#elif defined(PEPLUS_HAS_SSE2)
+	const __m128i low_mask = _mm_set1_epi32(0xffff);
+	while (offset + 16 <= size) {
+		const std::size_t block_end = offset + std::min<std::size_t>((size - offset) / 16, 0x8000) * 16;
+		__m128i accumulator = _mm_setzero_si128();
+		for (; offset < block_end; offset += 16) {
+			const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset));
+			accumulator = _mm_add_epi32(accumulator, _mm_and_si128(words, low_mask));
+			accumulator = _mm_add_epi32(accumulator, _mm_srli_epi32(words, 16));
+		}
+		alignas(16) std::array<std::uint32_t, 4> lanes;
+		_mm_store_si128(reinterpret_cast<__m128i *>(lanes.data()), accumulator);
+		for (std::uint32_t lane : lanes) sum += lane;
+	}
+#else
+	for (; offset + 8 <= size; offset += 8) {
+		const QWORD words = load_le_value<QWORD>(data + offset);
+		sum += (words & 0xffff) + (words >> 16 & 0xffff) + (words >> 32 & 0xffff) + (words >> 48);
+	}
+#endif
+	for (; offset + 2 <= size; offset += 2)
+		sum += load_le_value<WORD>(data + offset);
+	return sum;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+std::size_t checksum_offset(const FileImage<XX, MemoryBuffer> & image)
+{
+	return static_cast<std::size_t>(image.optional_header().offset().value()) + offsetof(OptionalHeader<XX>, check_sum);
+}
+
+}
+
+inline ChecksumCalculator::ChecksumCalculator(std::size_t checksum_offset)
+	: _checksum_offset { checksum_offset } {}
+
+inline void ChecksumCalculator::update(const void * data, std::size_t size)
+{
+	const std::size_t checksum_end = _checksum_offset + sizeof(DWORD);
+
+	const char * bytes = static_cast<const char *>(data);
+	while (size != 0) {
+		std::size_t chunk_size = size;
+		if (_size < _checksum_offset) {
+			chunk_size = std::min(size, _checksum_offset - _size);
+			add_bytes(bytes, chunk_size);
+		} else if (_size < checksum_end) {
+			chunk_size = std::min(size, checksum_end - _size);
+			add_zero_bytes(chunk_size);
+		} else {
+			add_bytes(bytes, chunk_size);
+		}
+		bytes += chunk_size;
+		size -= chunk_size;
+	}
+}
+
+inline std::size_t ChecksumCalculator::size() const
+{
+	return _size;
+}
+
+inline DWORD ChecksumCalculator::value() const
+{
+	std::uint64_t sum = _sum + (_size % 2 != 0 ? _pending_byte : 0);
+	while ((sum >> 16) != 0)
+		sum = (sum & 0xffff) + (sum >> 16);
+	return static_cast<DWORD>(sum + _size);
+}
+
+inline void ChecksumCalculator::add_bytes(const char * data, std::size_t size)
+{
+	if (size == 0) return;
+
+	if (_size % 2 != 0) {
+		_sum += _pending_byte | static_cast<WORD>(static_cast<BYTE>(*data) << 8);
+		++data, --size, ++_size;
+	}
+
+	const std::size_t even_size = size & ~std::size_t(1);
+	_sum += detail::sum_le_words(data, even_size);
+	_size += even_size;
+
+	if (even_size != size) {
+		_pending_byte = static_cast<BYTE>(data[even_size]);
+		++_size;
+	}
+}
+
+inline void ChecksumCalculator::add_zero_bytes(std::size_t size)
+{
+	if (size == 0) return;
+
+	if (_size % 2 != 0) {
+		_sum += _pending_byte;
+		--size, ++_size;
+	}
+
+	_pending_byte = 0;
+	_size += size;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+DWORD compute_checksum(const FileImage<XX, MemoryBuffer> & image)
+{
+	ChecksumCalculator checksum_calculator { detail::checksum_offset(image) };
+	if (const std::optional<std::string_view> image_view = image.view()) {
+		checksum_calculator.update(image_view->data(), image_view->size());
+		return checksum_calculator.value();
+	}
+
+	std::vector<char> chunk (ChecksumCalculator::CHUNK_SIZE);
+	for (std::size_t bytes_read = chunk.size(); bytes_read == chunk.size(); ) {
+		bytes_read = image.read(FileOffset(checksum_calculator.size()), chunk.size(), chunk.data()).first;
+		checksum_calculator.update(chunk.data(), bytes_read);
+	}
+
+	return checksum_calculator.value();
+}
+
+template <unsigned int XX, class MemoryBuffer>
+bool verify_checksum(const FileImage<XX, MemoryBuffer> & image)
+{
+	return image.optional_header().check_sum == compute_checksum(image);
+}
+
+}
+
+#endif
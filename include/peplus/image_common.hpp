@@ -19,6 +19,18 @@ using detail::VirtualOffset;
 
 using detail::RelocationEntry;
 
+using detail::DigestRange;
+
+using detail::CodeViewInfo;
+using detail::MetadataColumnView;
+using detail::MetadataFacade;
+using detail::MetadataTableView;
+using detail::MetadataToken;
+using detail::RichEntry;
+using detail::SymbolKey;
+
+using detail::decode_coded_index;
+
 }
 
 #endif
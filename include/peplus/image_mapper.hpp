@@ -0,0 +1,217 @@
+#ifndef PEPLUS_IMAGEMAPPER_HPP_
+#define PEPLUS_IMAGEMAPPER_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/image_rebase.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PEPLUS_HAS_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace peplus {
+
+class MappedImage
+{
+public:
+	MappedImage() = default;
+	explicit MappedImage(std::size_t size);
+
+	MappedImage(MappedImage && other) noexcept;
+	MappedImage & operator =(MappedImage && other) noexcept;
+	~MappedImage();
+
+	char * data();
+	const char * data() const;
+	std::size_t size() const;
+
+	LocalBuffer buffer() const;
+
+private:
+	void release();
+
+	char        * _data = nullptr;
+	std::size_t   _size = 0;
+};
+
+namespace detail {
+
+inline std::size_t mapping_page_size()
+{
+#ifdef PEPLUS_HAS_MMAP
+	const long page_size = ::sysconf(_SC_PAGESIZE);
+	if (page_size > 0) return static_cast<std::size_t>(page_size);
+#endif
+	return MEMORY_PAGE_SIZE;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+void map_image_sections(const FileImage<XX, MemoryBuffer> & image, MappedImage & mapped_image,
+                        int fd, std::size_t file_size)
+{
+	const auto opt_header = image.optional_header();
+	const std::size_t page_size = mapping_page_size();
+	const std::size_t section_alignment = std::max<std::size_t>(opt_header.section_alignment, 1);
+
+	const std::size_t headers_size = std::min<std::size_t>(opt_header.size_of_headers, mapped_image.size());
+	image.read(FileOffset(0), headers_size, mapped_image.data());
+
+	for (const auto & section_header : image.section_headers()) {
+		const std::size_t virtual_size = section_header.virtual_size != 0 ? section_header.virtual_size
+		                                                                  : section_header.size_of_raw_data;
+		const std::size_t aligned_size = (virtual_size + section_alignment - 1) / section_alignment * section_alignment;
+		if (section_header.virtual_address >= mapped_image.size()) continue;
+
+		const std::size_t available_size = mapped_image.size() - section_header.virtual_address;
+		const std::size_t data_size = std::min({ std::size_t(section_header.size_of_raw_data), aligned_size, available_size });
+		if (data_size == 0 || section_header.pointer_to_raw_data == 0) continue;
+
+		char * const section_data = mapped_image.data() + section_header.virtual_address;
+		std::size_t mapped_size = 0;
+#ifdef PEPLUS_HAS_MMAP
+		if (fd >= 0 && section_header.pointer_to_raw_data < file_size
+		            && section_header.pointer_to_raw_data % page_size == 0
+		            && section_header.virtual_address % page_size == 0) {
+			const std::size_t file_data_size = std::min<std::size_t>(data_size, file_size - section_header.pointer_to_raw_data);
+			mapped_size = file_data_size / page_size * page_size;
+			if (mapped_size != 0 && ::mmap(section_data, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+			                               fd, section_header.pointer_to_raw_data) == MAP_FAILED)
+				throw std::system_error(errno, std::generic_category(), "Unable to map image section");
+		}
+#else
+		static_cast<void>(fd);
+		static_cast<void>(file_size);
+		static_cast<void>(page_size);
+#endif
+		const FileOffset tail_offset ( section_header.pointer_to_raw_data + mapped_size );
+		image.read(tail_offset, data_size - mapped_size, section_data + mapped_size);
+	}
+}
+
+}
+
+inline MappedImage::MappedImage(std::size_t size)
+	: _size { size }
+{
+	if (size == 0) throw std::runtime_error("Invalid image size");
+#ifdef PEPLUS_HAS_MMAP
+	void * const data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (data == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "Unable to allocate image");
+	_data = static_cast<char *>(data);
+#else
+	_data = static_cast<char *>(std::calloc(size, 1));
+	if (!_data) throw std::bad_alloc();
+#endif
+}
+
+inline MappedImage::MappedImage(MappedImage && other) noexcept
+	: _data { std::exchange(other._data, nullptr) }, _size { std::exchange(other._size, 0) } {}
+
+inline MappedImage & MappedImage::operator =(MappedImage && other) noexcept
+{
+	if (this != &other) {
+		release();
+		_data = std::exchange(other._data, nullptr);
+		_size = std::exchange(other._size, 0);
+	}
+	return *this;
+}
+
+inline MappedImage::~MappedImage()
+{
+	release();
+}
+
+inline char * MappedImage::data()
+{
+	return _data;
+}
+
+inline const char * MappedImage::data() const
+{
+	return _data;
+}
+
+inline std::size_t MappedImage::size() const
+{
+	return _size;
+}
+
+inline LocalBuffer MappedImage::buffer() const
+{
+	return LocalBuffer(_data, _size);
+}
+
+inline void MappedImage::release()
+{
+	if (!_data) return;
+#ifdef PEPLUS_HAS_MMAP
+	::munmap(_data, _size);
+#else
+	std::free(_data);
+#endif
+	_data = nullptr;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+MappedImage map_image(const FileImage<XX, MemoryBuffer> & image)
+{
+	MappedImage mapped_image { image.optional_header().size_of_image };
+	detail::map_image_sections(image, mapped_image, -1, 0);
+	return mapped_image;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+MappedImage map_image(const FileImage<XX, MemoryBuffer> & image, ULONG_PTR<XX> new_base)
+{
+	MappedImage mapped_image = map_image(image);
+	rebase_image<XX>(mapped_image.data(), mapped_image.size(), new_base);
+	return mapped_image;
+}
+
+#ifdef PEPLUS_HAS_MMAP
+
+template <unsigned int XX>
+MappedImage map_image_file(int fd, std::optional<ULONG_PTR<XX>> new_base = std::nullopt)
+{
+	struct stat file_stat;
+	if (::fstat(fd, &file_stat) != 0)
+		throw std::system_error(errno, std::generic_category(), "Unable to stat image file");
+
+	const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+	void * const file_data = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (file_data == MAP_FAILED)
+		throw std::system_error(errno, std::generic_category(), "Unable to map image file");
+
+	try {
+		const FileImage<XX, local_buffer> image { LocalBuffer(file_data, file_size) };
+		MappedImage mapped_image { image.optional_header().size_of_image };
+		detail::map_image_sections(image, mapped_image, fd, file_size);
+		if (new_base) rebase_image<XX>(mapped_image.data(), mapped_image.size(), *new_base);
+		::munmap(file_data, file_size);
+		return mapped_image;
+	} catch (...) {
+		::munmap(file_data, file_size);
+		throw;
+	}
+}
+
+#endif
+
+}
+
+#endif
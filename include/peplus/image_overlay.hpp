@@ -0,0 +1,158 @@
+#ifndef PEPLUS_IMAGEOVERLAY_HPP_
+#define PEPLUS_IMAGEOVERLAY_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace peplus {
+
+namespace detail {
+
+const std::size_t OVERLAY_CHUNK_SIZE = 0x10000;
+
+}
+
+template <unsigned int XX, class MemoryBuffer>
+class ImageOverlay
+{
+public:
+	explicit ImageOverlay(const FileImage<XX, MemoryBuffer> & image);
+
+	bool empty() const;
+	FileOffset offset() const;
+	std::optional<std::size_t> size() const;
+
+	const std::vector<DigestRange> & ranges() const;
+
+	std::optional<std::string_view> view() const;
+
+	template <class Fn>
+	void for_each_chunk(Fn && fn) const;
+
+	template <class Hash>
+	Hash & hash(Hash & hash) const;
+
+private:
+	const FileImage<XX, MemoryBuffer> * _image;
+	std::size_t                         _offset;
+	std::vector<DigestRange>            _ranges;
+	bool                                _empty;
+};
+
+template <unsigned int XX, class MemoryBuffer>
+ImageOverlay<XX, MemoryBuffer>::ImageOverlay(const FileImage<XX, MemoryBuffer> & image)
+	: _image { &image }
+{
+	const auto opt_header = image.optional_header();
+	_offset = opt_header.size_of_headers;
+	for (const auto & section_header : image.section_headers()) {
+		if (section_header.size_of_raw_data != 0)
+			_offset = std::max<std::size_t>(_offset, std::size_t(section_header.pointer_to_raw_data) + section_header.size_of_raw_data);
+	}
+
+	std::size_t certificate_begin = DigestRange::TO_END, certificate_end = DigestRange::TO_END;
+	if (const auto security_dir = image.data_directory(DIRECTORY_ENTRY_SECURITY); security_dir && security_dir->size != 0) {
+		certificate_begin = security_dir->virtual_address;
+		certificate_end = certificate_begin + security_dir->size;
+		if (certificate_begin <= _offset && certificate_end > _offset) _offset = certificate_end;
+	}
+
+	std::size_t image_size = DigestRange::TO_END;
+	if (const std::optional<std::string_view> image_view = image.view())
+		image_size = std::max(image_view->size(), _offset);
+
+	if (certificate_begin > _offset && certificate_begin < image_size) {
+		detail::append_digest_range(_ranges, _offset, certificate_begin);
+		detail::append_digest_range(_ranges, std::min(certificate_end, image_size), image_size);
+	} else {
+		detail::append_digest_range(_ranges, _offset, image_size);
+	}
+
+	char probe;
+	_empty = std::none_of(_ranges.begin(), _ranges.end(), [&image, &probe] (const DigestRange & range) {
+		return image.read(FileOffset(range.offset), 1, &probe).first != 0;
+	});
+}
+
+template <unsigned int XX, class MemoryBuffer>
+bool ImageOverlay<XX, MemoryBuffer>::empty() const
+{
+	return _empty;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+FileOffset ImageOverlay<XX, MemoryBuffer>::offset() const
+{
+	return FileOffset(_offset);
+}
+
+template <unsigned int XX, class MemoryBuffer>
+std::optional<std::size_t> ImageOverlay<XX, MemoryBuffer>::size() const
+{
+	std::size_t overlay_size = 0;
+	for (const DigestRange & range : _ranges) {
+		if (range.size == DigestRange::TO_END) return std::nullopt;
+		overlay_size += range.size;
+	}
+	return overlay_size;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+const std::vector<DigestRange> & ImageOverlay<XX, MemoryBuffer>::ranges() const
+{
+	return _ranges;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+std::optional<std::string_view> ImageOverlay<XX, MemoryBuffer>::view() const
+{
+	if (_ranges.size() > 1) return std::nullopt;
+	if (_ranges.empty()) return std::string_view();
+	return _image->view(FileOffset(_ranges.front().offset), _ranges.front().size);
+}
+
+template <unsigned int XX, class MemoryBuffer> template <class Fn>
+void ImageOverlay<XX, MemoryBuffer>::for_each_chunk(Fn && fn) const
+{
+	if (const std::optional<std::string_view> image_view = _image->view()) {
+		for (const DigestRange & range : _ranges) {
+			if (range.offset >= image_view->size()) continue;
+			fn(FileOffset(range.offset), image_view->substr(range.offset, range.size));
+		}
+		return;
+	}
+
+	std::vector<char> chunk (detail::OVERLAY_CHUNK_SIZE);
+	for (const DigestRange & range : _ranges) {
+		std::size_t remaining_size = range.size;
+		for (std::size_t offset = range.offset; remaining_size != 0; ) {
+			const std::size_t chunk_size = std::min(remaining_size, chunk.size());
+			const std::size_t bytes_read = _image->read(FileOffset(offset), chunk_size, chunk.data()).first;
+			if (bytes_read != 0) fn(FileOffset(offset), std::string_view(chunk.data(), bytes_read));
+			if (bytes_read < chunk_size) break;
+
+			offset += bytes_read;
+			if (remaining_size != DigestRange::TO_END) remaining_size -= bytes_read;
+		}
+	}
+}
+
+template <unsigned int XX, class MemoryBuffer> template <class Hash>
+Hash & ImageOverlay<XX, MemoryBuffer>::hash(Hash & hash) const
+{
+	for_each_chunk([&hash] (FileOffset, std::string_view data) {
+		hash.update(data.data(), data.size());
+	});
+	return hash;
+}
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef PEPLUS_IMAGEREBASE_HPP_
+#define PEPLUS_IMAGEREBASE_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/local_buffer.hpp>
+#include <peplus/virtual_image.hpp>
+#include <peplus/detail/image_base.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace peplus {
+
+namespace detail {
+
+template <typename T>
+void relocate_uniform_block(char * page, const WORD * type_offsets, std::size_t count, T delta)
+{
+	for (std::size_t i = 0; i < count; ++i) {
+		char * const target = page + (type_offsets[i] & (MEMORY_PAGE_SIZE - 1));
+		store_le_value<T>(target, load_le_value<T>(target) + delta);
+	}
+}
+
+inline bool is_uniform_block(const WORD * type_offsets, std::size_t count, unsigned int type)
+{
+	bool is_uniform = true;
+	for (std::size_t i = 0; i < count; ++i)
+		is_uniform &= (type_offsets[i] >> 12) == type;
+	return is_uniform;
+}
+
+inline std::size_t relocate_block(char * image_mem, std::size_t image_size, std::size_t page_rva,
+                                  const WORD * type_offsets, std::size_t count, std::int64_t delta)
+{
+	std::size_t used_count = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		const unsigned int type = type_offsets[i] >> 12;
+		if (type == REL_BASED_HIGHADJ) ++i;
+		if (type != REL_BASED_ABSOLUTE) used_count = std::min(i + 1, count);
+	}
+	count = used_count;
+
+	const bool page_in_bounds = page_rva <= image_size
+	                         && image_size - page_rva >= MEMORY_PAGE_SIZE - 1 + sizeof(QWORD);
+	if (page_in_bounds && is_uniform_block(type_offsets, count, REL_BASED_DIR64)) {
+		relocate_uniform_block<QWORD>(image_mem + page_rva, type_offsets, count, delta);
+		return count;
+	} else if (page_in_bounds && is_uniform_block(type_offsets, count, REL_BASED_HIGHLOW)) {
+		relocate_uniform_block<DWORD>(image_mem + page_rva, type_offsets, count, static_cast<DWORD>(delta));
+		return count;
+	}
+
+	std::size_t relocations_applied = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		const unsigned int type = type_offsets[i] >> 12;
+		const std::size_t target_rva = page_rva + (type_offsets[i] & (MEMORY_PAGE_SIZE - 1));
+		const std::size_t target_size = type == REL_BASED_DIR64   ? sizeof(QWORD)
+		                              : type == REL_BASED_HIGHLOW ? sizeof(DWORD) : sizeof(WORD);
+		if (type != REL_BASED_ABSOLUTE && (target_rva > image_size || image_size - target_rva < target_size))
+			throw std::runtime_error("Relocation target out of bounds");
+
+		char * const target = image_mem + target_rva;
+		switch (type) {
+			case REL_BASED_ABSOLUTE:
+				continue;
+			case REL_BASED_HIGH:
+				store_le_value<WORD>(target, load_le_value<WORD>(target) + static_cast<WORD>(delta >> 16));
+				break;
+			case REL_BASED_LOW:
+				store_le_value<WORD>(target, load_le_value<WORD>(target) + static_cast<WORD>(delta));
+				break;
+			case REL_BASED_HIGHLOW:
+				store_le_value<DWORD>(target, load_le_value<DWORD>(target) + static_cast<DWORD>(delta));
+				break;
+			case REL_BASED_HIGHADJ: {
+				if (++i == count) throw std::runtime_error("Invalid base relocation block");
+				const std::uint32_t high = static_cast<std::uint32_t>(load_le_value<WORD>(target)) << 16;
+				const std::uint32_t adjusted = high + static_cast<std::uint32_t>(static_cast<std::int16_t>(type_offsets[i]));
+				const std::uint32_t relocated = adjusted + static_cast<std::uint32_t>(delta) + 0x8000;
+				store_le_value<WORD>(target, static_cast<WORD>(relocated >> 16));
+				break;
+			}
+			case REL_BASED_DIR64:
+				store_le_value<QWORD>(target, load_le_value<QWORD>(target) + delta);
+				break;
+			default:
+				throw std::runtime_error("Unsupported relocation type");
+		}
+		++relocations_applied;
+	}
+
+	return relocations_applied;
+}
+
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::size_t apply_relocations(const detail::ImageBase<XX, Offset, MemoryBuffer> & image,
+                              void * image_mem, std::size_t image_size, std::int64_t delta)
+{
+	if (delta == 0) return 0;
+
+	std::size_t relocations_applied = 0;
+	std::vector<WORD> type_offsets;
+	for (const auto & reloc_block : image.base_relocations()) {
+		type_offsets.resize(reloc_block.number_of_entries());
+		reloc_block.read_type_offsets(type_offsets.data());
+		relocations_applied += detail::relocate_block(static_cast<char *>(image_mem), image_size,
+		                                              reloc_block.virtual_address, type_offsets.data(),
+		                                              type_offsets.size(), delta);
+	}
+
+	return relocations_applied;
+}
+
+template <unsigned int XX>
+std::size_t rebase_image(void * image_mem, std::size_t image_size, ULONG_PTR<XX> new_base)
+{
+	const VirtualImage<XX, local_buffer> image { LocalBuffer(image_mem, image_size) };
+	const auto opt_header = image.optional_header();
+	if (opt_header.image_base == new_base) return 0;
+
+	if ((image.file_header().characteristics & FILE_RELOCS_STRIPPED) != 0)
+		throw std::runtime_error("Image relocations stripped");
+
+	const std::int64_t delta = static_cast<std::int64_t>(new_base - opt_header.image_base);
+	const std::size_t relocations_applied = apply_relocations(image, image_mem, image_size, delta);
+
+	const auto image_base_offset = opt_header.offset() + offsetof(OptionalHeader<XX>, image_base);
+	detail::store_le_value<ULONG_PTR<XX>>(static_cast<char *>(image_mem) + image_base_offset.value(), new_base);
+	return relocations_applied;
+}
+
+}
+
+#endif
@@ -0,0 +1,298 @@
+#ifndef PEPLUS_IMPORTENUMERATOR_HPP_
+#define PEPLUS_IMPORTENUMERATOR_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+#include <peplus/detail/image_base.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace peplus {
+
+enum class ImportKind
+{
+	Regular, Delayed, Bound,
+};
+
+struct ImportRecord
+{
+	ImportKind                   kind;
+	std::string_view             module_name;
+	std::string_view             symbol_name;
+	std::optional<unsigned int>  ordinal;
+	WORD                         hint;
+	std::optional<VirtualOffset> thunk_rva;
+	DWORD                        time_date_stamp;
+};
+
+namespace detail {
+
+const std::size_t IMPORT_STRING_CHUNK_SIZE = 64;
+
+template <class Image>
+class SectionTranslationCache
+{
+public:
+	using offset_type = typename Image::offset_type;
+
+	explicit SectionTranslationCache(const Image & image);
+
+	std::optional<offset_type> translate(VirtualOffset rva) const;
+
+private:
+	struct SectionMapping
+	{
+		std::size_t virtual_begin;
+		std::size_t virtual_end;
+		std::size_t raw_begin;
+	};
+
+	std::size_t                 _headers_size = 0;
+	std::vector<SectionMapping> _section_mappings;
+	mutable std::size_t         _last_mapping = 0;
+};
+
+template <class Image>
+SectionTranslationCache<Image>::SectionTranslationCache(const Image & image)
+{
+	if constexpr (std::is_same_v<offset_type, FileOffset>) {
+		_headers_size = image.optional_header().size_of_headers;
+		for (const auto & section_header : image.section_headers()) {
+			const std::size_t virtual_begin = section_header.virtual_address;
+			_section_mappings.push_back(SectionMapping {
+				virtual_begin, virtual_begin + section_header.size_of_raw_data, section_header.pointer_to_raw_data
+			});
+		}
+		std::stable_sort(_section_mappings.begin(), _section_mappings.end(),
+		                 [] (const SectionMapping & lhs, const SectionMapping & rhs) {
+			return lhs.virtual_begin < rhs.virtual_begin;
+		});
+	}
+}
+
+template <class Image>
+auto SectionTranslationCache<Image>::translate(VirtualOffset rva) const -> std::optional<offset_type>
+{
+	if constexpr (std::is_same_v<offset_type, VirtualOffset>) {
+		return rva;
+	} else {
+		if (rva.value() < 0) return std::nullopt;
+		const std::size_t rva_value = static_cast<std::size_t>(rva.value());
+		if (rva_value < _headers_size) return FileOffset(rva_value);
+
+		const auto contains_rva = [rva_value] (const SectionMapping & mapping) {
+			return mapping.virtual_begin <= rva_value && rva_value < mapping.virtual_end;
+		};
+
+		if (_last_mapping < _section_mappings.size() && contains_rva(_section_mappings[_last_mapping]))
+			return FileOffset(_section_mappings[_last_mapping].raw_begin + (rva_value - _section_mappings[_last_mapping].virtual_begin));
+
+		const auto mapping = std::upper_bound(_section_mappings.begin(), _section_mappings.end(), rva_value,
+		                                      [] (std::size_t value, const SectionMapping & mapping) {
+			return value < mapping.virtual_begin;
+		});
+		if (mapping == _section_mappings.begin() || !contains_rva(*std::prev(mapping))) return std::nullopt;
+
+		_last_mapping = static_cast<std::size_t>(std::prev(mapping) - _section_mappings.begin());
+		return FileOffset(std::prev(mapping)->raw_begin + (rva_value - std::prev(mapping)->virtual_begin));
+	}
+}
+
+template <class Image>
+bool read_translated_string(const Image & image, const SectionTranslationCache<Image> & translation_cache,
+                            VirtualOffset rva, std::string & into_string)
+{
+	std::optional<typename Image::offset_type> string_offset = translation_cache.translate(rva);
+	if (!string_offset) return false;
+
+	std::array<char, IMPORT_STRING_CHUNK_SIZE> chunk;
+	for (;;) {
+		const std::size_t bytes_read = image.read(*string_offset, chunk.size(), chunk.data()).first;
+		const char * const terminator = static_cast<const char *>(std::memchr(chunk.data(), '\0', bytes_read));
+		if (terminator) {
+			into_string.append(chunk.data(), static_cast<std::size_t>(terminator - chunk.data()));
+			return true;
+		}
+		into_string.append(chunk.data(), bytes_read);
+		if (bytes_read < chunk.size()) return false;
+		*string_offset += bytes_read;
+	}
+}
+
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+class ImportEnumerator
+{
+public:
+	using image_type = detail::ImageBase<XX, Offset, MemoryBuffer>;
+
+	explicit ImportEnumerator(const image_type & image);
+
+	template <class Function>
+	void for_each(Function && function) const;
+
+	template <class Function>
+	void for_each(ImportKind kind, Function && function) const;
+
+	std::optional<Offset> translate(VirtualOffset rva) const;
+
+private:
+	template <class Function>
+	void enumerate_regular_imports(Function & function) const;
+
+	template <class Function>
+	void enumerate_delayed_imports(Function & function) const;
+
+	template <class Function>
+	void enumerate_bound_imports(Function & function) const;
+
+	template <class Function>
+	void enumerate_thunks(ImportRecord & import_record, DWORD name_table_rva, DWORD address_table_rva,
+	                      ULONG_PTR<XX> address_bias, Function & function) const;
+
+	bool read_string(VirtualOffset rva, std::string & into_string) const;
+
+	const image_type                               * _image;
+	detail::SectionTranslationCache<image_type>     _translation_cache;
+	mutable std::string                              _module_name;
+	mutable std::string                              _symbol_name;
+};
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+ImportEnumerator<XX, Offset, MemoryBuffer>::ImportEnumerator(const image_type & image)
+	: _image { &image }, _translation_cache { image } {}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class Function>
+void ImportEnumerator<XX, Offset, MemoryBuffer>::for_each(Function && function) const
+{
+	enumerate_regular_imports(function);
+	enumerate_delayed_imports(function);
+	enumerate_bound_imports(function);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class Function>
+void ImportEnumerator<XX, Offset, MemoryBuffer>::for_each(ImportKind kind, Function && function) const
+{
+	switch (kind) {
+		case ImportKind::Regular: enumerate_regular_imports(function); break;
+		case ImportKind::Delayed: enumerate_delayed_imports(function); break;
+		case ImportKind::Bound:   enumerate_bound_imports(function);   break;
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::optional<Offset> ImportEnumerator<XX, Offset, MemoryBuffer>::translate(VirtualOffset rva) const
+{
+	return _translation_cache.translate(rva);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class Function>
+void ImportEnumerator<XX, Offset, MemoryBuffer>::enumerate_regular_imports(Function & function) const
+{
+	const auto data_dir = _image->data_directory(DIRECTORY_ENTRY_IMPORT);
+	if (!data_dir || data_dir->size < sizeof(ImportDescriptor)) return;
+	if (!translate(VirtualOffset(data_dir->virtual_address))) return;
+
+	for (const auto & import_dtor : _image->import_descriptors()) {
+		if (!read_string(VirtualOffset(import_dtor.name), _module_name)) continue;
+
+		ImportRecord import_record { ImportKind::Regular, _module_name, {}, {}, 0, {}, import_dtor.time_date_stamp };
+		const DWORD name_table_rva = import_dtor.original_first_thunk != 0 ? import_dtor.original_first_thunk
+		                                                                    : import_dtor.first_thunk;
+		enumerate_thunks(import_record, name_table_rva, import_dtor.first_thunk, 0, function);
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class Function>
+void ImportEnumerator<XX, Offset, MemoryBuffer>::enumerate_delayed_imports(Function & function) const
+{
+	for (const auto & delay_dtor : _image->delay_import_descriptors()) {
+		const ULONG_PTR<XX> address_bias = delay_dtor.address_bias();
+		if (!read_string(delay_dtor.to_rva(delay_dtor.dll_name_rva), _module_name)) continue;
+
+		ImportRecord import_record { ImportKind::Delayed, _module_name, {}, {}, 0, {}, delay_dtor.time_date_stamp };
+		enumerate_thunks(import_record, delay_dtor.import_name_table_rva, delay_dtor.import_address_table_rva,
+		                 address_bias, function);
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class Function>
+void ImportEnumerator<XX, Offset, MemoryBuffer>::enumerate_bound_imports(Function & function) const
+{
+	for (const auto & bound_dtor : _image->bound_import_descriptors()) {
+		_module_name = bound_dtor.module_name_str();
+		function(ImportRecord { ImportKind::Bound, _module_name, {}, {}, 0, {}, bound_dtor.time_date_stamp });
+
+		for (const auto & forwarder_ref : bound_dtor.forwarder_refs()) {
+			_module_name = bound_dtor.module_name_str(forwarder_ref);
+			function(ImportRecord { ImportKind::Bound, _module_name, {}, {}, 0, {}, forwarder_ref.time_date_stamp });
+		}
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer> template <class Function>
+void ImportEnumerator<XX, Offset, MemoryBuffer>::enumerate_thunks(ImportRecord & import_record, DWORD name_table_rva,
+                                                                  DWORD address_table_rva, ULONG_PTR<XX> address_bias,
+                                                                  Function & function) const
+{
+	if (name_table_rva == 0) return;
+
+	const std::optional<Offset> name_table_offset = translate(VirtualOffset(static_cast<std::ptrdiff_t>(name_table_rva - address_bias)));
+	if (!name_table_offset) return;
+
+	const VirtualOffset address_table_start ( static_cast<std::ptrdiff_t>(address_table_rva - address_bias) );
+	for (std::size_t i = 0; ; ++i) {
+		ULONG_PTR<XX> thunk_value;
+		const std::size_t thunk_distance = i * sizeof(ThunkData<XX>);
+		if (_image->read(*name_table_offset + thunk_distance, sizeof(thunk_value), &thunk_value).first < sizeof(thunk_value)) break;
+		boost::endian::little_to_native_inplace(thunk_value);
+		if (thunk_value == 0) break;
+
+		import_record.thunk_rva = address_table_rva != 0 ? std::optional(address_table_start + thunk_distance) : std::nullopt;
+		if ((thunk_value & ORDINAL_FLAG<XX>) != 0) {
+			import_record.symbol_name = {};
+			import_record.ordinal = static_cast<unsigned int>(thunk_value & ~ORDINAL_FLAG<XX>);
+			import_record.hint = 0;
+		} else {
+			const VirtualOffset hint_name_rva ( static_cast<std::ptrdiff_t>(thunk_value - address_bias) );
+			const std::optional<Offset> hint_offset = translate(hint_name_rva);
+			WORD hint;
+			if (!hint_offset || _image->read(*hint_offset, sizeof(WORD), &hint).first < sizeof(WORD)) continue;
+			if (!read_string(hint_name_rva + offsetof(ImportByName, name), _symbol_name)) continue;
+			import_record.symbol_name = _symbol_name;
+			import_record.ordinal = std::nullopt;
+			import_record.hint = boost::endian::little_to_native(hint);
+		}
+		function(static_cast<const ImportRecord &>(import_record));
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+bool ImportEnumerator<XX, Offset, MemoryBuffer>::read_string(VirtualOffset rva, std::string & into_string) const
+{
+	into_string.clear();
+	return detail::read_translated_string(*_image, _translation_cache, rva, into_string);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer, class Function>
+void for_each_import(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Function && function)
+{
+	ImportEnumerator<XX, Offset, MemoryBuffer>(image).for_each(function);
+}
+
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef PEPLUS_IMPORTHASH_HPP_
+#define PEPLUS_IMPORTHASH_HPP_
+
+#include <peplus/image_common.hpp>
+#include <peplus/import_enumerator.hpp>
+#include <peplus/detail/image_base.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/ordinal_names.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace peplus {
+
+namespace detail {
+
+const std::size_t IMPORT_HASH_BUFFER_SIZE = 0x100;
+
+inline std::string_view strip_module_extension(std::string_view module_name)
+{
+	const std::size_t extension_pos = module_name.rfind('.');
+	if (extension_pos == std::string_view::npos) return module_name;
+
+	const std::string_view extension = module_name.substr(extension_pos + 1);
+	if (equals_ignore_case(extension, "dll") || equals_ignore_case(extension, "ocx") || equals_ignore_case(extension, "sys"))
+		return module_name.substr(0, extension_pos);
+	return module_name;
+}
+
+template <class Hash>
+class ImportHashWriter
+{
+public:
+	explicit ImportHashWriter(Hash & hash);
+
+	void append(char value);
+	void append_lower(std::string_view text);
+	void flush();
+
+private:
+	Hash                                      * _hash;
+	std::array<char, IMPORT_HASH_BUFFER_SIZE>   _buffer;
+	std::size_t                                 _size = 0;
+};
+
+template <class Hash>
+ImportHashWriter<Hash>::ImportHashWriter(Hash & hash)
+	: _hash { &hash } {}
+
+template <class Hash>
+void ImportHashWriter<Hash>::append(char value)
+{
+	if (_size == _buffer.size()) flush();
+	_buffer[_size++] = value;
+}
+
+template <class Hash>
+void ImportHashWriter<Hash>::append_lower(std::string_view text)
+{
+	while (!text.empty()) {
+		if (_size == _buffer.size()) flush();
+		const std::size_t chunk_size = std::min(text.size(), _buffer.size() - _size);
+		std::transform(text.begin(), text.begin() + chunk_size, _buffer.begin() + _size, to_lower_ascii);
+		_size += chunk_size;
+		text.remove_prefix(chunk_size);
+	}
+}
+
+template <class Hash>
+void ImportHashWriter<Hash>::flush()
+{
+	if (_size != 0) _hash->update(_buffer.data(), _size);
+	_size = 0;
+}
+
+class ImportNameHasher
+{
+public:
+	static constexpr std::uint64_t HASH_OFFSET_BASIS = 0xcbf29ce484222325;
+	static constexpr std::uint64_t HASH_PRIME = 0x100000001b3;
+	static constexpr std::uint64_t HASH_MULTIPLIER = 0xc6a4a7935bd1e995;
+	static constexpr unsigned int  HASH_SHIFT = 47;
+
+	void append(char value);
+	void append_lower(std::string_view text);
+	std::uint64_t finish() const;
+
+private:
+	std::uint64_t _hash = HASH_OFFSET_BASIS;
+};
+
+inline void ImportNameHasher::append(char value)
+{
+	_hash ^= static_cast<BYTE>(value);
+	_hash *= HASH_PRIME;
+}
+
+inline void ImportNameHasher::append_lower(std::string_view text)
+{
+	for (char value : text)
+		append(to_lower_ascii(value));
+}
+
+inline std::uint64_t ImportNameHasher::finish() const
+{
+	std::uint64_t hash = _hash;
+	hash ^= hash >> HASH_SHIFT;
+	hash *= HASH_MULTIPLIER;
+	hash ^= hash >> HASH_SHIFT;
+	return hash;
+}
+
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer, class Fn>
+void for_each_import_name(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Fn && fn)
+{
+	std::array<char, 16> ordinal_name { 'o', 'r', 'd' };
+	ImportEnumerator<XX, Offset, MemoryBuffer>(image).for_each(ImportKind::Regular, [&] (const ImportRecord & import_record) {
+		std::string_view symbol_name = import_record.symbol_name;
+		if (import_record.ordinal) {
+			if (const auto known_name = detail::find_ordinal_name(import_record.module_name, *import_record.ordinal)) {
+				symbol_name = *known_name;
+			} else {
+				const auto [name_end, _] = std::to_chars(ordinal_name.data() + 3, ordinal_name.data() + ordinal_name.size(),
+				                                         *import_record.ordinal);
+				symbol_name = std::string_view(ordinal_name.data(), static_cast<std::size_t>(name_end - ordinal_name.data()));
+			}
+		}
+		if (symbol_name.empty()) return;
+		fn(detail::strip_module_extension(import_record.module_name), symbol_name);
+	});
+}
+
+template <class Hash, unsigned int XX, class Offset, class MemoryBuffer>
+Hash & import_hash(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Hash & hash)
+{
+	detail::ImportHashWriter<Hash> writer { hash };
+	bool first_import = true;
+	for_each_import_name(image, [&] (std::string_view module_name, std::string_view symbol_name) {
+		if (!first_import) writer.append(',');
+		first_import = false;
+		writer.append_lower(module_name);
+		writer.append('.');
+		writer.append_lower(symbol_name);
+	});
+	writer.flush();
+	return hash;
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::vector<std::uint64_t> import_name_hashes(const detail::ImageBase<XX, Offset, MemoryBuffer> & image)
+{
+	std::vector<std::uint64_t> name_hashes;
+	for_each_import_name(image, [&name_hashes] (std::string_view module_name, std::string_view symbol_name) {
+		detail::ImportNameHasher hasher;
+		hasher.append_lower(module_name);
+		hasher.append('.');
+		hasher.append_lower(symbol_name);
+		name_hashes.push_back(hasher.finish());
+	});
+
+	std::sort(name_hashes.begin(), name_hashes.end());
+	name_hashes.erase(std::unique(name_hashes.begin(), name_hashes.end()), name_hashes.end());
+	return name_hashes;
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::uint64_t import_fingerprint(const detail::ImageBase<XX, Offset, MemoryBuffer> & image)
+{
+	using detail::ImportNameHasher;
+	const std::vector<std::uint64_t> name_hashes = import_name_hashes(image);
+	std::uint64_t fingerprint = name_hashes.size() * ImportNameHasher::HASH_MULTIPLIER;
+	for (std::uint64_t name_hash : name_hashes) {
+		fingerprint ^= name_hash;
+		fingerprint *= ImportNameHasher::HASH_MULTIPLIER;
+		fingerprint ^= fingerprint >> ImportNameHasher::HASH_SHIFT;
+	}
+	return fingerprint;
+}
+
+}
+
+#endif
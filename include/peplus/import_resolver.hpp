@@ -0,0 +1,608 @@
+#ifndef PEPLUS_IMPORTRESOLVER_HPP_
+#define PEPLUS_IMPORTRESOLVER_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+#include <peplus/import_enumerator.hpp>
+#include <peplus/detail/image_base.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace peplus {
+
+struct ExportEntry
+{
+	DWORD                           ordinal;
+	VirtualOffset                   rva;
+	std::optional<std::string_view> forwarder;
+};
+
+enum class ImportBindingStatus
+{
+	Bound, ModuleNotFound, ExportNotFound, ForwarderCycle,
+};
+
+class ExportIndex;
+
+struct ImportBinding
+{
+	ImportBindingStatus                status;
+	std::shared_ptr<const ExportIndex> module;
+	DWORD                              ordinal;
+	VirtualOffset                      rva;
+	ULONGLONG                          address;
+	unsigned int                       forwarder_count;
+};
+
+struct BoundImportThunk
+{
+	ImportKind          kind;
+	VirtualOffset       thunk_rva;
+	ImportBindingStatus status;
+	ULONGLONG           value;
+};
+
+struct ForwarderTarget
+{
+	std::string_view            module_name;
+	std::string_view            symbol_name;
+	std::optional<unsigned int> ordinal;
+};
+
+namespace detail {
+
+const std::size_t MAX_MODULE_NAME_SIZE = 260;
+const unsigned int MAX_FORWARDER_DEPTH = 32;
+const std::size_t MAX_EXPORT_COUNT = 0x10000;
+const std::size_t FORWARDER_CACHE_SHARD_COUNT = 16;
+
+class ModuleKey
+{
+public:
+	explicit ModuleKey(std::string_view module_name);
+
+	bool is_valid() const;
+	std::string_view view() const;
+
+private:
+	std::array<char, MAX_MODULE_NAME_SIZE> _buffer;
+	std::size_t                            _size = 0;
+	bool                                   _is_valid = false;
+};
+
+inline ModuleKey::ModuleKey(std::string_view module_name)
+{
+	const bool has_extension = module_name.find('.') != std::string_view::npos;
+	const std::string_view default_extension = has_extension ? std::string_view() : std::string_view(".dll");
+	if (module_name.empty() || module_name.size() + default_extension.size() > _buffer.size()) return;
+
+	std::transform(module_name.begin(), module_name.end(), _buffer.begin(), to_lower_ascii);
+	std::copy(default_extension.begin(), default_extension.end(), _buffer.begin() + module_name.size());
+	_size = module_name.size() + default_extension.size();
+	_is_valid = true;
+}
+
+inline bool ModuleKey::is_valid() const
+{
+	return _is_valid;
+}
+
+inline std::string_view ModuleKey::view() const
+{
+	return std::string_view(_buffer.data(), _size);
+}
+
+class ForwarderCache
+{
+public:
+	using ModulePtr = std::shared_ptr<const ExportIndex>;
+
+	std::uint64_t generation() const;
+
+	std::optional<ImportBinding> find(const ModulePtr & module, DWORD ordinal, std::uint64_t generation) const;
+	void insert(const ModulePtr & module, DWORD ordinal, const ImportBinding & binding, std::uint64_t generation);
+	void clear();
+	std::size_t size() const;
+
+private:
+	struct Key
+	{
+		ModulePtr module;
+		DWORD     ordinal;
+
+		bool operator ==(const Key & other) const;
+	};
+
+	struct KeyHash
+	{
+		std::size_t operator()(const Key & key) const;
+	};
+
+	struct CachedBinding
+	{
+		ImportBinding binding;
+		std::uint64_t generation;
+	};
+
+	struct Shard
+	{
+		mutable std::shared_mutex                       mutex;
+		std::unordered_map<Key, CachedBinding, KeyHash> bindings;
+	};
+
+	static std::size_t shard_index(const Key & key);
+
+	std::array<Shard, FORWARDER_CACHE_SHARD_COUNT> _shards;
+	std::atomic<std::uint64_t>                     _generation { 0 };
+};
+
+inline bool ForwarderCache::Key::operator ==(const Key & other) const
+{
+	return module == other.module && ordinal == other.ordinal;
+}
+
+inline std::size_t ForwarderCache::KeyHash::operator()(const Key & key) const
+{
+	std::uint64_t hash = (reinterpret_cast<std::uintptr_t>(key.module.get()) ^ std::uint64_t(key.ordinal) << 48) * 0x9e3779b97f4a7c15;
+	return static_cast<std::size_t>(hash ^ hash >> 32);
+}
+
+inline std::size_t ForwarderCache::shard_index(const Key & key)
+{
+	return (reinterpret_cast<std::uintptr_t>(key.module.get()) >> 4 ^ key.ordinal) % FORWARDER_CACHE_SHARD_COUNT;
+}
+
+inline std::uint64_t ForwarderCache::generation() const
+{
+	return _generation.load();
+}
+
+inline std::optional<ImportBinding> ForwarderCache::find(const ModulePtr & module, DWORD ordinal, std::uint64_t generation) const
+{
+	const Key key { module, ordinal };
+	const Shard & key_shard = _shards[shard_index(key)];
+	const std::shared_lock lock { key_shard.mutex };
+	const auto cached_binding = key_shard.bindings.find(key);
+	if (cached_binding == key_shard.bindings.end() || cached_binding->second.generation != generation) return std::nullopt;
+	return cached_binding->second.binding;
+}
+
+inline void ForwarderCache::insert(const ModulePtr & module, DWORD ordinal, const ImportBinding & binding, std::uint64_t generation)
+{
+	Key key { module, ordinal };
+	Shard & key_shard = _shards[shard_index(key)];
+	const std::unique_lock lock { key_shard.mutex };
+	if (generation != _generation.load()) return;
+	key_shard.bindings.insert_or_assign(std::move(key), CachedBinding { binding, generation });
+}
+
+inline void ForwarderCache::clear()
+{
+	++_generation;
+	for (Shard & shard : _shards) {
+		const std::unique_lock lock { shard.mutex };
+		shard.bindings.clear();
+	}
+}
+
+inline std::size_t ForwarderCache::size() const
+{
+	std::size_t cache_size = 0;
+	for (const Shard & shard : _shards) {
+		const std::shared_lock lock { shard.mutex };
+		cache_size += shard.bindings.size();
+	}
+	return cache_size;
+}
+
+}
+
+inline std::optional<ForwarderTarget> parse_forwarder(std::string_view forwarder)
+{
+	const std::size_t separator_pos = forwarder.rfind('.');
+	if (separator_pos == std::string_view::npos || separator_pos == 0 || separator_pos + 1 == forwarder.size())
+		return std::nullopt;
+
+	ForwarderTarget target { forwarder.substr(0, separator_pos), forwarder.substr(separator_pos + 1), std::nullopt };
+	if (target.symbol_name.front() == '#') {
+		unsigned int ordinal;
+		const char * const ordinal_end = target.symbol_name.data() + target.symbol_name.size();
+		const auto [parse_end, error] = std::from_chars(target.symbol_name.data() + 1, ordinal_end, ordinal);
+		if (error != std::errc() || parse_end != ordinal_end) return std::nullopt;
+		target.symbol_name = {};
+		target.ordinal = ordinal;
+	}
+	return target;
+}
+
+class ExportIndex
+{
+public:
+	template <unsigned int XX, class Offset, class MemoryBuffer>
+	explicit ExportIndex(const detail::ImageBase<XX, Offset, MemoryBuffer> & image,
+	                     std::optional<ULONGLONG> image_base = std::nullopt);
+
+	std::string_view name() const;
+	ULONGLONG image_base() const;
+	DWORD ordinal_base() const;
+
+	std::size_t size() const;
+	std::size_t name_count() const;
+
+	std::optional<ExportEntry> find(unsigned int ordinal) const;
+	std::optional<ExportEntry> find(std::string_view name, std::optional<WORD> hint = std::nullopt) const;
+
+private:
+	struct FunctionEntry
+	{
+		DWORD rva;
+		DWORD forwarder_offset;
+		DWORD forwarder_size;
+	};
+
+	struct NameEntry
+	{
+		DWORD name_offset;
+		DWORD name_size;
+		DWORD function_index;
+	};
+
+	std::string_view string_at(DWORD offset, DWORD size) const;
+	std::string_view name_at(const NameEntry & name_entry) const;
+	ExportEntry make_entry(std::size_t function_index) const;
+
+	std::string                _strings;
+	DWORD                      _name_size = 0;
+	ULONGLONG                  _image_base;
+	DWORD                      _ordinal_base = 0;
+	std::vector<FunctionEntry> _functions;
+	std::vector<NameEntry>     _names;
+	std::vector<DWORD>         _sorted_names;
+};
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+ExportIndex::ExportIndex(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, std::optional<ULONGLONG> image_base)
+	: _image_base { image_base.value_or(image.optional_header().image_base) }
+{
+	using image_type = detail::ImageBase<XX, Offset, MemoryBuffer>;
+	const auto export_dir = image.export_directory();
+	if (!export_dir) return;
+
+	const auto data_dir = image.data_directory(DIRECTORY_ENTRY_EXPORT);
+	const std::size_t export_begin = data_dir->virtual_address, export_end = export_begin + data_dir->size;
+	const detail::SectionTranslationCache<image_type> translation_cache { image };
+	const auto read_string = [&] (std::size_t rva, DWORD & string_offset, DWORD & string_size) {
+		const std::size_t strings_size = _strings.size();
+		if (!detail::read_translated_string(image, translation_cache, VirtualOffset(static_cast<std::ptrdiff_t>(rva)), _strings)) {
+			_strings.resize(strings_size);
+			return false;
+		}
+		string_offset = static_cast<DWORD>(strings_size);
+		string_size = static_cast<DWORD>(_strings.size() - strings_size);
+		return true;
+	};
+	const auto read_array = [&] (DWORD rva, std::size_t count, std::size_t element_size, std::vector<char> & into_buffer) {
+		into_buffer.clear();
+		const std::optional<Offset> array_offset = translation_cache.translate(VirtualOffset(rva));
+		if (rva == 0 || !array_offset) return;
+		into_buffer.resize(std::min(count, detail::MAX_EXPORT_COUNT) * element_size);
+		into_buffer.resize(image.read(*array_offset, into_buffer.size(), into_buffer.data()).first / element_size * element_size);
+	};
+
+	DWORD name_offset;
+	if (!read_string(export_dir->name, name_offset, _name_size)) _name_size = 0;
+	_ordinal_base = export_dir->base;
+
+	std::vector<char> function_rvas, name_rvas, name_ordinals;
+	read_array(export_dir->address_of_functions, export_dir->number_of_functions, sizeof(DWORD), function_rvas);
+	read_array(export_dir->address_of_names, export_dir->number_of_names, sizeof(DWORD), name_rvas);
+	read_array(export_dir->address_of_name_ordinals, export_dir->number_of_names, sizeof(WORD), name_ordinals);
+
+	_functions.reserve(function_rvas.size() / sizeof(DWORD));
+	for (std::size_t i = 0; i < function_rvas.size(); i += sizeof(DWORD)) {
+		FunctionEntry & function = _functions.emplace_back(FunctionEntry { detail::load_le_value<DWORD>(function_rvas.data() + i), 0, 0 });
+		if (function.rva >= export_begin && function.rva < export_end && !read_string(function.rva, function.forwarder_offset, function.forwarder_size))
+			function.forwarder_size = 0;
+	}
+
+	const std::size_t name_count = std::min(name_rvas.size() / sizeof(DWORD), name_ordinals.size() / sizeof(WORD));
+	_names.reserve(name_count);
+	for (std::size_t i = 0; i < name_count; ++i) {
+		NameEntry name_entry { 0, 0, detail::load_le_value<WORD>(name_ordinals.data() + i * sizeof(WORD)) };
+		if (!read_string(detail::load_le_value<DWORD>(name_rvas.data() + i * sizeof(DWORD)), name_entry.name_offset, name_entry.name_size)
+		 || name_entry.function_index >= _functions.size())
+			name_entry = NameEntry { 0, 0, static_cast<DWORD>(_functions.size()) };
+		_names.push_back(name_entry);
+	}
+
+	_sorted_names.resize(_names.size());
+	for (std::size_t i = 0; i < _sorted_names.size(); ++i)
+		_sorted_names[i] = static_cast<DWORD>(i);
+	std::stable_sort(_sorted_names.begin(), _sorted_names.end(), [this] (DWORD lhs, DWORD rhs) {
+		return name_at(_names[lhs]) < name_at(_names[rhs]);
+	});
+}
+
+inline std::string_view ExportIndex::name() const
+{
+	return string_at(0, _name_size);
+}
+
+inline ULONGLONG ExportIndex::image_base() const
+{
+	return _image_base;
+}
+
+inline DWORD ExportIndex::ordinal_base() const
+{
+	return _ordinal_base;
+}
+
+inline std::size_t ExportIndex::size() const
+{
+	return _functions.size();
+}
+
+inline std::size_t ExportIndex::name_count() const
+{
+	return _names.size();
+}
+
+inline std::optional<ExportEntry> ExportIndex::find(unsigned int ordinal) const
+{
+	if (ordinal < _ordinal_base || ordinal - _ordinal_base >= _functions.size()) return std::nullopt;
+	if (_functions[ordinal - _ordinal_base].rva == 0) return std::nullopt;
+	return make_entry(ordinal - _ordinal_base);
+}
+
+inline std::optional<ExportEntry> ExportIndex::find(std::string_view name, std::optional<WORD> hint) const
+{
+	if (hint && *hint < _names.size() && _names[*hint].function_index < _functions.size() && name_at(_names[*hint]) == name)
+		return make_entry(_names[*hint].function_index);
+
+	const auto sorted_name = std::lower_bound(_sorted_names.begin(), _sorted_names.end(), name,
+	                                          [this] (DWORD name_index, std::string_view value) {
+		return name_at(_names[name_index]) < value;
+	});
+	if (sorted_name == _sorted_names.end() || name_at(_names[*sorted_name]) != name) return std::nullopt;
+	if (_names[*sorted_name].function_index >= _functions.size()) return std::nullopt;
+	return make_entry(_names[*sorted_name].function_index);
+}
+
+inline std::string_view ExportIndex::string_at(DWORD offset, DWORD size) const
+{
+	return std::string_view(_strings).substr(offset, size);
+}
+
+inline std::string_view ExportIndex::name_at(const NameEntry & name_entry) const
+{
+	return string_at(name_entry.name_offset, name_entry.name_size);
+}
+
+inline ExportEntry ExportIndex::make_entry(std::size_t function_index) const
+{
+	const FunctionEntry & function = _functions[function_index];
+	return ExportEntry {
+		static_cast<DWORD>(_ordinal_base + function_index), VirtualOffset(function.rva),
+		function.forwarder_size != 0 ? std::optional(string_at(function.forwarder_offset, function.forwarder_size)) : std::nullopt
+	};
+}
+
+class ModuleSet
+{
+public:
+	using ModuleLoader = std::function<std::shared_ptr<const ExportIndex>(std::string_view module_name)>;
+
+	explicit ModuleSet(ModuleLoader module_loader = {});
+
+	std::shared_ptr<const ExportIndex> add(std::string_view module_name, std::shared_ptr<const ExportIndex> export_index);
+
+	template <unsigned int XX, class Offset, class MemoryBuffer>
+	std::shared_ptr<const ExportIndex> add(std::string_view module_name, const detail::ImageBase<XX, Offset, MemoryBuffer> & image,
+	                                       std::optional<ULONGLONG> image_base = std::nullopt);
+
+	std::shared_ptr<const ExportIndex> find(std::string_view module_name) const;
+	std::size_t size() const;
+
+	ImportBinding resolve(std::string_view module_name, std::string_view symbol_name, std::optional<WORD> hint = std::nullopt) const;
+	ImportBinding resolve(std::string_view module_name, unsigned int ordinal) const;
+	ImportBinding resolve_forwarder(std::string_view forwarder) const;
+
+	std::size_t cached_forwarder_count() const;
+
+	template <unsigned int XX, class Offset, class MemoryBuffer, class Fn>
+	void for_each_binding(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Fn && fn) const;
+
+private:
+	using ModuleMap = std::map<std::string, std::shared_ptr<const ExportIndex>, std::less<>>;
+
+	ImportBinding follow_forwarders(std::shared_ptr<const ExportIndex> module, std::optional<ExportEntry> export_entry,
+	                                std::uint64_t cache_generation) const;
+
+	ModuleLoader                   _module_loader;
+	mutable std::shared_mutex      _mutex;
+	mutable ModuleMap              _modules;
+	mutable detail::ForwarderCache _forwarder_cache;
+};
+
+inline ModuleSet::ModuleSet(ModuleLoader module_loader)
+	: _module_loader { std::move(module_loader) } {}
+
+inline std::shared_ptr<const ExportIndex> ModuleSet::add(std::string_view module_name, std::shared_ptr<const ExportIndex> export_index)
+{
+	const detail::ModuleKey module_key { module_name };
+	if (!module_key.is_valid() || !export_index) throw std::runtime_error("Invalid module");
+
+	const std::unique_lock lock { _mutex };
+	std::shared_ptr<const ExportIndex> & module = _modules[std::string(module_key.view())];
+	module = std::move(export_index);
+	_forwarder_cache.clear();
+	return module;
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::shared_ptr<const ExportIndex> ModuleSet::add(std::string_view module_name, const detail::ImageBase<XX, Offset, MemoryBuffer> & image,
+                                                  std::optional<ULONGLONG> image_base)
+{
+	return add(module_name, std::make_shared<const ExportIndex>(image, image_base));
+}
+
+inline std::shared_ptr<const ExportIndex> ModuleSet::find(std::string_view module_name) const
+{
+	const detail::ModuleKey module_key { module_name };
+	if (!module_key.is_valid()) return nullptr;
+
+	{
+		const std::shared_lock lock { _mutex };
+		if (const auto module = _modules.find(module_key.view()); module != _modules.end())
+			return module->second;
+	}
+	if (!_module_loader) return nullptr;
+
+	std::shared_ptr<const ExportIndex> export_index = _module_loader(module_key.view());
+	const std::unique_lock lock { _mutex };
+	return _modules.try_emplace(std::string(module_key.view()), std::move(export_index)).first->second;
+}
+
+inline std::size_t ModuleSet::size() const
+{
+	const std::shared_lock lock { _mutex };
+	return _modules.size();
+}
+
+inline ImportBinding ModuleSet::resolve(std::string_view module_name, std::string_view symbol_name,
+                                        std::optional<WORD> hint) const
+{
+	const std::uint64_t cache_generation = _forwarder_cache.generation();
+	const std::shared_ptr<const ExportIndex> module = find(module_name);
+	if (!module) return ImportBinding { ImportBindingStatus::ModuleNotFound, nullptr, 0, VirtualOffset(0), 0, 0 };
+	return follow_forwarders(module, module->find(symbol_name, hint), cache_generation);
+}
+
+inline ImportBinding ModuleSet::resolve(std::string_view module_name, unsigned int ordinal) const
+{
+	const std::uint64_t cache_generation = _forwarder_cache.generation();
+	const std::shared_ptr<const ExportIndex> module = find(module_name);
+	if (!module) return ImportBinding { ImportBindingStatus::ModuleNotFound, nullptr, 0, VirtualOffset(0), 0, 0 };
+	return follow_forwarders(module, module->find(ordinal), cache_generation);
+}
+
+inline ImportBinding ModuleSet::resolve_forwarder(std::string_view forwarder) const
+{
+	const std::optional<ForwarderTarget> target = parse_forwarder(forwarder);
+	if (!target) return ImportBinding { ImportBindingStatus::ExportNotFound, nullptr, 0, VirtualOffset(0), 0, 0 };
+	return target->ordinal ? resolve(target->module_name, *target->ordinal) : resolve(target->module_name, target->symbol_name);
+}
+
+inline std::size_t ModuleSet::cached_forwarder_count() const
+{
+	return _forwarder_cache.size();
+}
+
+inline ImportBinding ModuleSet::follow_forwarders(std::shared_ptr<const ExportIndex> module, std::optional<ExportEntry> export_entry,
+                                                 std::uint64_t cache_generation) const
+{
+	std::array<std::pair<std::shared_ptr<const ExportIndex>, DWORD>, detail::MAX_FORWARDER_DEPTH> visited_exports;
+	unsigned int forwarder_count = 0;
+	const auto memoize = [&] (ImportBinding binding) {
+		for (unsigned int i = 0; i < forwarder_count; ++i) {
+			ImportBinding export_binding = binding;
+			export_binding.forwarder_count -= i;
+			_forwarder_cache.insert(visited_exports[i].first, visited_exports[i].second, export_binding, cache_generation);
+		}
+		return binding;
+	};
+
+	for (;;) {
+		if (!export_entry)
+			return memoize(ImportBinding { ImportBindingStatus::ExportNotFound, module, 0, VirtualOffset(0), 0, forwarder_count });
+		if (!export_entry->forwarder) {
+			const ULONGLONG address = module->image_base() + static_cast<ULONGLONG>(export_entry->rva.value());
+			return memoize(ImportBinding { ImportBindingStatus::Bound, module, export_entry->ordinal, export_entry->rva, address, forwarder_count });
+		}
+		if (std::optional<ImportBinding> cached_binding = _forwarder_cache.find(module, export_entry->ordinal, cache_generation)) {
+			cached_binding->forwarder_count += forwarder_count;
+			return memoize(*cached_binding);
+		}
+
+		const auto visited_end = visited_exports.begin() + forwarder_count;
+		if (forwarder_count == visited_exports.size()
+		 || std::find(visited_exports.begin(), visited_end, std::pair(module, export_entry->ordinal)) != visited_end) {
+			const ImportBinding binding { ImportBindingStatus::ForwarderCycle, module, export_entry->ordinal, export_entry->rva, 0, forwarder_count };
+			return memoize(binding);
+		}
+		visited_exports[forwarder_count++] = std::pair(module, export_entry->ordinal);
+
+		const std::optional<ForwarderTarget> target = parse_forwarder(*export_entry->forwarder);
+		if (!target) return memoize(ImportBinding { ImportBindingStatus::ExportNotFound, module, 0, VirtualOffset(0), 0, forwarder_count });
+
+		std::shared_ptr<const ExportIndex> target_module = find(target->module_name);
+		if (!target_module)
+			return memoize(ImportBinding { ImportBindingStatus::ModuleNotFound, nullptr, 0, VirtualOffset(0), 0, forwarder_count });
+
+		module = std::move(target_module);
+		export_entry = target->ordinal ? module->find(*target->ordinal) : module->find(target->symbol_name);
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer, class Fn>
+void ModuleSet::for_each_binding(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Fn && fn) const
+{
+	std::string last_module_name;
+	std::shared_ptr<const ExportIndex> last_module;
+	std::uint64_t cache_generation = 0;
+	const auto bind_import = [&] (const ImportRecord & import_record) {
+		const std::uint64_t current_generation = _forwarder_cache.generation();
+		if (last_module_name.empty() || current_generation != cache_generation
+		 || !detail::equals_ignore_case(import_record.module_name, last_module_name)) {
+			cache_generation = current_generation;
+			last_module_name = import_record.module_name;
+			last_module = find(last_module_name);
+		}
+
+		if (!last_module) {
+			fn(import_record, ImportBinding { ImportBindingStatus::ModuleNotFound, nullptr, 0, VirtualOffset(0), 0, 0 });
+		} else if (import_record.ordinal) {
+			fn(import_record, follow_forwarders(last_module, last_module->find(*import_record.ordinal), cache_generation));
+		} else {
+			fn(import_record, follow_forwarders(last_module, last_module->find(import_record.symbol_name, import_record.hint), cache_generation));
+		}
+	};
+
+	const ImportEnumerator<XX, Offset, MemoryBuffer> import_enumerator { image };
+	import_enumerator.for_each(ImportKind::Regular, bind_import);
+	import_enumerator.for_each(ImportKind::Delayed, bind_import);
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::vector<BoundImportThunk> bind_imports(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, const ModuleSet & module_set)
+{
+	std::vector<BoundImportThunk> bound_thunks;
+	module_set.for_each_binding(image, [&bound_thunks] (const ImportRecord & import_record, const ImportBinding & binding) {
+		if (!import_record.thunk_rva) return;
+		bound_thunks.push_back(BoundImportThunk { import_record.kind, *import_record.thunk_rva, binding.status, binding.address });
+	});
+	return bound_thunks;
+}
+
+}
+
+#endif
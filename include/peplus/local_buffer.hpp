@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <string_view>
 
 namespace peplus {
 
@@ -32,10 +33,16 @@ struct local_buffer
 	static std::size_t read(const LocalBuffer & buffer, std::size_t offset,
 	                        std::size_t data_size, void * into_buffer)
 	{
+		if (offset >= buffer.size()) return 0;
 		const std::size_t bytes_to_read = std::min(buffer.size() - offset, data_size);
-		std::copy_n(buffer.data(), bytes_to_read, static_cast<char *>(into_buffer));
+		std::copy_n(buffer.data() + offset, bytes_to_read, static_cast<char *>(into_buffer));
 		return bytes_to_read;
 	}
+
+	static std::string_view view(const LocalBuffer & buffer)
+	{
+		return std::string_view(buffer.data(), buffer.size());
+	}
 };
 
 template <std::size_t N>
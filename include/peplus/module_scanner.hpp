@@ -0,0 +1,142 @@
+#ifndef PEPLUS_MODULESCANNER_HPP_
+#define PEPLUS_MODULESCANNER_HPP_
+
+#if defined(__linux__)
+
+#include <peplus/process_buffer.hpp>
+#include <peplus/virtual_image.hpp>
+#include <peplus/detail/parallel_for.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace peplus {
+
+struct MemoryRegion
+{
+	std::uintptr_t begin;
+	std::uintptr_t end;
+	std::string    permissions;
+	std::uint64_t  offset;
+	std::string    path;
+};
+
+struct LoadedModule
+{
+	std::uintptr_t base_address;
+	unsigned int   bitness;
+	std::size_t    size_of_image;
+	std::string    path;
+	ProcessMemory  memory;
+
+	template <unsigned int XX>
+	VirtualImage<XX, process_buffer> image() const;
+};
+
+inline std::vector<MemoryRegion> read_memory_regions(pid_t pid)
+{
+	std::ifstream maps_file { "/proc/" + std::to_string(pid) + "/maps" };
+	if (!maps_file) throw std::runtime_error("Unable to read process memory map");
+
+	std::string line;
+	std::vector<MemoryRegion> memory_regions;
+	while (std::getline(maps_file, line)) {
+		MemoryRegion memory_region;
+		std::istringstream line_stream { line };
+		std::string address_range, device, inode;
+		line_stream >> address_range >> memory_region.permissions >> std::hex >> memory_region.offset
+		            >> device >> inode >> std::ws;
+		std::getline(line_stream, memory_region.path);
+
+		const std::size_t dash_pos = address_range.find('-');
+		if (dash_pos == std::string::npos) continue;
+		memory_region.begin = std::stoull(address_range.substr(0, dash_pos), nullptr, 16);
+		memory_region.end = std::stoull(address_range.substr(dash_pos + 1), nullptr, 16);
+		memory_regions.push_back(std::move(memory_region));
+	}
+
+	return memory_regions;
+}
+
+template <unsigned int XX>
+VirtualImage<XX, process_buffer> LoadedModule::image() const
+{
+	if (bitness != XX) throw std::runtime_error("Image bitness mismatch");
+	return VirtualImage<XX, process_buffer>(memory);
+}
+
+namespace detail {
+
+inline bool probe_loaded_module(const ProcessMemory & memory, const MemoryRegion & memory_region,
+                                LoadedModule & loaded_module)
+{
+	const ProcessMemory module_memory = memory.rebased(memory_region.begin);
+
+	unsigned int bitness = 0;
+	if (VirtualImage<64, process_buffer>::is_valid(module_memory))
+		bitness = 64;
+	else if (VirtualImage<32, process_buffer>::is_valid(module_memory))
+		bitness = 32;
+	else
+		return false;
+
+	loaded_module.base_address = memory_region.begin;
+	loaded_module.bitness = bitness;
+	loaded_module.size_of_image = bitness == 64 ? VirtualImage<64, process_buffer>(module_memory).optional_header().size_of_image
+	                                            : VirtualImage<32, process_buffer>(module_memory).optional_header().size_of_image;
+	loaded_module.path = memory_region.path;
+	loaded_module.memory = module_memory;
+	return true;
+}
+
+}
+
+inline std::vector<LoadedModule> scan_process_modules(pid_t pid, unsigned int thread_count = std::thread::hardware_concurrency())
+{
+	std::vector<MemoryRegion> candidates = read_memory_regions(pid);
+	candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [] (const MemoryRegion & memory_region) {
+		return memory_region.permissions.empty() || memory_region.permissions[0] != 'r'
+		    || memory_region.path == "[vvar]" || memory_region.path == "[vsyscall]";
+	}), candidates.end());
+
+	const std::size_t worker_count = std::max<std::size_t>(1, std::min<std::size_t>(thread_count, candidates.size()));
+	std::vector<std::optional<LoadedModule>> candidate_modules (candidates.size());
+	detail::parallel_for(worker_count, thread_count, [&] (std::size_t worker) {
+		const ProcessMemory memory { pid };
+		for (std::size_t i = worker; i < candidates.size(); i += worker_count) {
+			LoadedModule loaded_module { 0, 0, 0, {}, memory };
+			if (detail::probe_loaded_module(memory, candidates[i], loaded_module))
+				candidate_modules[i] = std::move(loaded_module);
+		}
+	});
+
+	std::vector<LoadedModule> loaded_modules;
+	for (std::optional<LoadedModule> & loaded_module : candidate_modules)
+		if (loaded_module) loaded_modules.push_back(std::move(*loaded_module));
+
+	std::sort(loaded_modules.begin(), loaded_modules.end(), [] (const LoadedModule & lhs, const LoadedModule & rhs) {
+		return lhs.base_address < rhs.base_address;
+	});
+
+	const ProcessMemory shared_memory { pid };
+	for (LoadedModule & loaded_module : loaded_modules)
+		loaded_module.memory = shared_memory.rebased(loaded_module.base_address);
+
+	return loaded_modules;
+}
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef PEPLUS_PROCESSBUFFER_HPP_
+#define PEPLUS_PROCESSBUFFER_HPP_
+
+#if defined(__linux__)
+
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace peplus {
+
+class ProcessMemory
+{
+public:
+	static constexpr std::size_t CACHE_PAGES = 32;
+	static constexpr std::size_t MAX_CACHED_READ = 4 * detail::MEMORY_PAGE_SIZE;
+
+	explicit ProcessMemory(pid_t pid, std::uintptr_t base_address = 0);
+
+	pid_t pid() const;
+	std::uintptr_t base_address() const;
+	ProcessMemory rebased(std::uintptr_t base_address) const;
+
+	std::size_t read(std::size_t offset, std::size_t size, void * into_buffer) const;
+	void invalidate() const;
+
+private:
+	struct CachedPage
+	{
+		std::uintptr_t                      address;
+		bool                                valid;
+		std::array<char, detail::MEMORY_PAGE_SIZE> data;
+	};
+
+	struct SharedState
+	{
+		explicit SharedState(pid_t pid);
+		~SharedState();
+
+		std::size_t read_remote(const iovec * local, const std::uintptr_t * addresses, std::size_t count);
+		std::size_t read_remote_pages(const iovec * local, const std::uintptr_t * addresses, std::size_t count);
+		std::size_t read_proc_mem(const iovec * local, const std::uintptr_t * addresses, std::size_t count);
+
+		pid_t                                pid;
+		int                                  mem_fd = -1;
+		bool                                 use_proc_mem = false;
+		std::mutex                           mutex;
+		std::array<CachedPage, CACHE_PAGES>  pages {};
+	};
+
+	std::shared_ptr<SharedState> _state;
+	std::uintptr_t               _base_address;
+};
+
+struct process_buffer
+{
+	using value_type = ProcessMemory;
+
+	static std::size_t read(const ProcessMemory & memory, std::size_t offset,
+	                        std::size_t data_size, void * into_buffer)
+	{
+		return memory.read(offset, data_size, into_buffer);
+	}
+};
+
+inline ProcessMemory::SharedState::SharedState(pid_t pid)
+	: pid { pid } {}
+
+inline ProcessMemory::SharedState::~SharedState()
+{
+	if (mem_fd >= 0) ::close(mem_fd);
+}
+
+inline std::size_t ProcessMemory::SharedState::read_remote(const iovec * local, const std::uintptr_t * addresses,
+                                                           std::size_t count)
+{
+	if (!use_proc_mem) {
+		std::size_t total_size = 0;
+		std::vector<iovec> remote;
+		remote.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			total_size += local[i].iov_len;
+			if (!remote.empty() && reinterpret_cast<std::uintptr_t>(remote.back().iov_base) + remote.back().iov_len == addresses[i])
+				remote.back().iov_len += local[i].iov_len;
+			else
+				remote.push_back(iovec { reinterpret_cast<void *>(addresses[i]), local[i].iov_len });
+		}
+
+		const ssize_t bytes_read = ::process_vm_readv(pid, local, count, remote.data(), remote.size(), 0);
+		if (bytes_read >= 0 && static_cast<std::size_t>(bytes_read) == total_size) return total_size;
+		if (bytes_read >= 0 || (errno != ENOSYS && errno != EPERM))
+			return read_remote_pages(local, addresses, count);
+		use_proc_mem = true;
+	}
+
+	return read_proc_mem(local, addresses, count);
+}
+
+inline std::size_t ProcessMemory::SharedState::read_remote_pages(const iovec * local, const std::uintptr_t * addresses,
+                                                                 std::size_t count)
+{
+	std::size_t total_read = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		for (std::size_t offset = 0; offset < local[i].iov_len; ) {
+			const std::uintptr_t address = addresses[i] + offset;
+			const std::size_t chunk_size = std::min(local[i].iov_len - offset, detail::MEMORY_PAGE_SIZE - address % detail::MEMORY_PAGE_SIZE);
+			const iovec local_chunk { static_cast<char *>(local[i].iov_base) + offset, chunk_size };
+			const iovec remote_chunk { reinterpret_cast<void *>(address), chunk_size };
+			const ssize_t bytes_read = ::process_vm_readv(pid, &local_chunk, 1, &remote_chunk, 1, 0);
+			if (bytes_read <= 0) return total_read;
+			total_read += static_cast<std::size_t>(bytes_read);
+			if (static_cast<std::size_t>(bytes_read) < chunk_size) return total_read;
+			offset += chunk_size;
+		}
+	}
+
+	return total_read;
+}
+
+inline std::size_t ProcessMemory::SharedState::read_proc_mem(const iovec * local, const std::uintptr_t * addresses,
+                                                             std::size_t count)
+{
+	if (mem_fd < 0) {
+		const std::string mem_path = "/proc/" + std::to_string(pid) + "/mem";
+		mem_fd = ::open(mem_path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (mem_fd < 0) return 0;
+	}
+
+	std::size_t total_read = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		const ssize_t bytes_read = ::pread(mem_fd, local[i].iov_base, local[i].iov_len, static_cast<off_t>(addresses[i]));
+		if (bytes_read <= 0) break;
+		total_read += static_cast<std::size_t>(bytes_read);
+		if (static_cast<std::size_t>(bytes_read) < local[i].iov_len) break;
+	}
+
+	return total_read;
+}
+
+inline ProcessMemory::ProcessMemory(pid_t pid, std::uintptr_t base_address)
+	: _state { std::make_shared<SharedState>(pid) }, _base_address { base_address } {}
+
+inline pid_t ProcessMemory::pid() const
+{
+	return _state->pid;
+}
+
+inline std::uintptr_t ProcessMemory::base_address() const
+{
+	return _base_address;
+}
+
+inline ProcessMemory ProcessMemory::rebased(std::uintptr_t base_address) const
+{
+	ProcessMemory memory { *this };
+	memory._base_address = base_address;
+	return memory;
+}
+
+inline std::size_t ProcessMemory::read(std::size_t offset, std::size_t size, void * into_buffer) const
+{
+	if (size == 0) return 0;
+
+	const std::uintptr_t address = _base_address + offset;
+	std::lock_guard<std::mutex> lock { _state->mutex };
+
+	if (size > MAX_CACHED_READ) {
+		const iovec local { into_buffer, size };
+		return _state->read_remote(&local, &address, 1);
+	}
+
+	const std::uintptr_t first_page = address & ~(detail::MEMORY_PAGE_SIZE - 1);
+	const std::uintptr_t last_page = (address + size - 1) & ~(detail::MEMORY_PAGE_SIZE - 1);
+
+	std::size_t missing_count = 0;
+	std::array<iovec, MAX_CACHED_READ / detail::MEMORY_PAGE_SIZE + 1> missing_local;
+	std::array<std::uintptr_t, MAX_CACHED_READ / detail::MEMORY_PAGE_SIZE + 1> missing_addresses;
+	std::array<CachedPage *, MAX_CACHED_READ / detail::MEMORY_PAGE_SIZE + 1> missing_pages;
+	for (std::uintptr_t page = first_page; page <= last_page; page += detail::MEMORY_PAGE_SIZE) {
+		CachedPage & cached_page = _state->pages[(page / detail::MEMORY_PAGE_SIZE) % CACHE_PAGES];
+		if (cached_page.valid && cached_page.address == page) continue;
+
+		cached_page.valid = false;
+		cached_page.address = page;
+		missing_local[missing_count] = iovec { cached_page.data.data(), detail::MEMORY_PAGE_SIZE };
+		missing_addresses[missing_count] = page;
+		missing_pages[missing_count++] = &cached_page;
+	}
+
+	if (missing_count != 0) {
+		const std::size_t bytes_read = _state->read_remote(missing_local.data(), missing_addresses.data(), missing_count);
+		for (std::size_t i = 0; i < missing_count && (i + 1) * detail::MEMORY_PAGE_SIZE <= bytes_read; ++i)
+			missing_pages[i]->valid = true;
+	}
+
+	std::size_t bytes_copied = 0;
+	for (std::uintptr_t page = first_page; page <= last_page; page += detail::MEMORY_PAGE_SIZE) {
+		const CachedPage & cached_page = _state->pages[(page / detail::MEMORY_PAGE_SIZE) % CACHE_PAGES];
+		if (!cached_page.valid) break;
+
+		const std::size_t page_offset = page == first_page ? address - first_page : 0;
+		const std::size_t chunk_size = std::min(detail::MEMORY_PAGE_SIZE - page_offset, size - bytes_copied);
+		std::memcpy(static_cast<char *>(into_buffer) + bytes_copied, cached_page.data.data() + page_offset, chunk_size);
+		bytes_copied += chunk_size;
+	}
+
+	return bytes_copied;
+}
+
+inline void ProcessMemory::invalidate() const
+{
+	std::lock_guard<std::mutex> lock { _state->mutex };
+	for (CachedPage & cached_page : _state->pages)
+		cached_page.valid = false;
+}
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef PEPLUS_RELOCATIONINDEX_HPP_
+#define PEPLUS_RELOCATIONINDEX_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+#include <peplus/detail/image_base.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace peplus {
+
+class RelocationIndex
+{
+public:
+	static constexpr std::size_t WORDS_PER_PAGE = detail::MEMORY_PAGE_SIZE / 64;
+
+	using PageMask = std::array<std::uint64_t, WORDS_PER_PAGE>;
+
+	RelocationIndex() = default;
+
+	template <unsigned int XX, class Offset, class MemoryBuffer>
+	explicit RelocationIndex(const detail::ImageBase<XX, Offset, MemoryBuffer> & image);
+
+	bool empty() const;
+	std::size_t size() const;
+
+	bool contains(VirtualOffset rva) const;
+	bool overlaps(VirtualOffset rva, std::size_t size) const;
+
+	const PageMask * page_mask(VirtualOffset rva) const;
+	void mask_bytes(VirtualOffset rva, void * data, std::size_t size, char fill = 0) const;
+
+private:
+	static constexpr std::uint32_t NO_PAGE = std::numeric_limits<std::uint32_t>::max();
+
+	void insert(std::size_t rva, std::size_t size);
+	PageMask & page_mask_for_insert(std::size_t page);
+
+	std::vector<std::uint32_t> _page_slots;
+	std::vector<PageMask>      _page_masks;
+	std::size_t                _relocation_count = 0;
+};
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+RelocationIndex::RelocationIndex(const detail::ImageBase<XX, Offset, MemoryBuffer> & image)
+{
+	_page_slots.assign(image.optional_header().size_of_image / detail::MEMORY_PAGE_SIZE + 1, NO_PAGE);
+
+	std::vector<WORD> type_offsets;
+	for (const auto & reloc_block : image.base_relocations()) {
+		type_offsets.resize(reloc_block.number_of_entries());
+		reloc_block.read_type_offsets(type_offsets.data());
+
+		for (std::size_t i = 0; i < type_offsets.size(); ++i) {
+			const std::size_t target_rva = reloc_block.virtual_address + (type_offsets[i] & (detail::MEMORY_PAGE_SIZE - 1));
+			switch (type_offsets[i] >> 12) {
+				case REL_BASED_ABSOLUTE: break;
+				case REL_BASED_HIGHADJ:  insert(target_rva, sizeof(WORD)); ++i; break;
+				case REL_BASED_HIGHLOW:  insert(target_rva, sizeof(DWORD)); break;
+				case REL_BASED_DIR64:    insert(target_rva, sizeof(QWORD)); break;
+				default:                 insert(target_rva, sizeof(WORD)); break;
+			}
+		}
+	}
+}
+
+inline bool RelocationIndex::empty() const
+{
+	return _relocation_count == 0;
+}
+
+inline std::size_t RelocationIndex::size() const
+{
+	return _relocation_count;
+}
+
+inline bool RelocationIndex::contains(VirtualOffset rva) const
+{
+	const PageMask * const mask = page_mask(rva);
+	if (!mask) return false;
+
+	const std::size_t bit = static_cast<std::size_t>(rva.value()) % detail::MEMORY_PAGE_SIZE;
+	return ((*mask)[bit / 64] >> (bit % 64) & 1) != 0;
+}
+
+inline bool RelocationIndex::overlaps(VirtualOffset rva, std::size_t size) const
+{
+	if (rva.value() < 0) return false;
+
+	std::size_t begin = static_cast<std::size_t>(rva.value());
+	const std::size_t indexed_end = _page_slots.size() * detail::MEMORY_PAGE_SIZE;
+	if (begin >= indexed_end) return false;
+	const std::size_t end = begin + std::min(size, indexed_end - begin);
+	while (begin < end) {
+		const std::size_t page_end = (begin / detail::MEMORY_PAGE_SIZE + 1) * detail::MEMORY_PAGE_SIZE;
+		const std::size_t chunk_end = end < page_end ? end : page_end;
+		if (const PageMask * const mask = page_mask(VirtualOffset(begin))) {
+			for (std::size_t bit = begin % detail::MEMORY_PAGE_SIZE, last = (chunk_end - 1) % detail::MEMORY_PAGE_SIZE; bit <= last; ) {
+				const std::size_t word_last = bit | 63;
+				const std::size_t hi = word_last < last ? 63 : last % 64;
+				const std::uint64_t word_mask = (~std::uint64_t(0) >> (63 - hi)) & (~std::uint64_t(0) << (bit % 64));
+				if (((*mask)[bit / 64] & word_mask) != 0) return true;
+				bit = word_last + 1;
+			}
+		}
+		begin = chunk_end;
+	}
+
+	return false;
+}
+
+inline auto RelocationIndex::page_mask(VirtualOffset rva) const -> const PageMask *
+{
+	if (rva.value() < 0) return nullptr;
+
+	const std::size_t page = static_cast<std::size_t>(rva.value()) / detail::MEMORY_PAGE_SIZE;
+	if (page >= _page_slots.size() || _page_slots[page] == NO_PAGE) return nullptr;
+	return &_page_masks[_page_slots[page]];
+}
+
+inline void RelocationIndex::mask_bytes(VirtualOffset rva, void * data, std::size_t size, char fill) const
+{
+	char * const bytes = static_cast<char *>(data);
+	for (std::size_t i = 0; i < size; ) {
+		const std::size_t byte_rva = static_cast<std::size_t>(rva.value()) + i;
+		const std::size_t chunk_size = std::min(size - i, detail::MEMORY_PAGE_SIZE - byte_rva % detail::MEMORY_PAGE_SIZE);
+		if (const PageMask * const mask = page_mask(VirtualOffset(byte_rva))) {
+			for (std::size_t j = 0; j < chunk_size; ++j) {
+				const std::size_t bit = (byte_rva + j) % detail::MEMORY_PAGE_SIZE;
+				if (((*mask)[bit / 64] >> (bit % 64) & 1) != 0)
+					bytes[i + j] = fill;
+			}
+		}
+		i += chunk_size;
+	}
+}
+
+inline void RelocationIndex::insert(std::size_t rva, std::size_t size)
+{
+	for (std::size_t byte_rva = rva; byte_rva < rva + size; ++byte_rva) {
+		const std::size_t bit = byte_rva % detail::MEMORY_PAGE_SIZE;
+		page_mask_for_insert(byte_rva / detail::MEMORY_PAGE_SIZE)[bit / 64] |= std::uint64_t(1) << (bit % 64);
+	}
+	++_relocation_count;
+}
+
+inline auto RelocationIndex::page_mask_for_insert(std::size_t page) -> PageMask &
+{
+	if (page >= _page_slots.size())
+		_page_slots.resize(page + 1, NO_PAGE);
+
+	if (_page_slots[page] == NO_PAGE) {
+		_page_slots[page] = static_cast<std::uint32_t>(_page_masks.size());
+		_page_masks.emplace_back();
+	}
+
+	return _page_masks[_page_slots[page]];
+}
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef PEPLUS_SECTIONSTATISTICS_HPP_
+#define PEPLUS_SECTIONSTATISTICS_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/parallel_for.hpp>
+#include <peplus/detail/simd_support.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace peplus {
+
+struct ByteStatistics
+{
+	std::array<std::uint64_t, 256> histogram;
+	std::uint64_t                  size;
+	double                         entropy;
+	std::uint64_t                  hash;
+};
+
+struct SectionStatistics
+{
+	SectionHeader  section_header;
+	ByteStatistics statistics;
+};
+
+namespace detail {
+
+const std::size_t STATISTICS_CHUNK_SIZE = 0x10000;
+const std::size_t STATISTICS_PARALLEL_THRESHOLD = 0x100000;
+
+class ByteStatisticsBuilder
+{
+public:
+	static constexpr std::uint64_t HASH_MULTIPLIER = 0xc6a4a7935bd1e995;
+	static constexpr unsigned int  HASH_SHIFT = 47;
+
+	void update(const char * data, std::size_t size);
+	ByteStatistics finish() const;
+
+private:
+	using PartialHistograms = std::array<std::array<std::uint32_t, 256>, 4>;
+
+	static void count_words(PartialHistograms & partial_histograms, const char * data, std::size_t size);
+	void count_bytes(const char * data, std::size_t size);
+	void hash_bytes(const char * data, std::size_t size);
+	void hash_word(QWORD word);
+
+	std::array<std::uint64_t, 256> _histogram {};
+	std::uint64_t                  _size = 0;
+	std::uint64_t                  _hash = 0;
+	std::array<char, 8>            _pending {};
+	std::size_t                    _pending_size = 0;
+};
+
+inline void ByteStatisticsBuilder::update(const char * data, std::size_t size)
+{
+	count_bytes(data, size);
+	hash_bytes(data, size);
+	_size += size;
+}
+
+inline ByteStatistics ByteStatisticsBuilder::finish() const
+{
+	double entropy = 0;
+	for (std::uint64_t count : _histogram) {
+		if (count == 0) continue;
+		const double probability = static_cast<double>(count) / static_cast<double>(_size);
+		entropy -= probability * std::log2(probability);
+	}
+
+	std::uint64_t hash = _hash;
+	if (_pending_size != 0) {
+		for (std::size_t i = 0; i < _pending_size; ++i)
+			hash ^= std::uint64_t(static_cast<BYTE>(_pending[i])) << (8 * i);
+		hash *= HASH_MULTIPLIER;
+	}
+
+	hash ^= _size * HASH_MULTIPLIER;
+	hash ^= hash >> HASH_SHIFT;
+	hash *= HASH_MULTIPLIER;
+	hash ^= hash >> HASH_SHIFT;
+	return ByteStatistics { _histogram, _size, entropy, hash };
+}
+
+inline void ByteStatisticsBuilder::count_words(PartialHistograms & partial_histograms, const char * data, std::size_t size)
+{
+	for (std::size_t offset = 0; offset + 8 <= size; offset += 8) {
+		const QWORD bytes = load_le_value<QWORD>(data + offset);
+		++partial_histograms[0][bytes       & 0xff];
+		++partial_histograms[1][bytes >>  8 & 0xff];
+		++partial_histograms[2][bytes >> 16 & 0xff];
+		++partial_histograms[3][bytes >> 24 & 0xff];
+		++partial_histograms[0][bytes >> 32 & 0xff];
+		++partial_histograms[1][bytes >> 40 & 0xff];
+		++partial_histograms[2][bytes >> 48 & 0xff];
+		++partial_histograms[3][bytes >> 56       ];
+	}
+}
+
+inline void ByteStatisticsBuilder::count_bytes(const char * data, std::size_t size)
+{
+	PartialHistograms partial_histograms {};
+
+	std::size_t offset = 0;
+#if defined(PEPLUS_HAS_AVX2)
+	for (; offset + 32 <= size; offset += 32) {
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + offset));
+		const __m256i first_byte = _mm256_set1_epi8(data[offset]);
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, first_byte)) == -1)
+			partial_histograms[0][static_cast<BYTE>(data[offset])] += 32;
+		else
+			count_words(partial_histograms, data + offset, 32);
+	}
+#elif defined(PEPLUS_HAS_SSE2)
+	for (; offset + 16 <= size; offset += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset));
+		const __m128i first_byte = _mm_set1_epi8(data[offset]);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, first_byte)) == 0xffff)
+			partial_histograms[0][static_cast<BYTE>(data[offset])] += 16;
+		else
+			count_words(partial_histograms, data + offset, 16);
+	}
+#endif
+	count_words(partial_histograms, data + offset, size - offset);
+	for (offset += (size - offset) / 8 * 8; offset < size; ++offset)
+		++partial_histograms[0][static_cast<BYTE>(data[offset])];
+
+	for (std::size_t value = 0; value < 256; ++value) {
+		_histogram[value] += partial_histograms[0][value] + partial_histograms[1][value]
+		                   + partial_histograms[2][value] + partial_histograms[3][value];
+	}
+}
+
+inline void ByteStatisticsBuilder::hash_bytes(const char * data, std::size_t size)
+{
+	std::size_t offset = 0;
+	if (_pending_size != 0) {
+		offset = std::min(size, _pending.size() - _pending_size);
+		std::memcpy(_pending.data() + _pending_size, data, offset);
+		_pending_size += offset;
+		if (_pending_size < _pending.size()) return;
+		hash_word(load_le_value<QWORD>(_pending.data()));
+		_pending_size = 0;
+	}
+
+	for (; offset + 8 <= size; offset += 8)
+		hash_word(load_le_value<QWORD>(data + offset));
+
+	_pending_size = size - offset;
+	std::memcpy(_pending.data(), data + offset, _pending_size);
+}
+
+inline void ByteStatisticsBuilder::hash_word(QWORD word)
+{
+	word *= HASH_MULTIPLIER;
+	word ^= word >> HASH_SHIFT;
+	word *= HASH_MULTIPLIER;
+	_hash ^= word;
+	_hash *= HASH_MULTIPLIER;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+ByteStatistics section_byte_statistics(const FileImage<XX, MemoryBuffer> & image, const SectionHeader & section_header)
+{
+	const std::size_t section_offset = section_header.pointer_to_raw_data;
+	const std::size_t section_size = section_header.size_of_raw_data;
+
+	const std::optional<std::string_view> image_view = image.view();
+	if (image_view) {
+		const std::string_view section_data = section_offset < image_view->size() ? image_view->substr(section_offset, section_size)
+		                                                                          : std::string_view();
+		ByteStatisticsBuilder statistics_builder;
+		for (std::size_t offset = 0; offset < section_data.size(); offset += STATISTICS_CHUNK_SIZE)
+			statistics_builder.update(section_data.data() + offset, std::min(STATISTICS_CHUNK_SIZE, section_data.size() - offset));
+		return statistics_builder.finish();
+	}
+
+	ByteStatisticsBuilder statistics_builder;
+	std::vector<char> chunk (std::min(STATISTICS_CHUNK_SIZE, section_size));
+	for (std::size_t offset = 0; offset < section_size; offset += STATISTICS_CHUNK_SIZE) {
+		const std::size_t chunk_size = std::min(STATISTICS_CHUNK_SIZE, section_size - offset);
+		const std::size_t bytes_read = image.read(FileOffset(section_offset + offset), chunk_size, chunk.data()).first;
+		statistics_builder.update(chunk.data(), bytes_read);
+		if (bytes_read < chunk_size) break;
+	}
+	return statistics_builder.finish();
+}
+
+}
+
+inline ByteStatistics byte_statistics(const void * data, std::size_t size)
+{
+	const char * const bytes = static_cast<const char *>(data);
+	detail::ByteStatisticsBuilder statistics_builder;
+	for (std::size_t offset = 0; offset < size; offset += detail::STATISTICS_CHUNK_SIZE)
+		statistics_builder.update(bytes + offset, std::min(detail::STATISTICS_CHUNK_SIZE, size - offset));
+	return statistics_builder.finish();
+}
+
+template <unsigned int XX, class MemoryBuffer>
+std::vector<SectionStatistics> section_statistics(const FileImage<XX, MemoryBuffer> & image,
+                                                  unsigned int thread_count = std::thread::hardware_concurrency())
+{
+	std::vector<SectionStatistics> section_statistics;
+	std::size_t total_size = 0;
+	for (const auto & section_header : image.section_headers()) {
+		section_statistics.push_back(SectionStatistics { section_header, {} });
+		total_size += section_header.size_of_raw_data;
+	}
+
+	if (total_size < detail::STATISTICS_PARALLEL_THRESHOLD) thread_count = 1;
+	detail::parallel_for(section_statistics.size(), thread_count, [&] (std::size_t i) {
+		section_statistics[i].statistics = detail::section_byte_statistics(image, section_statistics[i].section_header);
+	});
+
+	return section_statistics;
+}
+
+}
+
+#endif
@@ -0,0 +1,338 @@
+#ifndef PEPLUS_SIGNATURESCANNER_HPP_
+#define PEPLUS_SIGNATURESCANNER_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+#include <peplus/detail/image_base.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace peplus {
+
+struct SignatureMatch
+{
+	std::size_t               signature;
+	std::optional<FileOffset> file_offset;
+	VirtualOffset             rva;
+	std::size_t               section_index;
+	std::string               section_name;
+};
+
+namespace detail {
+
+const std::size_t MAX_SIGNATURE_ANCHOR_SIZE = 8;
+const std::size_t MAX_DENSE_SIGNATURE_STATES = 0x400;
+
+inline int parse_hex_digit(char digit)
+{
+	if (digit >= '0' && digit <= '9') return digit - '0';
+	if (digit >= 'a' && digit <= 'f') return digit - 'a' + 10;
+	if (digit >= 'A' && digit <= 'F') return digit - 'A' + 10;
+	return -1;
+}
+
+}
+
+class SignatureScanner
+{
+public:
+	SignatureScanner() = default;
+
+	std::size_t add(std::string_view pattern, DWORD section_characteristics = 0);
+
+	void compile();
+
+	bool empty() const;
+	std::size_t size() const;
+	bool is_compiled() const;
+
+	template <class Fn>
+	void for_each_match(std::string_view data, Fn && fn) const;
+
+	template <unsigned int XX, class Offset, class MemoryBuffer, class Fn>
+	void for_each_match(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Fn && fn) const;
+
+	template <unsigned int XX, class Offset, class MemoryBuffer>
+	std::vector<SignatureMatch> scan(const detail::ImageBase<XX, Offset, MemoryBuffer> & image) const;
+
+private:
+	struct Signature
+	{
+		std::size_t data_offset;
+		std::size_t size;
+		std::size_t anchor_offset;
+		std::size_t anchor_size;
+		DWORD       section_characteristics;
+	};
+
+	static constexpr DWORD ROOT_STATE = 0;
+
+	DWORD next_state(DWORD state, BYTE value) const;
+	bool matches(const Signature & signature, const char * data) const;
+
+	template <class Fn>
+	void scan_data(std::string_view data, DWORD section_characteristics, Fn && fn) const;
+
+	std::vector<Signature>       _signatures;
+	std::vector<BYTE>            _values;
+	std::vector<BYTE>            _masks;
+	bool                         _compiled = false;
+
+	std::size_t                  _dense_state_count = 0;
+	std::vector<DWORD>           _dense_transitions;
+	std::vector<DWORD>           _child_begin;
+	std::vector<BYTE>            _child_values;
+	std::vector<DWORD>           _child_states;
+	std::vector<DWORD>           _failure_links;
+	std::vector<DWORD>           _output_links;
+	std::vector<DWORD>           _output_begin;
+	std::vector<DWORD>           _outputs;
+};
+
+inline std::size_t SignatureScanner::add(std::string_view pattern, DWORD section_characteristics)
+{
+	std::vector<BYTE> values, masks;
+	for (std::size_t pos = 0; pos < pattern.size(); ) {
+		if (pattern[pos] == ' ') { ++pos; continue; }
+
+		const std::string_view token = pattern.substr(pos, pattern.find(' ', pos) - pos);
+		pos += token.size();
+
+		BYTE value = 0, mask = 0;
+		if (token != "?" && token != "??") {
+			if (token.size() != 2) throw std::runtime_error("Invalid signature pattern");
+			for (const char digit : token) {
+				const int nibble = detail::parse_hex_digit(digit);
+				if (nibble < 0 && digit != '?') throw std::runtime_error("Invalid signature pattern");
+				value = static_cast<BYTE>(value << 4 | (nibble >= 0 ? nibble : 0));
+				mask = static_cast<BYTE>(mask << 4 | (nibble >= 0 ? 0xf : 0));
+			}
+		}
+		values.push_back(value);
+		masks.push_back(mask);
+	}
+
+	Signature signature { _values.size(), values.size(), 0, 0, section_characteristics };
+	for (std::size_t run_begin = 0; run_begin < signature.size; ) {
+		if (masks[run_begin] != 0xff) { ++run_begin; continue; }
+
+		std::size_t run_end = run_begin;
+		while (run_end < signature.size && masks[run_end] == 0xff) ++run_end;
+		if (run_end - run_begin > signature.anchor_size) {
+			signature.anchor_offset = run_begin;
+			signature.anchor_size = std::min(run_end - run_begin, detail::MAX_SIGNATURE_ANCHOR_SIZE);
+		}
+		run_begin = run_end;
+	}
+
+	if (signature.anchor_size == 0) throw std::runtime_error("Invalid signature pattern");
+
+	_values.insert(_values.end(), values.begin(), values.end());
+	_masks.insert(_masks.end(), masks.begin(), masks.end());
+	_signatures.push_back(signature);
+	_compiled = false;
+	return _signatures.size() - 1;
+}
+
+inline void SignatureScanner::compile()
+{
+	std::vector<std::vector<std::pair<BYTE, DWORD>>> trie_transitions (1);
+	std::vector<std::vector<DWORD>> trie_outputs (1);
+
+	for (std::size_t i = 0; i < _signatures.size(); ++i) {
+		const Signature & signature = _signatures[i];
+		DWORD state = ROOT_STATE;
+		for (std::size_t j = 0; j < signature.anchor_size; ++j) {
+			const BYTE value = _values[signature.data_offset + signature.anchor_offset + j];
+			auto & children = trie_transitions[state];
+			const auto child = std::find_if(children.begin(), children.end(), [value] (const auto & child) {
+				return child.first == value;
+			});
+			if (child != children.end()) {
+				state = child->second;
+			} else {
+				const auto new_state = static_cast<DWORD>(trie_transitions.size());
+				children.emplace_back(value, new_state);
+				trie_transitions.emplace_back();
+				trie_outputs.emplace_back();
+				state = new_state;
+			}
+		}
+		trie_outputs[state].push_back(static_cast<DWORD>(i));
+	}
+
+	const std::size_t state_count = trie_transitions.size();
+	std::vector<DWORD> state_order { ROOT_STATE }, state_ids (state_count);
+	state_order.reserve(state_count);
+	for (std::size_t i = 0; i < state_order.size(); ++i) {
+		auto & children = trie_transitions[state_order[i]];
+		std::sort(children.begin(), children.end());
+		for (const auto & child : children) {
+			state_ids[child.second] = static_cast<DWORD>(state_order.size());
+			state_order.push_back(child.second);
+		}
+	}
+
+	_child_begin.assign(state_count + 1, 0);
+	_child_values.clear();
+	_child_states.clear();
+	_output_begin.assign(state_count + 1, 0);
+	_outputs.clear();
+	for (std::size_t state = 0; state < state_count; ++state) {
+		_child_begin[state] = static_cast<DWORD>(_child_values.size());
+		for (const auto & [value, child_state] : trie_transitions[state_order[state]]) {
+			_child_values.push_back(value);
+			_child_states.push_back(state_ids[child_state]);
+		}
+		_output_begin[state] = static_cast<DWORD>(_outputs.size());
+		_outputs.insert(_outputs.end(), trie_outputs[state_order[state]].begin(), trie_outputs[state_order[state]].end());
+	}
+	_child_begin[state_count] = static_cast<DWORD>(_child_values.size());
+	_output_begin[state_count] = static_cast<DWORD>(_outputs.size());
+
+	_dense_state_count = std::min(state_count, detail::MAX_DENSE_SIGNATURE_STATES);
+	_dense_transitions.assign(_dense_state_count * 256, ROOT_STATE);
+	_failure_links.assign(state_count, ROOT_STATE);
+	_output_links.assign(state_count, ROOT_STATE);
+
+	for (std::size_t state = 0; state < state_count; ++state) {
+		if (state < _dense_state_count) {
+			DWORD * const dense_row = _dense_transitions.data() + state * 256;
+			if (state != ROOT_STATE)
+				std::copy_n(_dense_transitions.data() + _failure_links[state] * 256, 256, dense_row);
+			for (DWORD i = _child_begin[state]; i < _child_begin[state + 1]; ++i)
+				dense_row[_child_values[i]] = _child_states[i];
+		}
+
+		for (DWORD i = _child_begin[state]; i < _child_begin[state + 1]; ++i) {
+			const DWORD child_state = _child_states[i];
+			const DWORD failure_state = state == ROOT_STATE ? ROOT_STATE : next_state(_failure_links[state], _child_values[i]);
+			_failure_links[child_state] = failure_state;
+			_output_links[child_state] = _output_begin[failure_state] != _output_begin[failure_state + 1] ? failure_state
+			                                                                                             : _output_links[failure_state];
+		}
+	}
+
+	_compiled = true;
+}
+
+inline bool SignatureScanner::empty() const
+{
+	return _signatures.empty();
+}
+
+inline std::size_t SignatureScanner::size() const
+{
+	return _signatures.size();
+}
+
+inline bool SignatureScanner::is_compiled() const
+{
+	return _compiled;
+}
+
+template <class Fn>
+void SignatureScanner::for_each_match(std::string_view data, Fn && fn) const
+{
+	scan_data(data, ~DWORD(0), [&fn] (std::size_t signature, std::size_t offset) {
+		fn(signature, offset);
+	});
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer, class Fn>
+void SignatureScanner::for_each_match(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Fn && fn) const
+{
+	std::string section_buffer;
+	std::size_t section_index = 0;
+	for (const auto & section_header : image.section_headers()) {
+		const std::size_t current_index = section_index++;
+		const DWORD characteristics = section_header.characteristics;
+		if (std::none_of(_signatures.begin(), _signatures.end(), [characteristics] (const Signature & signature) {
+			return (characteristics & signature.section_characteristics) == signature.section_characteristics;
+		})) continue;
+
+		const std::string_view data = detail::section_data(image, section_header, section_buffer);
+		const std::string section_name (detail::section_name(section_header));
+
+		scan_data(data, characteristics, [&] (std::size_t signature, std::size_t offset) {
+			std::optional<FileOffset> file_offset;
+			if (offset < section_header.size_of_raw_data)
+				file_offset = FileOffset(section_header.pointer_to_raw_data + offset);
+			fn(SignatureMatch {
+				signature, file_offset, VirtualOffset(section_header.virtual_address + offset),
+				current_index, section_name
+			});
+		});
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::vector<SignatureMatch> SignatureScanner::scan(const detail::ImageBase<XX, Offset, MemoryBuffer> & image) const
+{
+	std::vector<SignatureMatch> signature_matches;
+	for_each_match(image, [&signature_matches] (SignatureMatch signature_match) {
+		signature_matches.push_back(std::move(signature_match));
+	});
+	return signature_matches;
+}
+
+inline DWORD SignatureScanner::next_state(DWORD state, BYTE value) const
+{
+	while (state >= _dense_state_count) {
+		const auto children_begin = _child_values.begin() + _child_begin[state];
+		const auto children_end = _child_values.begin() + _child_begin[state + 1];
+		const auto child = std::lower_bound(children_begin, children_end, value);
+		if (child != children_end && *child == value)
+			return _child_states[static_cast<std::size_t>(child - _child_values.begin())];
+		state = _failure_links[state];
+	}
+	return _dense_transitions[state * 256 + value];
+}
+
+inline bool SignatureScanner::matches(const Signature & signature, const char * data) const
+{
+	const BYTE * const values = _values.data() + signature.data_offset;
+	const BYTE * const masks = _masks.data() + signature.data_offset;
+	for (std::size_t i = 0; i < signature.size; ++i) {
+		if ((static_cast<BYTE>(data[i]) & masks[i]) != values[i]) return false;
+	}
+	return true;
+}
+
+template <class Fn>
+void SignatureScanner::scan_data(std::string_view data, DWORD section_characteristics, Fn && fn) const
+{
+	if (!_compiled) throw std::runtime_error("Signature scanner not compiled");
+
+	DWORD state = ROOT_STATE;
+	for (std::size_t pos = 0; pos < data.size(); ++pos) {
+		state = next_state(state, static_cast<BYTE>(data[pos]));
+
+		const DWORD first_output = _output_begin[state] != _output_begin[state + 1] ? state : _output_links[state];
+		for (DWORD output = first_output; output != ROOT_STATE; output = _output_links[output]) {
+			for (DWORD i = _output_begin[output]; i < _output_begin[output + 1]; ++i) {
+				const Signature & signature = _signatures[_outputs[i]];
+				if ((section_characteristics & signature.section_characteristics) != signature.section_characteristics) continue;
+
+				const std::size_t anchor_end = signature.anchor_offset + signature.anchor_size;
+				if (pos + 1 < anchor_end) continue;
+				const std::size_t match_offset = pos + 1 - anchor_end;
+				if (match_offset + signature.size > data.size()) continue;
+
+				if (matches(signature, data.data() + match_offset)) fn(static_cast<std::size_t>(_outputs[i]), match_offset);
+			}
+		}
+	}
+}
+
+}
+
+#endif
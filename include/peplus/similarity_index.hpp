@@ -0,0 +1,410 @@
+#ifndef PEPLUS_SIMILARITYINDEX_HPP_
+#define PEPLUS_SIMILARITYINDEX_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/import_hash.hpp>
+#include <peplus/section_statistics.hpp>
+#include <peplus/detail/image_base.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/parallel_for.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace peplus {
+
+namespace detail {
+
+const std::size_t MINHASH_SIZE = 128;
+const std::size_t DEFAULT_LSH_BAND_COUNT = 32;
+const std::size_t LSH_PENDING_LIMIT = 0x1000;
+const std::size_t SIMILARITY_PARALLEL_THRESHOLD = 0x1000;
+const std::size_t SIMILARITY_BLOCK_SIZE = 0x400;
+const std::size_t SIMILARITY_IO_CHUNK_SIZE = 0x400;
+const std::uint64_t LSH_KEY_MULTIPLIER = 0xc6a4a7935bd1e995;
+const DWORD SIMILARITY_INDEX_SIGNATURE = 0x48534c50;
+const DWORD SIMILARITY_INDEX_VERSION = 1;
+
+constexpr std::uint64_t split_mix(std::uint64_t & state)
+{
+	std::uint64_t value = state += 0x9e3779b97f4a7c15;
+	value = (value ^ value >> 30) * 0xbf58476d1ce4e5b9;
+	value = (value ^ value >> 27) * 0x94d049bb133111eb;
+	return value ^ value >> 31;
+}
+
+constexpr std::array<std::uint64_t, 2 * MINHASH_SIZE> make_minhash_coefficients()
+{
+	std::array<std::uint64_t, 2 * MINHASH_SIZE> coefficients {};
+	std::uint64_t state = 0x5045504c55534d48;
+	for (std::size_t i = 0; i < MINHASH_SIZE; ++i) {
+		coefficients[2 * i] = split_mix(state) | 1;
+		coefficients[2 * i + 1] = split_mix(state);
+	}
+	return coefficients;
+}
+
+inline constexpr std::array<std::uint64_t, 2 * MINHASH_SIZE> MINHASH_COEFFICIENTS = make_minhash_coefficients();
+
+}
+
+using MinHashSignature = std::array<std::uint32_t, detail::MINHASH_SIZE>;
+
+struct SimilarityMatch
+{
+	std::size_t id;
+	double      similarity;
+};
+
+namespace detail {
+
+struct LshEntry
+{
+	std::uint32_t key;
+	std::uint32_t id;
+};
+
+inline bool operator <(const LshEntry & lhs, const LshEntry & rhs)
+{
+	return (std::uint64_t(lhs.key) << 32 | lhs.id) < (std::uint64_t(rhs.key) << 32 | rhs.id);
+}
+
+inline void sort_lsh_entries(LshEntry * entries, std::size_t count)
+{
+	std::vector<LshEntry> buffer (count);
+	LshEntry * source = entries, * target = buffer.data();
+	for (unsigned int shift = 0; shift < 32; shift += 8) {
+		std::array<std::size_t, 256> bucket_offsets {};
+		for (std::size_t i = 0; i < count; ++i)
+			++bucket_offsets[source[i].key >> shift & 0xff];
+		std::size_t bucket_offset = 0;
+		for (std::size_t & offset : bucket_offsets)
+			bucket_offset += offset, offset = bucket_offset - offset;
+		for (std::size_t i = 0; i < count; ++i)
+			target[bucket_offsets[source[i].key >> shift & 0xff]++] = source[i];
+		std::swap(source, target);
+	}
+}
+
+class LshBand
+{
+public:
+	void add(LshEntry entry);
+	LshEntry * extend(std::size_t count);
+	void merge();
+
+	template <class Fn>
+	void for_each_match(std::uint32_t key, Fn && fn) const;
+
+private:
+	std::vector<LshEntry> _entries;
+	std::size_t           _sorted_size = 0;
+};
+
+inline void LshBand::add(LshEntry entry)
+{
+	_entries.push_back(entry);
+	if (_entries.size() - _sorted_size >= LSH_PENDING_LIMIT) merge();
+}
+
+inline LshEntry * LshBand::extend(std::size_t count)
+{
+	_entries.resize(_entries.size() + count);
+	return _entries.data() + _entries.size() - count;
+}
+
+inline void LshBand::merge()
+{
+	const auto pending_begin = _entries.begin() + static_cast<std::ptrdiff_t>(_sorted_size);
+	sort_lsh_entries(_entries.data() + _sorted_size, _entries.size() - _sorted_size);
+	std::inplace_merge(_entries.begin(), pending_begin, _entries.end());
+	_sorted_size = _entries.size();
+}
+
+template <class Fn>
+void LshBand::for_each_match(std::uint32_t key, Fn && fn) const
+{
+	const auto sorted_end = _entries.begin() + static_cast<std::ptrdiff_t>(_sorted_size);
+	auto entry = std::lower_bound(_entries.begin(), sorted_end, LshEntry { key, 0 });
+	for (; entry != sorted_end && entry->key == key; ++entry)
+		fn(entry->id);
+	for (entry = sorted_end; entry != _entries.end(); ++entry)
+		if (entry->key == key) fn(entry->id);
+}
+
+inline std::uint32_t lsh_band_key(const MinHashSignature & signature, std::size_t band_begin, std::size_t band_size)
+{
+	std::uint64_t key = band_begin;
+	for (std::size_t i = band_begin; i < band_begin + band_size; ++i)
+		key = (key ^ signature[i]) * LSH_KEY_MULTIPLIER;
+	return static_cast<std::uint32_t>(key >> 32);
+}
+
+inline bool is_empty_minhash(const MinHashSignature & signature)
+{
+	return std::all_of(signature.begin(), signature.end(), [] (std::uint32_t value) {
+		return value == std::numeric_limits<std::uint32_t>::max();
+	});
+}
+
+inline void write_similarity_index_data(std::ostream & stream, const char * data, std::size_t size)
+{
+	if (!stream.write(data, static_cast<std::streamsize>(size))) throw std::runtime_error("Could not write similarity index");
+}
+
+inline void read_similarity_index_data(std::istream & stream, char * data, std::size_t size)
+{
+	if (!stream.read(data, static_cast<std::streamsize>(size))) throw std::runtime_error("Invalid similarity index");
+}
+
+}
+
+template <class FeatureRange>
+std::optional<MinHashSignature> minhash(const FeatureRange & features)
+{
+	if (std::begin(features) == std::end(features)) return std::nullopt;
+
+	MinHashSignature signature;
+	signature.fill(std::numeric_limits<std::uint32_t>::max());
+	for (const std::uint64_t feature : features) {
+		for (std::size_t i = 0; i < signature.size(); ++i) {
+			const std::uint64_t value = detail::MINHASH_COEFFICIENTS[2 * i] * feature + detail::MINHASH_COEFFICIENTS[2 * i + 1];
+			signature[i] = std::min(signature[i], static_cast<std::uint32_t>(value >> 32));
+		}
+	}
+	return signature;
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::optional<MinHashSignature> import_minhash(const detail::ImageBase<XX, Offset, MemoryBuffer> & image)
+{
+	return minhash(import_name_hashes(image));
+}
+
+template <unsigned int XX, class MemoryBuffer>
+std::optional<MinHashSignature> section_minhash(const FileImage<XX, MemoryBuffer> & image,
+                                 unsigned int thread_count = std::thread::hardware_concurrency())
+{
+	std::vector<std::uint64_t> section_hashes;
+	for (const SectionStatistics & statistics : section_statistics(image, thread_count))
+		if (statistics.statistics.size != 0) section_hashes.push_back(statistics.statistics.hash);
+	return minhash(section_hashes);
+}
+
+inline double estimate_similarity(const MinHashSignature & lhs, const MinHashSignature & rhs)
+{
+	std::size_t equal_count = 0;
+	for (std::size_t i = 0; i < lhs.size(); ++i)
+		equal_count += lhs[i] == rhs[i];
+	return static_cast<double>(equal_count) / static_cast<double>(lhs.size());
+}
+
+class SimilarityIndex
+{
+public:
+	explicit SimilarityIndex(std::size_t band_count = detail::DEFAULT_LSH_BAND_COUNT);
+
+	std::size_t band_count() const;
+	std::size_t size() const;
+	bool empty() const;
+
+	const MinHashSignature & signature(std::size_t id) const;
+
+	std::size_t insert(const MinHashSignature & signature);
+
+	template <class Iterator>
+	std::size_t insert(Iterator first, Iterator last, unsigned int thread_count = std::thread::hardware_concurrency());
+
+	std::vector<SimilarityMatch> query(const MinHashSignature & signature, double min_similarity = 0) const;
+
+	void save(std::ostream & stream) const;
+	static SimilarityIndex load(std::istream & stream, unsigned int thread_count = std::thread::hardware_concurrency());
+
+private:
+	std::size_t band_size() const;
+	std::size_t allocate_ids(std::size_t count) const;
+
+	std::vector<MinHashSignature> _signatures;
+	std::vector<detail::LshBand>  _bands;
+};
+
+inline SimilarityIndex::SimilarityIndex(std::size_t band_count)
+{
+	if (band_count == 0 || detail::MINHASH_SIZE % band_count != 0) throw std::runtime_error("Invalid LSH band count");
+	_bands.resize(band_count);
+}
+
+inline std::size_t SimilarityIndex::band_count() const
+{
+	return _bands.size();
+}
+
+inline std::size_t SimilarityIndex::size() const
+{
+	return _signatures.size();
+}
+
+inline bool SimilarityIndex::empty() const
+{
+	return _signatures.empty();
+}
+
+inline const MinHashSignature & SimilarityIndex::signature(std::size_t id) const
+{
+	return _signatures[id];
+}
+
+inline std::size_t SimilarityIndex::band_size() const
+{
+	return detail::MINHASH_SIZE / _bands.size();
+}
+
+inline std::size_t SimilarityIndex::allocate_ids(std::size_t count) const
+{
+	if (count > std::numeric_limits<std::uint32_t>::max() - _signatures.size())
+		throw std::runtime_error("Similarity index is full");
+	return _signatures.size();
+}
+
+inline std::size_t SimilarityIndex::insert(const MinHashSignature & signature)
+{
+	if (detail::is_empty_minhash(signature)) throw std::runtime_error("Empty MinHash signature");
+
+	const std::size_t id = allocate_ids(1);
+	_signatures.push_back(signature);
+	for (std::size_t band = 0; band < _bands.size(); ++band) {
+		const std::uint32_t key = detail::lsh_band_key(signature, band * band_size(), band_size());
+		_bands[band].add(detail::LshEntry { key, static_cast<std::uint32_t>(id) });
+	}
+	return id;
+}
+
+template <class Iterator>
+std::size_t SimilarityIndex::insert(Iterator first, Iterator last, unsigned int thread_count)
+{
+	const std::size_t first_id = allocate_ids(static_cast<std::size_t>(std::distance(first, last)));
+	_signatures.insert(_signatures.end(), first, last);
+	const std::size_t signature_count = _signatures.size() - first_id;
+	if (signature_count == 0) return first_id;
+
+	const auto new_signatures = _signatures.begin() + static_cast<std::ptrdiff_t>(first_id);
+	if (std::any_of(new_signatures, _signatures.end(), detail::is_empty_minhash)) {
+		_signatures.erase(new_signatures, _signatures.end());
+		throw std::runtime_error("Empty MinHash signature");
+	}
+
+	if (signature_count < detail::SIMILARITY_PARALLEL_THRESHOLD) thread_count = 1;
+
+	std::vector<detail::LshEntry *> band_entries;
+	for (detail::LshBand & band : _bands)
+		band_entries.push_back(band.extend(signature_count));
+
+	const std::size_t block_count = (signature_count + detail::SIMILARITY_BLOCK_SIZE - 1) / detail::SIMILARITY_BLOCK_SIZE;
+	detail::parallel_for(block_count, thread_count, [&] (std::size_t block) {
+		const std::size_t block_begin = block * detail::SIMILARITY_BLOCK_SIZE;
+		const std::size_t block_end = std::min(signature_count, block_begin + detail::SIMILARITY_BLOCK_SIZE);
+		for (std::size_t i = block_begin; i < block_end; ++i) {
+			const MinHashSignature & signature = _signatures[first_id + i];
+			for (std::size_t band = 0; band < _bands.size(); ++band) {
+				const std::uint32_t key = detail::lsh_band_key(signature, band * band_size(), band_size());
+				band_entries[band][i] = detail::LshEntry { key, static_cast<std::uint32_t>(first_id + i) };
+			}
+		}
+	});
+	detail::parallel_for(_bands.size(), thread_count, [this] (std::size_t band) {
+		_bands[band].merge();
+	});
+
+	return first_id;
+}
+
+inline std::vector<SimilarityMatch> SimilarityIndex::query(const MinHashSignature & signature, double min_similarity) const
+{
+	if (detail::is_empty_minhash(signature)) return {};
+
+	std::vector<std::uint32_t> candidates;
+	for (std::size_t band = 0; band < _bands.size(); ++band) {
+		const std::uint32_t key = detail::lsh_band_key(signature, band * band_size(), band_size());
+		_bands[band].for_each_match(key, [&candidates] (std::uint32_t id) {
+			candidates.push_back(id);
+		});
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	std::vector<SimilarityMatch> matches;
+	for (const std::uint32_t id : candidates) {
+		const double similarity = estimate_similarity(signature, _signatures[id]);
+		if (similarity >= min_similarity) matches.push_back(SimilarityMatch { id, similarity });
+	}
+	std::sort(matches.begin(), matches.end(), [] (const SimilarityMatch & lhs, const SimilarityMatch & rhs) {
+		return lhs.similarity > rhs.similarity || (lhs.similarity == rhs.similarity && lhs.id < rhs.id);
+	});
+	return matches;
+}
+
+inline void SimilarityIndex::save(std::ostream & stream) const
+{
+	std::array<char, 3 * sizeof(DWORD) + sizeof(QWORD)> header;
+	detail::store_le_value<DWORD>(header.data(), detail::SIMILARITY_INDEX_SIGNATURE);
+	detail::store_le_value<WORD>(header.data() + sizeof(DWORD), detail::SIMILARITY_INDEX_VERSION);
+	detail::store_le_value<WORD>(header.data() + sizeof(DWORD) + sizeof(WORD), static_cast<WORD>(detail::MINHASH_SIZE));
+	detail::store_le_value<DWORD>(header.data() + 2 * sizeof(DWORD), static_cast<DWORD>(_bands.size()));
+	detail::store_le_value<QWORD>(header.data() + 3 * sizeof(DWORD), _signatures.size());
+	detail::write_similarity_index_data(stream, header.data(), header.size());
+
+	std::vector<char> chunk (detail::SIMILARITY_IO_CHUNK_SIZE * sizeof(MinHashSignature));
+	for (std::size_t id = 0; id < _signatures.size(); ) {
+		char * chunk_end = chunk.data();
+		for (const std::size_t chunk_last = std::min(_signatures.size(), id + detail::SIMILARITY_IO_CHUNK_SIZE); id < chunk_last; ++id) {
+			for (const std::uint32_t value : _signatures[id])
+				detail::store_le_value<std::uint32_t>(chunk_end, value), chunk_end += sizeof(std::uint32_t);
+		}
+		detail::write_similarity_index_data(stream, chunk.data(), static_cast<std::size_t>(chunk_end - chunk.data()));
+	}
+}
+
+inline SimilarityIndex SimilarityIndex::load(std::istream & stream, unsigned int thread_count)
+{
+	std::array<char, 3 * sizeof(DWORD) + sizeof(QWORD)> header;
+	detail::read_similarity_index_data(stream, header.data(), header.size());
+	if (detail::load_le_value<DWORD>(header.data()) != detail::SIMILARITY_INDEX_SIGNATURE
+	 || detail::load_le_value<WORD>(header.data() + sizeof(DWORD)) != detail::SIMILARITY_INDEX_VERSION
+	 || detail::load_le_value<WORD>(header.data() + sizeof(DWORD) + sizeof(WORD)) != detail::MINHASH_SIZE)
+		throw std::runtime_error("Invalid similarity index");
+
+	SimilarityIndex similarity_index { detail::load_le_value<DWORD>(header.data() + 2 * sizeof(DWORD)) };
+	const QWORD signature_count = detail::load_le_value<QWORD>(header.data() + 3 * sizeof(DWORD));
+	if (signature_count > std::numeric_limits<std::uint32_t>::max()) throw std::runtime_error("Invalid similarity index");
+
+	std::vector<MinHashSignature> signatures;
+	std::vector<char> chunk (detail::SIMILARITY_IO_CHUNK_SIZE * sizeof(MinHashSignature));
+	while (signatures.size() < signature_count) {
+		const std::size_t chunk_count = std::min<std::size_t>(signature_count - signatures.size(), detail::SIMILARITY_IO_CHUNK_SIZE);
+		detail::read_similarity_index_data(stream, chunk.data(), chunk_count * sizeof(MinHashSignature));
+		const char * chunk_data = chunk.data();
+		for (std::size_t i = 0; i < chunk_count; ++i) {
+			MinHashSignature & signature = signatures.emplace_back();
+			for (std::uint32_t & value : signature)
+				value = detail::load_le_value<std::uint32_t>(chunk_data), chunk_data += sizeof(std::uint32_t);
+		}
+	}
+
+	similarity_index.insert(signatures.begin(), signatures.end(), thread_count);
+	return similarity_index;
+}
+
+}
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef PEPLUS_STRINGEXTRACTOR_HPP_
+#define PEPLUS_STRINGEXTRACTOR_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+#include <peplus/detail/image_base.hpp>
+#include <peplus/detail/image_helpers.hpp>
+#include <peplus/detail/parallel_for.hpp>
+#include <peplus/detail/simd_support.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace peplus {
+
+enum class StringEncoding
+{
+	Ascii, Utf16,
+};
+
+struct ExtractedString
+{
+	StringEncoding            encoding;
+	std::size_t               section_index;
+	std::optional<FileOffset> file_offset;
+	VirtualOffset             rva;
+	std::size_t               size;
+};
+
+namespace detail {
+
+const std::size_t DEFAULT_MIN_STRING_LENGTH = 4;
+const std::size_t STRINGS_PARALLEL_THRESHOLD = 0x100000;
+const std::size_t STRINGS_BLOCK_SIZE = 16;
+
+struct StringRun
+{
+	StringEncoding encoding;
+	std::size_t    offset;
+	std::size_t    size;
+};
+
+class StringRunTracker
+{
+public:
+	StringRunTracker(StringEncoding encoding, std::size_t unit_size, std::size_t unit_phase,
+	                 std::size_t min_length, std::vector<StringRun> & runs);
+
+	void feed(std::uint32_t mask, unsigned int unit_count, std::size_t first_unit);
+	void finish();
+
+private:
+	void emit(std::size_t end_unit);
+
+	StringEncoding           _encoding;
+	std::size_t              _unit_size;
+	std::size_t              _unit_phase;
+	std::size_t              _min_length;
+	std::vector<StringRun> * _runs;
+	bool                     _in_run = false;
+	std::size_t              _run_begin = 0;
+	std::size_t              _next_unit = 0;
+};
+
+inline StringRunTracker::StringRunTracker(StringEncoding encoding, std::size_t unit_size, std::size_t unit_phase,
+                                          std::size_t min_length, std::vector<StringRun> & runs)
+	: _encoding { encoding }, _unit_size { unit_size }, _unit_phase { unit_phase }
+	, _min_length { std::max<std::size_t>(min_length, 1) }, _runs { &runs } {}
+
+inline void StringRunTracker::feed(std::uint32_t mask, unsigned int unit_count, std::size_t first_unit)
+{
+	const std::uint32_t units_mask = unit_count == 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << unit_count) - 1;
+	_next_unit = first_unit + unit_count;
+	mask &= units_mask;
+
+	if (mask == units_mask) {
+		if (!_in_run) _in_run = true, _run_begin = first_unit;
+		return;
+	}
+
+	std::uint32_t pending_units = units_mask;
+	while (pending_units != 0) {
+		const std::uint32_t boundaries = (_in_run ? ~mask : mask) & pending_units;
+		if (boundaries == 0) return;
+
+		const unsigned int bit = count_trailing_zeros(boundaries);
+		if (_in_run) {
+			emit(first_unit + bit);
+			_in_run = false;
+		} else {
+			_in_run = true;
+			_run_begin = first_unit + bit;
+		}
+		pending_units &= static_cast<std::uint32_t>(~((std::uint64_t(2) << bit) - 1));
+	}
+}
+
+inline void StringRunTracker::finish()
+{
+	if (_in_run) emit(_next_unit);
+	_in_run = false;
+}
+
+inline void StringRunTracker::emit(std::size_t end_unit)
+{
+	if (end_unit - _run_begin >= _min_length)
+		_runs->push_back(StringRun { _encoding, _run_begin * _unit_size + _unit_phase, (end_unit - _run_begin) * _unit_size });
+}
+
+inline bool is_printable_char(char value)
+{
+	return (value >= 0x20 && value < 0x7f) || value == '\t';
+}
+
+inline std::uint32_t compress_even_bits(std::uint32_t mask)
+{
+	mask &= 0x5555;
+	mask = (mask | mask >> 1) & 0x3333;
+	mask = (mask | mask >> 2) & 0x0f0f;
+	mask = (mask | mask >> 4) & 0x00ff;
+	return mask;
+}
+
+inline void classify_string_block(const char * data, std::uint32_t & printable, std::uint32_t & wide)
+{
+#ifdef PEPLUS_HAS_SSE2
+	const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+	const __m128i next_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 1));
+	const __m128i printable_bytes = _mm_or_si128(
+		_mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(0x1f)), _mm_cmplt_epi8(bytes, _mm_set1_epi8(0x7f))),
+		_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')));
+	const __m128i wide_chars = _mm_and_si128(printable_bytes, _mm_cmpeq_epi8(next_bytes, _mm_setzero_si128()));
+	printable = static_cast<std::uint32_t>(_mm_movemask_epi8(printable_bytes));
+	wide = static_cast<std::uint32_t>(_mm_movemask_epi8(wide_chars));
+#else
+	printable = wide = 0;
+	for (std::size_t i = 0; i < STRINGS_BLOCK_SIZE; ++i) {
+		if (!is_printable_char(data[i])) continue;
+		printable |= std::uint32_t(1) << i;
+		if (data[i + 1] == '\0') wide |= std::uint32_t(1) << i;
+	}
+#endif
+}
+
+inline void find_string_runs(std::string_view data, std::size_t min_length, std::vector<StringRun> & runs)
+{
+	const std::size_t first_run = runs.size();
+	StringRunTracker ascii_runs { StringEncoding::Ascii, 1, 0, min_length, runs };
+	StringRunTracker even_utf16_runs { StringEncoding::Utf16, 2, 0, min_length, runs };
+	StringRunTracker odd_utf16_runs { StringEncoding::Utf16, 2, 1, min_length, runs };
+
+	std::size_t offset = 0;
+	for (; offset + STRINGS_BLOCK_SIZE < data.size(); offset += STRINGS_BLOCK_SIZE) {
+		std::uint32_t printable, wide;
+		classify_string_block(data.data() + offset, printable, wide);
+		ascii_runs.feed(printable, STRINGS_BLOCK_SIZE, offset);
+		even_utf16_runs.feed(compress_even_bits(wide), STRINGS_BLOCK_SIZE / 2, offset / 2);
+		odd_utf16_runs.feed(compress_even_bits(wide >> 1), STRINGS_BLOCK_SIZE / 2, offset / 2);
+	}
+	for (; offset < data.size(); ++offset) {
+		const bool printable = is_printable_char(data[offset]);
+		const bool wide = printable && offset + 1 < data.size() && data[offset + 1] == '\0';
+		ascii_runs.feed(printable, 1, offset);
+		(offset % 2 == 0 ? even_utf16_runs : odd_utf16_runs).feed(wide, 1, offset / 2);
+	}
+
+	ascii_runs.finish();
+	even_utf16_runs.finish();
+	odd_utf16_runs.finish();
+
+	std::sort(runs.begin() + first_run, runs.end(), [] (const StringRun & lhs, const StringRun & rhs) {
+		return lhs.offset < rhs.offset || (lhs.offset == rhs.offset && lhs.encoding < rhs.encoding);
+	});
+}
+
+inline ExtractedString make_extracted_string(const SectionHeader & section_header, std::size_t section_index,
+                                             const StringRun & run)
+{
+	std::optional<FileOffset> file_offset;
+	if (run.offset < section_header.size_of_raw_data)
+		file_offset = FileOffset(section_header.pointer_to_raw_data + run.offset);
+	return ExtractedString {
+		run.encoding, section_index, file_offset,
+		VirtualOffset(section_header.virtual_address + run.offset), run.size
+	};
+}
+
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer, class Fn>
+void for_each_string(const detail::ImageBase<XX, Offset, MemoryBuffer> & image, Fn && fn,
+                     std::size_t min_length = detail::DEFAULT_MIN_STRING_LENGTH)
+{
+	std::string section_buffer;
+	std::vector<detail::StringRun> runs;
+	std::size_t section_index = 0;
+	for (const auto & section_header : image.section_headers()) {
+		const std::string_view data = detail::section_data(image, section_header, section_buffer);
+		runs.clear();
+		detail::find_string_runs(data, min_length, runs);
+		for (const detail::StringRun & run : runs)
+			fn(detail::make_extracted_string(section_header, section_index, run), data.substr(run.offset, run.size));
+		++section_index;
+	}
+}
+
+template <unsigned int XX, class Offset, class MemoryBuffer>
+std::vector<ExtractedString> extract_strings(const detail::ImageBase<XX, Offset, MemoryBuffer> & image,
+                                             std::size_t min_length = detail::DEFAULT_MIN_STRING_LENGTH,
+                                             unsigned int thread_count = std::thread::hardware_concurrency())
+{
+	std::vector<SectionHeader> section_headers;
+	std::size_t total_size = 0;
+	for (const auto & section_header : image.section_headers()) {
+		section_headers.push_back(section_header);
+		total_size += detail::section_extent(image, section_header).second;
+	}
+
+	if (total_size < detail::STRINGS_PARALLEL_THRESHOLD) thread_count = 1;
+
+	std::vector<std::vector<ExtractedString>> section_strings (section_headers.size());
+	detail::parallel_for(section_headers.size(), thread_count, [&] (std::size_t i) {
+		std::string section_buffer;
+		std::vector<detail::StringRun> runs;
+		detail::find_string_runs(detail::section_data(image, section_headers[i], section_buffer), min_length, runs);
+		section_strings[i].reserve(runs.size());
+		for (const detail::StringRun & run : runs)
+			section_strings[i].push_back(detail::make_extracted_string(section_headers[i], i, run));
+	});
+
+	std::vector<ExtractedString> extracted_strings;
+	for (std::vector<ExtractedString> & strings : section_strings)
+		extracted_strings.insert(extracted_strings.end(), strings.begin(), strings.end());
+	return extracted_strings;
+}
+
+}
+
+#endif
@@ -0,0 +1,412 @@
+#ifndef PEPLUS_X64UNWINDER_HPP_
+#define PEPLUS_X64UNWINDER_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/image_common.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace peplus {
+
+enum X64Register
+{
+	X64_RAX, X64_RCX, X64_RDX, X64_RBX, X64_RSP, X64_RBP, X64_RSI, X64_RDI,
+	X64_R8,  X64_R9,  X64_R10, X64_R11, X64_R12, X64_R13, X64_R14, X64_R15,
+};
+
+struct X64Context
+{
+	ULONGLONG                               rip;
+	std::array<ULONGLONG, 16>               gpr;
+	std::array<std::array<ULONGLONG, 2>, 16> xmm;
+};
+
+template <class Image>
+class X64Unwinder
+{
+public:
+	explicit X64Unwinder(const Image & image);
+	X64Unwinder(const Image & image, ULONGLONG image_base);
+
+	ULONGLONG image_base() const;
+	bool contains(ULONGLONG address) const;
+
+	template <class MemoryBuffer>
+	bool unwind_frame(X64Context & context, const typename MemoryBuffer::value_type & memory) const;
+
+private:
+	struct UnwindStage
+	{
+		DWORD             begin_address;
+		BYTE              version;
+		BYTE              size_of_prolog;
+		BYTE              frame_register;
+		BYTE              frame_offset;
+		std::vector<WORD> code_slots;
+	};
+
+	struct FunctionUnwindInfo
+	{
+		DWORD                    end_address;
+		std::vector<UnwindStage> stages;
+	};
+
+	const FunctionUnwindInfo * function_unwind_info(DWORD rva) const;
+	bool is_inside_epilog(DWORD rva, DWORD begin_address, DWORD end_address) const;
+
+	template <class MemoryBuffer>
+	void interpret_epilog(X64Context & context, DWORD rva, DWORD end_address,
+	                      const typename MemoryBuffer::value_type & memory) const;
+
+	template <class MemoryBuffer>
+	bool apply_stage(X64Context & context, const UnwindStage & stage, std::size_t prolog_offset,
+	                 const typename MemoryBuffer::value_type & memory) const;
+
+	const Image                                  * _image;
+	ULONGLONG                                      _image_base;
+	DWORD                                          _size_of_image;
+	mutable std::shared_mutex                      _unwind_cache_mutex;
+	mutable std::map<DWORD, FunctionUnwindInfo>    _unwind_cache;
+};
+
+namespace detail {
+
+const std::size_t MAX_EPILOG_SIZE = 64;
+
+template <typename T, class MemoryBuffer>
+T read_unwind_memory(const typename MemoryBuffer::value_type & memory, ULONGLONG address)
+{
+	T value;
+	const std::size_t bytes_read = MemoryBuffer::read(memory, static_cast<std::size_t>(address),
+	                                                  sizeof(T), &value);
+	if (bytes_read < sizeof(T)) throw std::runtime_error("Unable to read unwind memory");
+	return boost::endian::little_to_native(value);
+}
+
+inline std::size_t unwind_code_slot_count(WORD code_slot, BYTE version)
+{
+	const unsigned int unwind_op = (code_slot >> 8) & 0x0f;
+	const unsigned int op_info = code_slot >> 12;
+	switch (unwind_op) {
+		case UWOP_ALLOC_LARGE:     return op_info == 0 ? 2 : 3;
+		case UWOP_SAVE_NONVOL:     return 2;
+		case UWOP_SAVE_NONVOL_FAR: return 3;
+		case UWOP_EPILOG:          return version >= 2 ? 1 : 2;
+		case UWOP_SPARE_CODE:      return 3;
+		case UWOP_SAVE_XMM128:     return 2;
+		case UWOP_SAVE_XMM128_FAR: return 3;
+		default:                   return 1;
+	}
+}
+
+}
+
+template <class Image>
+X64Unwinder<Image>::X64Unwinder(const Image & image)
+	: X64Unwinder { image, image.optional_header().image_base } {}
+
+template <class Image>
+X64Unwinder<Image>::X64Unwinder(const Image & image, ULONGLONG image_base)
+	: _image { &image }, _image_base { image_base }
+	, _size_of_image { image.optional_header().size_of_image } {}
+
+template <class Image>
+ULONGLONG X64Unwinder<Image>::image_base() const
+{
+	return _image_base;
+}
+
+template <class Image>
+bool X64Unwinder<Image>::contains(ULONGLONG address) const
+{
+	return address >= _image_base && address - _image_base < _size_of_image;
+}
+
+template <class Image> template <class MemoryBuffer>
+bool X64Unwinder<Image>::unwind_frame(X64Context & context, const typename MemoryBuffer::value_type & memory) const
+{
+	if (!contains(context.rip)) return false;
+
+	const DWORD rva = static_cast<DWORD>(context.rip - _image_base);
+	const FunctionUnwindInfo * const unwind_info = function_unwind_info(rva);
+	if (!unwind_info) {
+		context.rip = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, context.gpr[X64_RSP]);
+		context.gpr[X64_RSP] += sizeof(ULONGLONG);
+		return true;
+	}
+
+	const UnwindStage & primary_stage = unwind_info->stages.front();
+	std::size_t prolog_offset = rva - primary_stage.begin_address;
+	if (prolog_offset >= primary_stage.size_of_prolog) {
+		prolog_offset = static_cast<std::size_t>(-1);
+		if (is_inside_epilog(rva, primary_stage.begin_address, unwind_info->end_address)) {
+			interpret_epilog<MemoryBuffer>(context, rva, unwind_info->end_address, memory);
+			return true;
+		}
+	}
+
+	bool machine_frame = false;
+	for (const UnwindStage & stage : unwind_info->stages) {
+		machine_frame |= apply_stage<MemoryBuffer>(context, stage, prolog_offset, memory);
+		prolog_offset = static_cast<std::size_t>(-1);
+	}
+
+	if (!machine_frame) {
+		context.rip = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, context.gpr[X64_RSP]);
+		context.gpr[X64_RSP] += sizeof(ULONGLONG);
+	}
+
+	return true;
+}
+
+template <class Image>
+auto X64Unwinder<Image>::function_unwind_info(DWORD rva) const -> const FunctionUnwindInfo *
+{
+	{
+		const std::shared_lock lock { _unwind_cache_mutex };
+		const auto cached_it = _unwind_cache.upper_bound(rva);
+		if (cached_it != _unwind_cache.begin() && rva < std::prev(cached_it)->second.end_address)
+			return &std::prev(cached_it)->second;
+	}
+
+	const auto runtime_function = _image->find_function(VirtualOffset(rva));
+	if (!runtime_function) return nullptr;
+
+	FunctionUnwindInfo unwind_info;
+	unwind_info.end_address = runtime_function->end_address;
+
+	std::optional<detail::RuntimeFunctionFacade<Image>> stage_function = *runtime_function;
+	while (stage_function) {
+		if (unwind_info.stages.size() > 32) throw std::runtime_error("Unwind info chain too long");
+
+		const detail::UnwindInfoFacade<Image> stage_info = stage_function->unwind_info();
+
+		UnwindStage stage;
+		stage.begin_address  = stage_function->begin_address;
+		stage.version        = stage_info.version;
+		stage.size_of_prolog = stage_info.size_of_prolog;
+		stage.frame_register = stage_info.frame_register;
+		stage.frame_offset   = stage_info.frame_offset;
+		stage.code_slots.resize(stage_info.count_of_codes);
+		stage_info.read_code_slots(stage.code_slots.data());
+		unwind_info.stages.push_back(std::move(stage));
+
+		stage_function = stage_info.chained_function();
+	}
+
+	const DWORD begin_address = runtime_function->begin_address;
+	const std::unique_lock lock { _unwind_cache_mutex };
+	return &_unwind_cache.try_emplace(begin_address, std::move(unwind_info)).first->second;
+}
+
+template <class Image>
+bool X64Unwinder<Image>::is_inside_epilog(DWORD rva, DWORD begin_address, DWORD end_address) const
+{
+	std::array<BYTE, detail::MAX_EPILOG_SIZE> code {};
+	const std::size_t code_size = std::min<std::size_t>(end_address - rva, code.size());
+	const std::size_t bytes_read = _image->read(VirtualOffset(rva), code_size, code.data()).first;
+
+	std::size_t pc = 0;
+	if (bytes_read >= 3 && (code[0] & 0xf8) == 0x48) {
+		switch (code[1]) {
+			case 0x81:
+				if (code[0] != 0x48 || code[2] != 0xc4) return false;
+				pc += 7;
+				break;
+			case 0x83:
+				if (code[0] != 0x48 || code[2] != 0xc4) return false;
+				pc += 4;
+				break;
+			case 0x8d:
+				if ((code[0] & 0x06) != 0) return false;
+				if (((code[2] >> 3) & 7) != X64_RSP) return false;
+				if ((code[2] & 7) == X64_RSP) return false;
+				if ((code[2] >> 6) == 1) { pc += 4; break; }
+				if ((code[2] >> 6) == 2) { pc += 7; break; }
+				return false;
+		}
+	}
+
+	while (pc < bytes_read) {
+		if ((code[pc] & 0xf0) == 0x40 && ++pc == bytes_read) return false;
+
+		switch (code[pc]) {
+			case 0x58: case 0x59: case 0x5a: case 0x5b:
+			case 0x5c: case 0x5d: case 0x5e: case 0x5f:
+				++pc;
+				continue;
+			case 0xc2:
+			case 0xc3:
+				return true;
+			case 0xf3:
+				return pc + 1 < bytes_read && code[pc + 1] == 0xc3;
+			case 0xe9: {
+				if (pc + 5 > bytes_read) return false;
+				std::int32_t displacement;
+				std::memcpy(&displacement, &code[pc + 1], sizeof(displacement));
+				const std::int64_t target = std::int64_t(rva) + pc + 5 + boost::endian::little_to_native(displacement);
+				return target < begin_address || target >= end_address;
+			}
+			case 0xeb: {
+				if (pc + 2 > bytes_read) return false;
+				const std::int64_t target = std::int64_t(rva) + pc + 2 + static_cast<std::int8_t>(code[pc + 1]);
+				return target < begin_address || target >= end_address;
+			}
+			case 0xff:
+				return pc + 1 < bytes_read && ((code[pc + 1] >> 3) & 7) == 4;
+		}
+
+		return false;
+	}
+
+	return false;
+}
+
+template <class Image> template <class MemoryBuffer>
+void X64Unwinder<Image>::interpret_epilog(X64Context & context, DWORD rva, DWORD end_address,
+                                          const typename MemoryBuffer::value_type & memory) const
+{
+	std::array<BYTE, detail::MAX_EPILOG_SIZE> code {};
+	const std::size_t code_size = std::min<std::size_t>(end_address - rva, code.size());
+	const std::size_t bytes_read = _image->read(VirtualOffset(rva), code_size, code.data()).first;
+
+	ULONGLONG & rsp = context.gpr[X64_RSP];
+	for (std::size_t pc = 0; pc < bytes_read; ) {
+		unsigned int rex = 0;
+		if ((code[pc] & 0xf0) == 0x40)
+			rex = code[pc++] & 0x0f;
+		if (pc >= bytes_read) break;
+
+		if (code[pc] >= 0x58 && code[pc] <= 0x5f) {
+			const unsigned int reg = (code[pc] - 0x58) + ((rex & 1) << 3);
+			context.gpr[reg] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, rsp);
+			if (reg != X64_RSP) rsp += sizeof(ULONGLONG);
+			pc += 1;
+		} else if (code[pc] == 0x81 && pc + 6 <= bytes_read) {
+			std::int32_t displacement;
+			std::memcpy(&displacement, &code[pc + 2], sizeof(displacement));
+			rsp += boost::endian::little_to_native(displacement);
+			pc += 6;
+		} else if (code[pc] == 0x83 && pc + 3 <= bytes_read) {
+			rsp += static_cast<std::int8_t>(code[pc + 2]);
+			pc += 3;
+		} else if (code[pc] == 0x8d && pc + 3 <= bytes_read) {
+			const unsigned int reg = (code[pc + 1] & 7) + ((rex & 1) << 3);
+			if ((code[pc + 1] >> 6) == 1) {
+				rsp = context.gpr[reg] + static_cast<std::int8_t>(code[pc + 2]);
+				pc += 3;
+			} else if (pc + 6 <= bytes_read) {
+				std::int32_t displacement;
+				std::memcpy(&displacement, &code[pc + 2], sizeof(displacement));
+				rsp = context.gpr[reg] + boost::endian::little_to_native(displacement);
+				pc += 6;
+			} else {
+				break;
+			}
+		} else {
+			break;
+		}
+	}
+
+	context.rip = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, rsp);
+	rsp += sizeof(ULONGLONG);
+}
+
+template <class Image> template <class MemoryBuffer>
+bool X64Unwinder<Image>::apply_stage(X64Context & context, const UnwindStage & stage, std::size_t prolog_offset,
+                                     const typename MemoryBuffer::value_type & memory) const
+{
+	const std::vector<WORD> & slots = stage.code_slots;
+	ULONGLONG & rsp = context.gpr[X64_RSP];
+
+	ULONGLONG frame = rsp;
+	if (stage.frame_register != 0) {
+		for (std::size_t i = 0; i < slots.size(); i += detail::unwind_code_slot_count(slots[i], stage.version)) {
+			if (((slots[i] >> 8) & 0x0f) == UWOP_SET_FPREG && (slots[i] & 0xff) <= prolog_offset) {
+				frame = context.gpr[stage.frame_register] - stage.frame_offset * 16ull;
+				break;
+			}
+		}
+	}
+
+	const auto slot_dword = [&slots](std::size_t i) -> DWORD {
+		if (i + 2 >= slots.size()) throw std::runtime_error("Invalid unwind code");
+		return DWORD(slots[i + 1]) | (DWORD(slots[i + 2]) << 16);
+	};
+
+	const auto slot_word = [&slots](std::size_t i) -> WORD {
+		if (i + 1 >= slots.size()) throw std::runtime_error("Invalid unwind code");
+		return slots[i + 1];
+	};
+
+	bool machine_frame = false;
+	for (std::size_t i = 0; i < slots.size(); i += detail::unwind_code_slot_count(slots[i], stage.version)) {
+		if ((slots[i] & 0xff) > prolog_offset) continue;
+
+		const unsigned int op_info = slots[i] >> 12;
+		switch ((slots[i] >> 8) & 0x0f) {
+			case UWOP_PUSH_NONVOL:
+				context.gpr[op_info] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, rsp);
+				rsp += sizeof(ULONGLONG);
+				break;
+			case UWOP_ALLOC_LARGE:
+				rsp += op_info == 0 ? slot_word(i) * 8ull : slot_dword(i);
+				break;
+			case UWOP_ALLOC_SMALL:
+				rsp += op_info * 8ull + 8;
+				break;
+			case UWOP_SET_FPREG:
+				rsp = frame;
+				break;
+			case UWOP_SAVE_NONVOL:
+				context.gpr[op_info] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_word(i) * 8ull);
+				break;
+			case UWOP_SAVE_NONVOL_FAR:
+				context.gpr[op_info] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_dword(i));
+				break;
+			case UWOP_EPILOG:
+				if (stage.version >= 2) break;
+				context.xmm[op_info][0] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_word(i) * 8ull);
+				break;
+			case UWOP_SPARE_CODE:
+				if (stage.version >= 2) throw std::runtime_error("Unsupported unwind code");
+				context.xmm[op_info][0] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_dword(i));
+				break;
+			case UWOP_SAVE_XMM128:
+				context.xmm[op_info][0] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_word(i) * 16ull);
+				context.xmm[op_info][1] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_word(i) * 16ull + 8);
+				break;
+			case UWOP_SAVE_XMM128_FAR:
+				context.xmm[op_info][0] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_dword(i));
+				context.xmm[op_info][1] = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, frame + slot_dword(i) + 8);
+				break;
+			case UWOP_PUSH_MACHFRAME:
+				if (op_info != 0) rsp += sizeof(ULONGLONG);
+				context.rip = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, rsp);
+				rsp = detail::read_unwind_memory<ULONGLONG, MemoryBuffer>(memory, rsp + 3 * sizeof(ULONGLONG));
+				machine_frame = true;
+				break;
+			default:
+				throw std::runtime_error("Unsupported unwind code");
+		}
+	}
+
+	return machine_frame;
+}
+
+}
+
+#endif
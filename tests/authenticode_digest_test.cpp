@@ -0,0 +1,332 @@
+#include <peplus/authenticode_digest.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include "image_builder.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace peplus {
+
+struct unviewable_digest_buffer
+{
+	using value_type = LocalBuffer;
+
+	static std::size_t read(const LocalBuffer & buffer, std::size_t offset, std::size_t data_size, void * into_buffer)
+	{
+		return local_buffer::read(buffer, offset, data_size, into_buffer);
+	}
+};
+
+}
+
+using namespace peplus;
+using peplus::test::ImageBuilder;
+
+namespace {
+
+using Ranges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+const std::size_t CHECK_SUM_OFFSET = 0x98;
+const std::size_t HEADERS_END = 0x200;
+const std::size_t SECTION_END = 0x400;
+
+struct RecordingHash
+{
+	std::string data;
+
+	void update(const char * bytes, std::size_t size) { data.append(bytes, size); }
+};
+
+class Sha256
+{
+public:
+	void update(const char * bytes, std::size_t size);
+	std::string hex_digest();
+
+private:
+	void process_block(const unsigned char * block);
+
+	std::array<std::uint32_t, 8> _state { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	                                      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+	std::array<unsigned char, 64> _block {};
+	std::size_t                   _block_size = 0;
+	std::uint64_t                 _total_size = 0;
+};
+
+inline std::uint32_t rotate_right(std::uint32_t value, unsigned int count)
+{
+	return (value >> count) | (value << (32 - count));
+}
+
+inline void Sha256::update(const char * bytes, std::size_t size)
+{
+	_total_size += size;
+	for (std::size_t i = 0; i < size; ++i) {
+		_block[_block_size++] = static_cast<unsigned char>(bytes[i]);
+		if (_block_size == _block.size()) {
+			process_block(_block.data());
+			_block_size = 0;
+		}
+	}
+}
+
+inline std::string Sha256::hex_digest()
+{
+	const std::uint64_t bit_size = _total_size * 8;
+	const char padding = '\x80';
+	update(&padding, 1);
+	while (_block_size != 56) {
+		const char zero = 0;
+		update(&zero, 1);
+	}
+	for (int shift = 56; shift >= 0; shift -= 8) {
+		const char length_byte = static_cast<char>(bit_size >> shift);
+		update(&length_byte, 1);
+	}
+
+	std::string digest;
+	for (const std::uint32_t word : _state) {
+		char word_hex[9];
+		std::snprintf(word_hex, sizeof(word_hex), "%08x", static_cast<unsigned int>(word));
+		digest += word_hex;
+	}
+	return digest;
+}
+
+inline void Sha256::process_block(const unsigned char * block)
+{
+	static const std::uint32_t ROUND_CONSTANTS[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+	};
+
+	std::uint32_t schedule[64];
+	for (int i = 0; i < 16; ++i) {
+		schedule[i] = std::uint32_t(block[i * 4]) << 24 | std::uint32_t(block[i * 4 + 1]) << 16
+		            | std::uint32_t(block[i * 4 + 2]) << 8 | std::uint32_t(block[i * 4 + 3]);
+	}
+	for (int i = 16; i < 64; ++i) {
+		const std::uint32_t s0 = rotate_right(schedule[i - 15], 7) ^ rotate_right(schedule[i - 15], 18) ^ (schedule[i - 15] >> 3);
+		const std::uint32_t s1 = rotate_right(schedule[i - 2], 17) ^ rotate_right(schedule[i - 2], 19) ^ (schedule[i - 2] >> 10);
+		schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+	}
+
+	std::array<std::uint32_t, 8> w = _state;
+	for (int i = 0; i < 64; ++i) {
+		const std::uint32_t s1 = rotate_right(w[4], 6) ^ rotate_right(w[4], 11) ^ rotate_right(w[4], 25);
+		const std::uint32_t choice = (w[4] & w[5]) ^ (~w[4] & w[6]);
+		const std::uint32_t t1 = w[7] + s1 + choice + ROUND_CONSTANTS[i] + schedule[i];
+		const std::uint32_t s0 = rotate_right(w[0], 2) ^ rotate_right(w[0], 13) ^ rotate_right(w[0], 22);
+		const std::uint32_t majority = (w[0] & w[1]) ^ (w[0] & w[2]) ^ (w[1] & w[2]);
+		const std::uint32_t t2 = s0 + majority;
+		w = { t1 + t2, w[0], w[1], w[2], w[3] + t1, w[4], w[5], w[6] };
+	}
+	for (std::size_t i = 0; i < _state.size(); ++i)
+		_state[i] += w[i];
+}
+
+std::size_t security_dir_offset(unsigned int bits)
+{
+	return bits == 64 ? 0xe8 : 0xd8;
+}
+
+std::size_t number_of_rvas_offset(unsigned int bits)
+{
+	return bits == 64 ? 0xc4 : 0xb4;
+}
+
+std::vector<char> build_image(unsigned int bits)
+{
+	ImageBuilder image_builder { bits, 0x400000 };
+	std::vector<char> text (0x180);
+	for (std::size_t i = 0; i < text.size(); ++i)
+		text[i] = static_cast<char>(i * 7 + 1);
+	image_builder.add_section(".text", std::move(text), 0x60000020);
+	image_builder.set_check_sum(0x12345678);
+	return image_builder.build_file();
+}
+
+std::size_t append_certificate(std::vector<char> & image_data, unsigned int bits, std::size_t trailing_size)
+{
+	const std::size_t certificate_offset = image_data.size() + 0x10;
+	const std::size_t certificate_size = 0x48;
+	image_data.resize(certificate_offset + certificate_size + trailing_size, '\x5a');
+	detail::store_le_value<DWORD>(image_data.data() + certificate_offset, certificate_size);
+	detail::store_le_value<DWORD>(image_data.data() + security_dir_offset(bits), static_cast<DWORD>(certificate_offset));
+	detail::store_le_value<DWORD>(image_data.data() + security_dir_offset(bits) + 4, certificate_size);
+	return certificate_offset;
+}
+
+template <unsigned int XX>
+Ranges ranges_of(const std::vector<char> & image_data)
+{
+	const FileImage<XX, local_buffer> image { LocalBuffer(image_data.data(), image_data.size()) };
+	Ranges ranges;
+	for (const DigestRange & digest_range : authenticode_ranges(image))
+		ranges.emplace_back(digest_range.offset, digest_range.size);
+	return ranges;
+}
+
+template <unsigned int XX, class MemoryBuffer>
+std::string recorded_digest_input(const std::vector<char> & image_data)
+{
+	const FileImage<XX, MemoryBuffer> image { LocalBuffer(image_data.data(), image_data.size()) };
+	RecordingHash hash;
+	return authenticode_digest(image, hash).data;
+}
+
+std::string expected_digest_input(const std::vector<char> & image_data, const Ranges & excluded_ranges)
+{
+	std::string expected;
+	std::size_t offset = 0;
+	for (const auto & [excluded_offset, excluded_size] : excluded_ranges) {
+		expected.append(image_data.data() + offset, excluded_offset - offset);
+		offset = excluded_offset + excluded_size;
+	}
+	expected.append(image_data.data() + offset, image_data.size() - offset);
+	return expected;
+}
+
+template <unsigned int XX>
+void check_digest_ranges(const std::vector<char> & image_data, const Ranges & expected_ranges, const Ranges & excluded_ranges)
+{
+	BOOST_CHECK(ranges_of<XX>(image_data) == expected_ranges);
+
+	const std::string expected_input = expected_digest_input(image_data, excluded_ranges);
+	BOOST_TEST((recorded_digest_input<XX, local_buffer>(image_data) == expected_input));
+	BOOST_TEST((recorded_digest_input<XX, unviewable_digest_buffer>(image_data) == expected_input));
+}
+
+template <unsigned int XX>
+void check_image_ranges()
+{
+	const std::size_t security_dir = security_dir_offset(XX);
+
+	BOOST_TEST_CONTEXT("without certificate table") {
+		const std::vector<char> image_data = build_image(XX);
+		check_digest_ranges<XX>(image_data, {
+			{ 0, CHECK_SUM_OFFSET },
+			{ CHECK_SUM_OFFSET + 4, security_dir - CHECK_SUM_OFFSET - 4 },
+			{ security_dir + 8, HEADERS_END - security_dir - 8 },
+			{ HEADERS_END, SECTION_END - HEADERS_END },
+			{ SECTION_END, DigestRange::TO_END },
+		}, { { CHECK_SUM_OFFSET, 4 }, { security_dir, 8 } });
+	}
+
+	BOOST_TEST_CONTEXT("with certificate table") {
+		std::vector<char> image_data = build_image(XX);
+		const std::size_t certificate_offset = append_certificate(image_data, XX, 0);
+		check_digest_ranges<XX>(image_data, {
+			{ 0, CHECK_SUM_OFFSET },
+			{ CHECK_SUM_OFFSET + 4, security_dir - CHECK_SUM_OFFSET - 4 },
+			{ security_dir + 8, HEADERS_END - security_dir - 8 },
+			{ HEADERS_END, SECTION_END - HEADERS_END },
+			{ SECTION_END, certificate_offset - SECTION_END },
+			{ certificate_offset + 0x48, DigestRange::TO_END },
+		}, { { CHECK_SUM_OFFSET, 4 }, { security_dir, 8 }, { certificate_offset, 0x48 } });
+	}
+
+	BOOST_TEST_CONTEXT("with data after certificate table") {
+		std::vector<char> image_data = build_image(XX);
+		const std::size_t certificate_offset = append_certificate(image_data, XX, 0x21);
+		check_digest_ranges<XX>(image_data, {
+			{ 0, CHECK_SUM_OFFSET },
+			{ CHECK_SUM_OFFSET + 4, security_dir - CHECK_SUM_OFFSET - 4 },
+			{ security_dir + 8, HEADERS_END - security_dir - 8 },
+			{ HEADERS_END, SECTION_END - HEADERS_END },
+			{ SECTION_END, certificate_offset - SECTION_END },
+			{ certificate_offset + 0x48, DigestRange::TO_END },
+		}, { { CHECK_SUM_OFFSET, 4 }, { security_dir, 8 }, { certificate_offset, 0x48 } });
+	}
+
+	BOOST_TEST_CONTEXT("with stripped security directory") {
+		std::vector<char> image_data = build_image(XX);
+		append_certificate(image_data, XX, 0);
+		detail::store_le_value<DWORD>(image_data.data() + number_of_rvas_offset(XX), DIRECTORY_ENTRY_SECURITY);
+		check_digest_ranges<XX>(image_data, {
+			{ 0, CHECK_SUM_OFFSET },
+			{ CHECK_SUM_OFFSET + 4, HEADERS_END - CHECK_SUM_OFFSET - 4 },
+			{ HEADERS_END, SECTION_END - HEADERS_END },
+			{ SECTION_END, DigestRange::TO_END },
+		}, { { CHECK_SUM_OFFSET, 4 } });
+	}
+
+	BOOST_TEST_CONTEXT("with empty certificate table") {
+		std::vector<char> image_data = build_image(XX);
+		append_certificate(image_data, XX, 0);
+		detail::store_le_value<DWORD>(image_data.data() + security_dir + 4, 0);
+		check_digest_ranges<XX>(image_data, {
+			{ 0, CHECK_SUM_OFFSET },
+			{ CHECK_SUM_OFFSET + 4, security_dir - CHECK_SUM_OFFSET - 4 },
+			{ security_dir + 8, HEADERS_END - security_dir - 8 },
+			{ HEADERS_END, SECTION_END - HEADERS_END },
+			{ SECTION_END, DigestRange::TO_END },
+		}, { { CHECK_SUM_OFFSET, 4 }, { security_dir, 8 } });
+	}
+}
+
+std::vector<char> read_test_file(const char * file_name)
+{
+	std::ifstream file { std::string(PEPLUS_TEST_DATA_DIR) + "/" + file_name, std::ios::binary };
+	BOOST_REQUIRE(file);
+	return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(authenticode_digest_suite)
+
+BOOST_AUTO_TEST_CASE(derives_pe32_ranges)
+{
+	check_image_ranges<32>();
+}
+
+BOOST_AUTO_TEST_CASE(derives_pe32plus_ranges)
+{
+	check_image_ranges<64>();
+}
+
+BOOST_AUTO_TEST_CASE(skips_certificate_table_inside_sections)
+{
+	std::vector<char> image_data = build_image(64);
+	detail::store_le_value<DWORD>(image_data.data() + security_dir_offset(64), 0x300);
+	detail::store_le_value<DWORD>(image_data.data() + security_dir_offset(64) + 4, 0x180);
+	image_data.resize(0x480, '\x33');
+
+	const Ranges ranges = ranges_of<64>(image_data);
+	BOOST_REQUIRE(!ranges.empty());
+	BOOST_CHECK(ranges.back() == std::pair(std::size_t(0x480), DigestRange::TO_END));
+}
+
+BOOST_AUTO_TEST_CASE(matches_golden_digest)
+{
+	const std::vector<char> image_data = read_test_file("authenticode64.exe");
+	const std::string golden_digest = "022c1997195f8bc7ef40f68e54a9ad9ab90a9b806ad4ed1e2517fc5d9c5aaad8";
+
+	const FileImage<64, local_buffer> image { LocalBuffer(image_data.data(), image_data.size()) };
+	Sha256 view_hash;
+	BOOST_TEST(authenticode_digest(image, view_hash).hex_digest() == golden_digest);
+
+	const FileImage<64, unviewable_digest_buffer> unviewable_image { LocalBuffer(image_data.data(), image_data.size()) };
+	Sha256 chunked_hash;
+	BOOST_TEST(authenticode_digest(unviewable_image, chunked_hash).hex_digest() == golden_digest);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
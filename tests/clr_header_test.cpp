@@ -0,0 +1,272 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+using namespace std::string_view_literals;
+
+const std::size_t METADATA_OFFSET = 0x50;
+const std::size_t STREAM_HEADERS_OFFSET = 0x20;
+
+struct MetadataStream
+{
+	std::string_view name;
+	std::string      data;
+};
+
+void append_value(std::string & into, DWORD value, std::size_t size)
+{
+	char bytes[sizeof(DWORD)];
+	if (size == sizeof(WORD))
+		detail::store_le_value<WORD>(bytes, static_cast<WORD>(value));
+	else
+		detail::store_le_value<DWORD>(bytes, value);
+	into.append(bytes, size);
+}
+
+void pad_to_dword(std::string & data)
+{
+	data.resize((data.size() + 3) & ~std::size_t(3), '\0');
+}
+
+std::string build_tables_stream(BYTE heap_sizes, DWORD type_ref_rows)
+{
+	const std::size_t string_size = (heap_sizes & METADATA_HEAP_STRING_WIDE) != 0 ? 4 : 2;
+	const std::size_t guid_size = (heap_sizes & METADATA_HEAP_GUID_WIDE) != 0 ? 4 : 2;
+	const std::size_t blob_size = (heap_sizes & METADATA_HEAP_BLOB_WIDE) != 0 ? 4 : 2;
+	const std::size_t coded_size = type_ref_rows < 0x4000 ? 2 : 4;
+
+	std::string tables;
+	append_value(tables, 0, 4);
+	tables += '\x02';
+	tables += '\x00';
+	tables += static_cast<char>(heap_sizes);
+	tables += '\x01';
+	const ULONGLONG valid_tables = 1ull << METADATA_TABLE_MODULE | 1ull << METADATA_TABLE_TYPE_REF
+	                             | 1ull << METADATA_TABLE_TYPE_DEF | 1ull << METADATA_TABLE_METHOD_DEF;
+	append_value(tables, static_cast<DWORD>(valid_tables), 4);
+	append_value(tables, static_cast<DWORD>(valid_tables >> 32), 4);
+	append_value(tables, 0, 4);
+	append_value(tables, 0, 4);
+	for (const DWORD row_count : { DWORD(1), type_ref_rows, DWORD(1), DWORD(1) })
+		append_value(tables, row_count, 4);
+
+	append_value(tables, 0, 2);
+	append_value(tables, 1, string_size);
+	append_value(tables, 1, guid_size);
+	append_value(tables, 0, guid_size);
+	append_value(tables, 0, guid_size);
+
+	for (DWORD row = 0; row < type_ref_rows; ++row) {
+		append_value(tables, 0, coded_size);
+		append_value(tables, 23, string_size);
+		append_value(tables, 0, string_size);
+	}
+
+	append_value(tables, 0x100001, 4);
+	append_value(tables, 10, string_size);
+	append_value(tables, 0, string_size);
+	append_value(tables, 1 << 2 | 1, coded_size);
+	append_value(tables, 1, 2);
+	append_value(tables, 1, 2);
+
+	append_value(tables, 0x2050, 4);
+	append_value(tables, 0, 2);
+	append_value(tables, 0x96, 2);
+	append_value(tables, 18, string_size);
+	append_value(tables, 1, blob_size);
+	append_value(tables, 1, 2);
+
+	pad_to_dword(tables);
+	return tables;
+}
+
+std::string build_metadata(BYTE heap_sizes, DWORD type_ref_rows = 2)
+{
+	std::vector<MetadataStream> streams {
+		{ "#~",       build_tables_stream(heap_sizes, type_ref_rows) },
+		{ "#Strings", std::string("\0test.dll\0Program\0Main\0Object\0"sv) },
+		{ "#US",      std::string("\0\x07h\0i\0!\0\0"sv) },
+		{ "#GUID",    std::string("\x78\x56\x34\x12\x34\x12\x78\x56\x01\x02\x03\x04\x05\x06\x07\x08"sv) },
+		{ "#Blob",    std::string("\0\x03\x00\x00\x01"sv) },
+	};
+
+	std::string metadata;
+	append_value(metadata, METADATA_SIGNATURE, 4);
+	append_value(metadata, 1, 2);
+	append_value(metadata, 1, 2);
+	append_value(metadata, 0, 4);
+	append_value(metadata, 12, 4);
+	metadata.append("v4.0.30319\0\0"sv);
+	append_value(metadata, 0, 2);
+	append_value(metadata, static_cast<DWORD>(streams.size()), 2);
+
+	std::size_t headers_size = 0;
+	for (const MetadataStream & stream : streams)
+		headers_size += 8 + ((stream.name.size() + 1 + 3) & ~std::size_t(3));
+
+	std::size_t stream_offset = metadata.size() + headers_size;
+	for (MetadataStream & stream : streams) {
+		pad_to_dword(stream.data);
+		append_value(metadata, static_cast<DWORD>(stream_offset), 4);
+		append_value(metadata, static_cast<DWORD>(stream.data.size()), 4);
+		metadata.append(stream.name);
+		metadata += '\0';
+		pad_to_dword(metadata);
+		stream_offset += stream.data.size();
+	}
+	for (const MetadataStream & stream : streams)
+		metadata += stream.data;
+	return metadata;
+}
+
+std::vector<char> build_clr_image(const std::string & metadata)
+{
+	std::vector<char> text (METADATA_OFFSET + metadata.size());
+	std::copy(metadata.begin(), metadata.end(), text.begin() + METADATA_OFFSET);
+
+	test::ImageBuilder builder { 32, 0x400000 };
+	const DWORD text_rva = builder.next_section_rva();
+	detail::store_le_value<DWORD>(text.data() + offsetof(Cor20Header, cb), sizeof(Cor20Header));
+	detail::store_le_value<WORD>(text.data() + offsetof(Cor20Header, major_runtime_version), 2);
+	detail::store_le_value<WORD>(text.data() + offsetof(Cor20Header, minor_runtime_version), 5);
+	detail::store_le_value<DWORD>(text.data() + offsetof(Cor20Header, metadata), static_cast<DWORD>(text_rva + METADATA_OFFSET));
+	detail::store_le_value<DWORD>(text.data() + offsetof(Cor20Header, metadata) + 4, static_cast<DWORD>(metadata.size()));
+	detail::store_le_value<DWORD>(text.data() + offsetof(Cor20Header, flags), COMIMAGE_FLAGS_ILONLY);
+	builder.set_data_directory(DIRECTORY_ENTRY_COMDESCRIPTOR, text_rva, sizeof(Cor20Header));
+	builder.add_section(".text", std::move(text), 0x60000020);
+	return builder.build_file();
+}
+
+void check_row_sizes(const MetadataFacade & metadata, std::size_t module, std::size_t type_ref, std::size_t type_def, std::size_t method_def)
+{
+	BOOST_TEST(metadata.table(METADATA_TABLE_MODULE).row_size() == module);
+	BOOST_TEST(metadata.table(METADATA_TABLE_TYPE_REF).row_size() == type_ref);
+	BOOST_TEST(metadata.table(METADATA_TABLE_TYPE_DEF).row_size() == type_def);
+	BOOST_TEST(metadata.table(METADATA_TABLE_METHOD_DEF).row_size() == method_def);
+}
+
+void check_table_values(const MetadataFacade & metadata)
+{
+	const MetadataTableView & type_def = metadata.table(METADATA_TABLE_TYPE_DEF);
+	BOOST_TEST(type_def.get(0, 0) == 0x100001u);
+	BOOST_CHECK(metadata.string(type_def.get(0, 1)) == std::optional<std::string_view>("Program"));
+
+	const std::optional<MetadataToken> extends = decode_coded_index(CODED_INDEX_TYPE_DEF_OR_REF, type_def.get(0, 3));
+	BOOST_REQUIRE(extends);
+	BOOST_TEST(extends->table == METADATA_TABLE_TYPE_REF);
+	BOOST_TEST(extends->row == 1u);
+
+	const MetadataTableView & method_def = metadata.table(METADATA_TABLE_METHOD_DEF);
+	BOOST_TEST(method_def.get(0, 0) == 0x2050u);
+	BOOST_TEST(method_def.get(0, 2) == 0x96u);
+	BOOST_CHECK(metadata.string(method_def.get(0, 3)) == std::optional<std::string_view>("Main"));
+	BOOST_CHECK(metadata.blob(method_def.get(0, 4)) == std::optional<std::string_view>("\x00\x00\x01"sv));
+
+	const MetadataColumnView type_ref_names = metadata.table(METADATA_TABLE_TYPE_REF).column(1);
+	BOOST_TEST(std::all_of(type_ref_names.begin(), type_ref_names.end(), [] (DWORD name) { return name == 23; }));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(clr_header_suite)
+
+BOOST_AUTO_TEST_CASE(reads_metadata_root_from_image)
+{
+	const std::string metadata_data = build_metadata(0);
+	const std::vector<char> file = build_clr_image(metadata_data);
+	const FileImage<32, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+
+	const auto clr_header = image.clr_header();
+	BOOST_REQUIRE(clr_header);
+	BOOST_TEST(clr_header->is_il_only());
+	BOOST_TEST(!clr_header->is_strong_name_signed());
+
+	const std::optional<MetadataFacade> metadata = clr_header->metadata_root();
+	BOOST_REQUIRE(metadata);
+	BOOST_TEST(metadata->major_version() == 1u);
+	BOOST_TEST(metadata->version() == "v4.0.30319");
+
+	BOOST_TEST(metadata->streams().size() == 5u);
+	BOOST_TEST(metadata->streams()[1].name == "#Strings");
+	BOOST_TEST(metadata->stream("#GUID").value_or("").size() == 16u);
+	BOOST_TEST(!metadata->stream("#Nope"));
+	BOOST_CHECK(metadata->string(1) == std::optional<std::string_view>("test.dll"));
+	BOOST_TEST(!metadata->string(0x100));
+	BOOST_CHECK(metadata->user_string(1) == std::optional<std::string_view>("h\0i\0!\0"sv));
+
+	const std::optional<Guid> mvid = metadata->guid(1);
+	BOOST_REQUIRE(mvid);
+	BOOST_TEST(mvid->data1 == 0x12345678u);
+	BOOST_TEST(mvid->data2 == 0x1234u);
+	BOOST_TEST(mvid->data3 == 0x5678u);
+	BOOST_TEST(!metadata->guid(2));
+
+	BOOST_TEST(metadata->has_table(METADATA_TABLE_TYPE_DEF));
+	BOOST_TEST(!metadata->has_table(METADATA_TABLE_FIELD));
+	BOOST_TEST(metadata->row_count(METADATA_TABLE_MODULE) == 1u);
+	BOOST_TEST(metadata->row_count(METADATA_TABLE_TYPE_REF) == 2u);
+	BOOST_TEST(metadata->row_count(METADATA_TABLE_FIELD) == 0u);
+	check_row_sizes(*metadata, 10, 6, 14, 14);
+	check_table_values(*metadata);
+}
+
+BOOST_AUTO_TEST_CASE(widens_heap_indexes)
+{
+	const std::string metadata_data = build_metadata(METADATA_HEAP_STRING_WIDE | METADATA_HEAP_GUID_WIDE | METADATA_HEAP_BLOB_WIDE);
+	const MetadataFacade metadata { metadata_data };
+
+	BOOST_TEST(metadata.heap_sizes() == 0x07u);
+	check_row_sizes(metadata, 18, 10, 18, 18);
+	BOOST_TEST(metadata.table(METADATA_TABLE_MODULE).column_size(1) == 4u);
+	BOOST_TEST(metadata.table(METADATA_TABLE_METHOD_DEF).column_size(5) == 2u);
+	check_table_values(metadata);
+}
+
+BOOST_AUTO_TEST_CASE(widens_coded_indexes_with_row_counts)
+{
+	const std::string metadata_data = build_metadata(0, 0x4000);
+	const MetadataFacade metadata { metadata_data };
+
+	BOOST_TEST(metadata.row_count(METADATA_TABLE_TYPE_REF) == 0x4000u);
+	check_row_sizes(metadata, 10, 8, 16, 14);
+	check_table_values(metadata);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_truncated_stream_headers)
+{
+	const std::string metadata_data = build_metadata(0);
+	BOOST_CHECK_THROW(MetadataFacade(std::string_view(metadata_data).substr(0, STREAM_HEADERS_OFFSET + 6)), std::runtime_error);
+	BOOST_CHECK_THROW(MetadataFacade(std::string_view(metadata_data).substr(0, STREAM_HEADERS_OFFSET + 0x14)), std::runtime_error);
+	BOOST_CHECK_THROW(MetadataFacade(std::string_view(metadata_data).substr(0, 0x18)), std::runtime_error);
+
+	std::string oversized_stream = metadata_data;
+	detail::store_le_value<DWORD>(oversized_stream.data() + STREAM_HEADERS_OFFSET + 4, static_cast<DWORD>(metadata_data.size()));
+	BOOST_CHECK_THROW(MetadataFacade { oversized_stream }, std::runtime_error);
+
+	std::string truncated_table = metadata_data;
+	const std::size_t type_ref_rows_offset = detail::load_le_value<DWORD>(metadata_data.data() + STREAM_HEADERS_OFFSET) + 24 + 4;
+	detail::store_le_value<DWORD>(truncated_table.data() + type_ref_rows_offset, 0x1000);
+	BOOST_CHECK_THROW(MetadataFacade { truncated_table }, std::runtime_error);
+
+	const std::vector<char> file = build_clr_image(metadata_data.substr(0, STREAM_HEADERS_OFFSET + 0x14));
+	const FileImage<32, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	BOOST_CHECK_THROW(image.clr_header()->metadata_root(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+#include "image_builder.hpp"
+
+#include <peplus/coff_symbol_index.hpp>
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+void append_symbol(std::vector<char> & file, const char (& name)[SIZEOF_SHORT_NAME], DWORD value,
+                   std::int16_t section_number, WORD type)
+{
+	char symbol[SIZEOF_SYMBOL] {};
+	std::memcpy(symbol, name, SIZEOF_SHORT_NAME);
+	detail::store_le_value<DWORD>(symbol + 8, value);
+	detail::store_le_value<WORD>(symbol + 12, static_cast<WORD>(section_number));
+	detail::store_le_value<WORD>(symbol + 14, type);
+	symbol[16] = static_cast<char>(SYM_CLASS_EXTERNAL);
+	file.insert(file.end(), symbol, symbol + SIZEOF_SYMBOL);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(coff_symbol_index_suite)
+
+BOOST_AUTO_TEST_CASE(decodes_short_and_long_names)
+{
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	const DWORD text_rva = builder.add_section(".text", std::vector<char>(0x200, '\xcc'), 0x60000020);
+	std::vector<char> file = builder.build_file();
+
+	const std::size_t symbol_table_offset = file.size();
+	const char long_name_ref[SIZEOF_SHORT_NAME] = { 0, 0, 0, 0, 4, 0, 0, 0 };
+	append_symbol(file, { 'm', 'a', 'i', 'n' }, 0x10, 1, SYM_DTYPE_FUNCTION << SYM_DTYPE_SHIFT);
+	append_symbol(file, long_name_ref, 0x80, 1, 0);
+	append_symbol(file, { 'e', 'i', 'g', 'h', 't', 'c', 'h', 'r' }, 0x40, 1, 0);
+
+	const std::string_view long_name { "a_rather_long_symbol_name", 26 };
+	char string_table_size[sizeof(DWORD)];
+	detail::store_le_value<DWORD>(string_table_size, static_cast<DWORD>(sizeof(DWORD) + long_name.size()));
+	file.insert(file.end(), string_table_size, string_table_size + sizeof(DWORD));
+	file.insert(file.end(), long_name.begin(), long_name.end());
+
+	char * const file_header = file.data() + 0x40 + 4;
+	detail::store_le_value<DWORD>(file_header + offsetof(FileHeader, pointer_to_symbol_table), static_cast<DWORD>(symbol_table_offset));
+	detail::store_le_value<DWORD>(file_header + offsetof(FileHeader, number_of_symbols), 3);
+
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const CoffSymbolIndex symbol_index { image };
+	BOOST_REQUIRE_EQUAL(symbol_index.size(), 3u);
+
+	const auto & symbols = symbol_index.symbols();
+	BOOST_TEST(symbol_index.name(symbols[0]) == "main");
+	BOOST_TEST(symbols[0].rva == text_rva + 0x10);
+	BOOST_TEST(symbols[0].is_function);
+	BOOST_TEST(symbol_index.name(symbols[1]) == "eightchr");
+	BOOST_TEST(symbol_index.name(symbols[2]) == "a_rather_long_symbol_name");
+	BOOST_TEST(symbols[2].symbol_index == 1u);
+
+	const CoffSymbolIndex::Symbol * const symbol = symbol_index.find(VirtualOffset(text_rva + 0x90));
+	BOOST_REQUIRE(symbol != nullptr);
+	BOOST_TEST(symbol_index.name(*symbol) == "a_rather_long_symbol_name");
+
+	std::vector<bool> has_long_name;
+	for (const auto & coff_symbol : image.coff_symbols())
+		has_long_name.push_back(coff_symbol.has_long_name());
+	BOOST_TEST(has_long_name == std::vector<bool>({ false, true, false }), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/guard_cf_table.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+const ULONGLONG IMAGE_BASE = 0x140000000ull;
+const std::size_t TABLE_OFFSET = 0x200;
+const std::size_t RDATA_SIZE = 0x1000;
+
+std::vector<char> build_guarded_image(const std::vector<DWORD> & targets, std::size_t stride, ULONGLONG declared_count)
+{
+	std::vector<char> rdata (RDATA_SIZE);
+	detail::store_le_value<DWORD>(rdata.data() + offsetof(LoadConfigDirectory<64>, size), sizeof(LoadConfigDirectory<64>));
+	detail::store_le_value<DWORD>(rdata.data() + offsetof(LoadConfigDirectory<64>, guard_flags),
+	                              GUARD_CF_FUNCTION_TABLE_PRESENT | static_cast<DWORD>(stride - sizeof(DWORD)) << GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT);
+	detail::store_le_value<ULONGLONG>(rdata.data() + offsetof(LoadConfigDirectory<64>, guard_cf_function_count), declared_count);
+	for (std::size_t i = 0; i < targets.size(); ++i)
+		detail::store_le_value<DWORD>(rdata.data() + TABLE_OFFSET + i * stride, targets[i]);
+
+	test::ImageBuilder builder { 64, IMAGE_BASE };
+	const DWORD rdata_rva = builder.next_section_rva();
+	detail::store_le_value<ULONGLONG>(rdata.data() + offsetof(LoadConfigDirectory<64>, guard_cf_function_table),
+	                                  IMAGE_BASE + rdata_rva + TABLE_OFFSET);
+	builder.set_data_directory(DIRECTORY_ENTRY_LOADCONFIG, rdata_rva, sizeof(LoadConfigDirectory<64>));
+	builder.add_section(".rdata", std::move(rdata), 0x40000040);
+	return builder.build_file();
+}
+
+GuardCFTable guard_cf_table_of(const std::vector<char> & file)
+{
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	return GuardCFTable(image);
+}
+
+std::vector<DWORD> pseudo_random_targets(std::size_t count, std::uint32_t seed)
+{
+	std::vector<DWORD> targets (count);
+	for (DWORD & target : targets) {
+		seed = seed * 1664525 + 1013904223;
+		target = 0x1000 + (seed >> 20);
+	}
+	return targets;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(guard_cf_table_suite)
+
+BOOST_AUTO_TEST_CASE(reads_sorted_unique_targets)
+{
+	const std::vector<char> file = build_guarded_image({ 0x2010, 0x2000, 0x2030, 0x2010 }, 5, 4);
+	const GuardCFTable table = guard_cf_table_of(file);
+
+	BOOST_TEST(table.targets() == std::vector<DWORD>({ 0x2000, 0x2010, 0x2030 }), boost::test_tools::per_element());
+	BOOST_TEST(table.contains(VirtualOffset(0x2000)));
+	BOOST_TEST(table.contains(VirtualOffset(0x2030)));
+	BOOST_TEST(!table.contains(VirtualOffset(0x2001)));
+	BOOST_TEST(!table.contains(VirtualOffset(0x3000)));
+	BOOST_TEST(!table.contains(VirtualOffset(-0x2000)));
+}
+
+BOOST_AUTO_TEST_CASE(answers_unsorted_batch_queries)
+{
+	const std::vector<char> file = build_guarded_image(pseudo_random_targets(0x180, 1), 4, 0x180);
+	const GuardCFTable table = guard_cf_table_of(file);
+	BOOST_REQUIRE(!table.empty());
+
+	std::vector<VirtualOffset> queries;
+	for (const DWORD target : pseudo_random_targets(0x100, 1))
+		queries.push_back(VirtualOffset(target));
+	for (const DWORD target : pseudo_random_targets(0x100, 2))
+		queries.push_back(VirtualOffset(target));
+	queries.push_back(VirtualOffset(-1));
+	queries.push_back(VirtualOffset(table.targets().front()));
+	queries.push_back(VirtualOffset(table.targets().back()));
+
+	for (bool sorted : { false, true }) {
+		if (sorted) std::sort(queries.begin(), queries.end());
+
+		std::vector<bool> results;
+		table.contains(queries.begin(), queries.end(), std::back_inserter(results));
+		BOOST_REQUIRE_EQUAL(results.size(), queries.size());
+		for (std::size_t i = 0; i < queries.size(); ++i)
+			BOOST_TEST(results[i] == table.contains(queries[i]), "query " << queries[i].value());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bounds_count_by_section_extent)
+{
+	const std::vector<char> file = build_guarded_image({ 0x2000, 0x2010 }, 5, 0x10000000000ull);
+	const GuardCFTable table = guard_cf_table_of(file);
+
+	BOOST_TEST(table.size() == 3u);
+	BOOST_TEST(table.contains(VirtualOffset(0)));
+	BOOST_TEST(table.contains(VirtualOffset(0x2000)));
+	BOOST_TEST(table.contains(VirtualOffset(0x2010)));
+
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	BOOST_TEST(image.load_config_directory()->guard_cf_function_table_count() == (RDATA_SIZE - TABLE_OFFSET) / 5);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_overflowing_count)
+{
+	const std::vector<char> file = build_guarded_image({ 0x2000 }, 5, ~0ull);
+	BOOST_CHECK_THROW(guard_cf_table_of(file), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,204 @@
+#ifndef PEPLUS_TESTS_IMAGEBUILDER_HPP_
+#define PEPLUS_TESTS_IMAGEBUILDER_HPP_
+
+#include <peplus/headers.hpp>
+#include <peplus/detail/image_helpers.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace peplus::test {
+
+class ImageBuilder
+{
+public:
+	static constexpr DWORD FILE_ALIGNMENT = 0x200;
+	static constexpr DWORD SECTION_ALIGNMENT = 0x1000;
+	static constexpr DWORD NT_HEADERS_OFFSET = 0x40;
+
+	ImageBuilder(unsigned int bits, ULONGLONG image_base);
+
+	DWORD add_section(std::string_view name, std::vector<char> data, DWORD characteristics);
+	void set_data_directory(unsigned int index, DWORD rva, DWORD size);
+	void set_check_sum(DWORD check_sum);
+
+	DWORD next_section_rva() const;
+	std::size_t check_sum_offset() const;
+	std::size_t image_base_offset() const;
+
+	std::vector<char> build_file() const;
+	std::vector<char> build_mapped() const;
+
+private:
+	struct Section
+	{
+		std::string_view  name;
+		std::vector<char> data;
+		DWORD             characteristics;
+		DWORD             rva;
+	};
+
+	std::size_t optional_header_offset() const;
+	std::size_t optional_header_size() const;
+	DWORD headers_size() const;
+	std::vector<char> build_headers() const;
+
+	unsigned int                              _bits;
+	ULONGLONG                                 _image_base;
+	DWORD                                     _check_sum = 0;
+	std::vector<Section>                      _sections;
+	std::vector<std::pair<DWORD, DWORD>>      _data_directories;
+};
+
+inline DWORD align_up(DWORD value, DWORD alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+inline void append_relocation_block(std::vector<char> & relocations, DWORD page_rva, const std::vector<WORD> & type_offsets)
+{
+	const std::size_t block_offset = relocations.size();
+	relocations.resize(block_offset + sizeof(BaseRelocation) + type_offsets.size() * sizeof(WORD));
+	detail::store_le_value<DWORD>(relocations.data() + block_offset, page_rva);
+	detail::store_le_value<DWORD>(relocations.data() + block_offset + 4, static_cast<DWORD>(relocations.size() - block_offset));
+
+	std::size_t type_offset_offset = block_offset + sizeof(BaseRelocation);
+	for (const WORD type_offset : type_offsets) {
+		detail::store_le_value<WORD>(relocations.data() + type_offset_offset, type_offset);
+		type_offset_offset += sizeof(WORD);
+	}
+}
+
+inline ImageBuilder::ImageBuilder(unsigned int bits, ULONGLONG image_base)
+	: _bits { bits }, _image_base { image_base }, _data_directories (16) {}
+
+inline DWORD ImageBuilder::add_section(std::string_view name, std::vector<char> data, DWORD characteristics)
+{
+	const DWORD rva = next_section_rva();
+	_sections.push_back(Section { name, std::move(data), characteristics, rva });
+	return rva;
+}
+
+inline void ImageBuilder::set_data_directory(unsigned int index, DWORD rva, DWORD size)
+{
+	_data_directories.at(index) = std::pair(rva, size);
+}
+
+inline void ImageBuilder::set_check_sum(DWORD check_sum)
+{
+	_check_sum = check_sum;
+}
+
+inline DWORD ImageBuilder::next_section_rva() const
+{
+	if (_sections.empty()) return SECTION_ALIGNMENT;
+	const Section & last_section = _sections.back();
+	return align_up(last_section.rva + std::max<DWORD>(static_cast<DWORD>(last_section.data.size()), 1), SECTION_ALIGNMENT);
+}
+
+inline std::size_t ImageBuilder::check_sum_offset() const
+{
+	return optional_header_offset() + 64;
+}
+
+inline std::size_t ImageBuilder::image_base_offset() const
+{
+	return optional_header_offset() + (_bits == 64 ? 24 : 28);
+}
+
+inline std::size_t ImageBuilder::optional_header_offset() const
+{
+	return NT_HEADERS_OFFSET + 4 + sizeof(FileHeader);
+}
+
+inline std::size_t ImageBuilder::optional_header_size() const
+{
+	return _bits == 64 ? 0xf0 : 0xe0;
+}
+
+inline DWORD ImageBuilder::headers_size() const
+{
+	const std::size_t headers_end = optional_header_offset() + optional_header_size() + _sections.size() * sizeof(SectionHeader);
+	return align_up(static_cast<DWORD>(headers_end), FILE_ALIGNMENT);
+}
+
+inline std::vector<char> ImageBuilder::build_headers() const
+{
+	using detail::store_le_value;
+
+	std::vector<char> headers (headers_size());
+	store_le_value<WORD>(headers.data(), 0x5a4d);
+	store_le_value<DWORD>(headers.data() + 0x3c, NT_HEADERS_OFFSET);
+	store_le_value<DWORD>(headers.data() + NT_HEADERS_OFFSET, 0x4550);
+
+	char * const file_header = headers.data() + NT_HEADERS_OFFSET + 4;
+	store_le_value<WORD>(file_header, _bits == 64 ? 0x8664 : 0x14c);
+	store_le_value<WORD>(file_header + 2, static_cast<WORD>(_sections.size()));
+	store_le_value<WORD>(file_header + 16, static_cast<WORD>(optional_header_size()));
+	store_le_value<WORD>(file_header + 18, 0x22);
+
+	char * const optional_header = headers.data() + optional_header_offset();
+	store_le_value<WORD>(optional_header, _bits == 64 ? 0x20b : 0x10b);
+	store_le_value<DWORD>(optional_header + 16, SECTION_ALIGNMENT);
+	if (_bits == 64)
+		store_le_value<QWORD>(optional_header + 24, _image_base);
+	else
+		store_le_value<DWORD>(optional_header + 28, static_cast<DWORD>(_image_base));
+	store_le_value<DWORD>(optional_header + 32, SECTION_ALIGNMENT);
+	store_le_value<DWORD>(optional_header + 36, FILE_ALIGNMENT);
+	store_le_value<WORD>(optional_header + 40, 6);
+	store_le_value<WORD>(optional_header + 48, 6);
+	store_le_value<DWORD>(optional_header + 56, next_section_rva());
+	store_le_value<DWORD>(optional_header + 60, headers_size());
+	store_le_value<DWORD>(optional_header + 64, _check_sum);
+	store_le_value<WORD>(optional_header + 68, 3);
+
+	char * const data_directories = optional_header + optional_header_size() - 16 * sizeof(DataDirectory);
+	store_le_value<DWORD>(data_directories - 4, 16);
+	for (std::size_t i = 0; i < _data_directories.size(); ++i) {
+		store_le_value<DWORD>(data_directories + i * sizeof(DataDirectory), _data_directories[i].first);
+		store_le_value<DWORD>(data_directories + i * sizeof(DataDirectory) + 4, _data_directories[i].second);
+	}
+
+	DWORD raw_offset = headers_size();
+	char * section_header = optional_header + optional_header_size();
+	for (const Section & section : _sections) {
+		const DWORD raw_size = align_up(static_cast<DWORD>(section.data.size()), FILE_ALIGNMENT);
+		std::copy(section.name.begin(), section.name.begin() + std::min<std::size_t>(section.name.size(), 8), section_header);
+		store_le_value<DWORD>(section_header + 8, static_cast<DWORD>(section.data.size()));
+		store_le_value<DWORD>(section_header + 12, section.rva);
+		store_le_value<DWORD>(section_header + 16, raw_size);
+		store_le_value<DWORD>(section_header + 20, raw_offset);
+		store_le_value<DWORD>(section_header + 36, section.characteristics);
+		section_header += sizeof(SectionHeader);
+		raw_offset += raw_size;
+	}
+
+	return headers;
+}
+
+inline std::vector<char> ImageBuilder::build_file() const
+{
+	std::vector<char> file = build_headers();
+	for (const Section & section : _sections) {
+		file.insert(file.end(), section.data.begin(), section.data.end());
+		file.resize(align_up(static_cast<DWORD>(file.size()), FILE_ALIGNMENT));
+	}
+	return file;
+}
+
+inline std::vector<char> ImageBuilder::build_mapped() const
+{
+	std::vector<char> image = build_headers();
+	image.resize(next_section_rva());
+	for (const Section & section : _sections)
+		std::copy(section.data.begin(), section.data.end(), image.begin() + section.rva);
+	return image;
+}
+
+}
+
+#endif
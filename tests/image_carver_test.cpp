@@ -0,0 +1,58 @@
+#include "image_builder.hpp"
+
+#include <peplus/image_carver.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+std::vector<char> build_carvable_image(unsigned int bits)
+{
+	test::ImageBuilder builder { bits, bits == 64 ? 0x140000000ull : 0x400000ull };
+	builder.add_section(".text", std::vector<char>(0x300, '\xcc'), 0x60000020);
+	builder.add_section(".data", std::vector<char>(0x180, '\x11'), 0xc0000040);
+	return builder.build_file();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(image_carver)
+
+BOOST_AUTO_TEST_CASE(carves_images_across_chunk_boundaries)
+{
+	const std::vector<char> image64 = build_carvable_image(64);
+	const std::vector<char> image32 = build_carvable_image(32);
+
+	std::vector<char> data (2 * detail::CARVE_CHUNK_SIZE + 0x10000);
+	for (std::size_t offset = 0; offset < data.size(); offset += 0x1001) {
+		data[offset] = 'M';
+		data[offset + 1] = 'Z';
+	}
+
+	const std::vector<std::pair<std::size_t, const std::vector<char> *>> embedded_images {
+		{ 0x100, &image64 },
+		{ detail::CARVE_CHUNK_SIZE - 7, &image32 },
+		{ 2 * detail::CARVE_CHUNK_SIZE - 1, &image64 },
+	};
+	for (const auto & [offset, image] : embedded_images)
+		std::copy(image->begin(), image->end(), data.begin() + offset);
+
+	for (unsigned int thread_count : { 1u, 4u }) {
+		const std::vector<CarvedImage> carved_images = carve_images(data.data(), data.size(), thread_count);
+		BOOST_REQUIRE(carved_images.size() == embedded_images.size());
+		for (std::size_t i = 0; i < carved_images.size(); ++i) {
+			BOOST_TEST(carved_images[i].offset == embedded_images[i].first);
+			BOOST_TEST(carved_images[i].size == embedded_images[i].second->size());
+			BOOST_TEST(carved_images[i].bitness == (embedded_images[i].second == &image64 ? 64u : 32u));
+		}
+		BOOST_TEST(carved_images[0].image<64>().file_header().number_of_sections == 2u);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
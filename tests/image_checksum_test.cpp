@@ -0,0 +1,126 @@
+#include <peplus/file_image.hpp>
+#include <peplus/image_checksum.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace peplus {
+
+struct unviewable_buffer
+{
+	using value_type = LocalBuffer;
+
+	static std::size_t read(const LocalBuffer & buffer, std::size_t offset, std::size_t data_size, void * into_buffer)
+	{
+		return local_buffer::read(buffer, offset, data_size, into_buffer);
+	}
+};
+
+}
+
+using namespace peplus;
+
+namespace {
+
+struct GoldenImage
+{
+	const char * file_name;
+	DWORD        check_sum;
+};
+
+const GoldenImage GOLDEN_IMAGES[] = {
+	{ "checksum32.exe",       0x00010a5a },
+	{ "checksum64_odd.exe",   0x00002194 },
+	{ "checksum64_large.exe", 0x00022cca },
+};
+
+std::vector<char> read_test_file(const char * file_name)
+{
+	std::ifstream file { std::string(PEPLUS_TEST_DATA_DIR) + "/" + file_name, std::ios::binary };
+	BOOST_REQUIRE(file);
+	return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+template <class MemoryBuffer>
+DWORD checksum_of(const std::vector<char> & image_data, bool & is_valid)
+{
+	const WORD magic = detail::load_le_value<WORD>(image_data.data() + 0x40 + 4 + sizeof(FileHeader));
+	if (magic == OPTIONAL_HDR64_MAGIC) {
+		const FileImage<64, MemoryBuffer> image { LocalBuffer(image_data.data(), image_data.size()) };
+		is_valid = verify_checksum(image);
+		return compute_checksum(image);
+	}
+
+	const FileImage<32, MemoryBuffer> image { LocalBuffer(image_data.data(), image_data.size()) };
+	is_valid = verify_checksum(image);
+	return compute_checksum(image);
+}
+
+std::uint64_t reference_word_sum(const char * data, std::size_t size)
+{
+	std::uint64_t sum = 0;
+	for (std::size_t offset = 0; offset + 2 <= size; offset += 2)
+		sum += detail::load_le_value<WORD>(data + offset);
+	return sum;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(image_checksum)
+
+BOOST_AUTO_TEST_CASE(matches_golden_images)
+{
+	for (const GoldenImage & golden_image : GOLDEN_IMAGES) {
+		BOOST_TEST_CONTEXT(golden_image.file_name) {
+			const std::vector<char> image_data = read_test_file(golden_image.file_name);
+
+			bool is_valid = false;
+			BOOST_TEST(checksum_of<local_buffer>(image_data, is_valid) == golden_image.check_sum);
+			BOOST_TEST(is_valid);
+			BOOST_TEST(checksum_of<unviewable_buffer>(image_data, is_valid) == golden_image.check_sum);
+			BOOST_TEST(is_valid);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(streams_arbitrary_chunks)
+{
+	for (const GoldenImage & golden_image : GOLDEN_IMAGES) {
+		BOOST_TEST_CONTEXT(golden_image.file_name) {
+			const std::vector<char> image_data = read_test_file(golden_image.file_name);
+			const std::size_t checksum_offset = detail::load_le_value<DWORD>(image_data.data() + 0x3c) + 4
+			                                  + sizeof(FileHeader) + offsetof(OptionalHeader<32>, check_sum);
+
+			for (std::size_t chunk_size : { 1, 3, 7, 64, 4095, 0x10001 }) {
+				ChecksumCalculator checksum_calculator { checksum_offset };
+				for (std::size_t offset = 0; offset < image_data.size(); offset += chunk_size)
+					checksum_calculator.update(image_data.data() + offset, std::min(chunk_size, image_data.size() - offset));
+				BOOST_TEST(checksum_calculator.size() == image_data.size());
+				BOOST_TEST(checksum_calculator.value() == golden_image.check_sum);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(sums_words_across_block_boundaries)
+{
+	std::vector<char> data (0x200000 + 0x47, '\xff');
+	for (std::size_t offset = 0; offset < data.size(); offset += 0x101)
+		data[offset] = static_cast<char>(offset);
+
+	for (std::size_t first : { 0, 1, 2, 31 }) {
+		for (std::size_t size : { std::size_t(0), std::size_t(2), std::size_t(30), std::size_t(0x100000), data.size() - first }) {
+			const std::size_t even_size = size & ~std::size_t(1);
+			BOOST_TEST(detail::sum_le_words(data.data() + first, even_size) == reference_word_sum(data.data() + first, even_size));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
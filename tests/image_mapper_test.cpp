@@ -0,0 +1,73 @@
+#include "image_builder.hpp"
+
+#include <peplus/image_mapper.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+std::vector<char> byte_pattern(std::size_t size, char seed)
+{
+	std::vector<char> bytes (size);
+	for (std::size_t i = 0; i < size; ++i)
+		bytes[i] = static_cast<char>(seed + i * 7);
+	return bytes;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(image_mapper_suite)
+
+BOOST_AUTO_TEST_CASE(maps_sections_into_place)
+{
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	const DWORD text_rva = builder.add_section(".text", byte_pattern(0x1234, 1), 0x60000020);
+	const std::vector<char> file = builder.build_file();
+
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const MappedImage mapped_image = map_image(image);
+	BOOST_TEST(mapped_image.size() == builder.next_section_rva());
+	BOOST_TEST(std::vector<char>(mapped_image.data() + text_rva, mapped_image.data() + text_rva + 0x1234) == byte_pattern(0x1234, 1),
+	           boost::test_tools::per_element());
+}
+
+#ifdef PEPLUS_HAS_MMAP
+
+BOOST_AUTO_TEST_CASE(maps_sections_truncated_by_end_of_file)
+{
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	builder.add_section(".text", byte_pattern(0xe00, 1), 0x60000020);
+	const DWORD data_rva = builder.add_section(".data", byte_pattern(0x4000, 2), 0xc0000040);
+	std::vector<char> file = builder.build_file();
+	BOOST_REQUIRE_EQUAL(file.size(), 0x5000u);
+
+	const std::size_t truncated_size = 0x2800;
+	file.resize(truncated_size);
+
+	std::FILE * const temp_file = std::tmpfile();
+	BOOST_REQUIRE(temp_file != nullptr);
+	BOOST_REQUIRE_EQUAL(std::fwrite(file.data(), 1, file.size(), temp_file), file.size());
+	BOOST_REQUIRE_EQUAL(std::fflush(temp_file), 0);
+
+	const MappedImage mapped_image = map_image_file<64>(::fileno(temp_file));
+	std::fclose(temp_file);
+
+	const std::vector<char> expected_data = byte_pattern(0x4000, 2);
+	const std::size_t file_data_size = truncated_size - 0x1000;
+	const char * const section_data = mapped_image.data() + data_rva;
+	BOOST_TEST(std::vector<char>(section_data, section_data + file_data_size)
+	        == std::vector<char>(expected_data.begin(), expected_data.begin() + file_data_size),
+	           boost::test_tools::per_element());
+	BOOST_TEST(std::vector<char>(section_data + file_data_size, section_data + 0x4000) == std::vector<char>(0x4000 - file_data_size),
+	           boost::test_tools::per_element());
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/image_overlay.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace peplus {
+
+struct unviewable_overlay_buffer
+{
+	using value_type = LocalBuffer;
+
+	static std::size_t read(const LocalBuffer & buffer, std::size_t offset, std::size_t data_size, void * into_buffer)
+	{
+		return local_buffer::read(buffer, offset, data_size, into_buffer);
+	}
+};
+
+}
+
+using namespace peplus;
+
+namespace {
+
+const std::size_t SECTIONS_END = 0x400;
+const std::size_t CERTIFICATE_SIZE = 0x48;
+
+struct RecordingHash
+{
+	std::string data;
+
+	void update(const char * bytes, std::size_t size) { data.append(bytes, size); }
+};
+
+std::vector<char> build_image()
+{
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	builder.add_section(".text", std::vector<char>(0x180, '\xcc'), 0x60000020);
+	return builder.build_file();
+}
+
+std::string append_overlay(std::vector<char> & file, std::size_t size, char fill)
+{
+	const std::string overlay (size, fill);
+	file.insert(file.end(), overlay.begin(), overlay.end());
+	return overlay;
+}
+
+void append_certificate(std::vector<char> & file)
+{
+	const std::size_t certificate_offset = file.size();
+	file.resize(certificate_offset + CERTIFICATE_SIZE, '\x30');
+	detail::store_le_value<DWORD>(file.data() + certificate_offset, CERTIFICATE_SIZE);
+
+	const std::size_t security_dir_offset = test::ImageBuilder::NT_HEADERS_OFFSET + 4 + sizeof(FileHeader)
+	                                      + offsetof(OptionalHeader<64>, data_directory)
+	                                      + DIRECTORY_ENTRY_SECURITY * sizeof(DataDirectory);
+	detail::store_le_value<DWORD>(file.data() + security_dir_offset, static_cast<DWORD>(certificate_offset));
+	detail::store_le_value<DWORD>(file.data() + security_dir_offset + 4, CERTIFICATE_SIZE);
+}
+
+template <class MemoryBuffer>
+std::string streamed_overlay(const std::vector<char> & file)
+{
+	const FileImage<64, MemoryBuffer> image { LocalBuffer(file.data(), file.size()) };
+	const ImageOverlay overlay { image };
+	RecordingHash hash;
+	return overlay.hash(hash).data;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(image_overlay_suite)
+
+BOOST_AUTO_TEST_CASE(reports_missing_overlay)
+{
+	const std::vector<char> file = build_image();
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const ImageOverlay overlay { image };
+
+	BOOST_TEST(overlay.empty());
+	BOOST_TEST(overlay.offset().value() == std::ptrdiff_t(SECTIONS_END));
+	BOOST_CHECK(overlay.size() == std::optional<std::size_t>(0));
+	BOOST_CHECK(overlay.view() == std::optional<std::string_view>(std::string_view()));
+
+	const FileImage<64, unviewable_overlay_buffer> unviewable_image { LocalBuffer(file.data(), file.size()) };
+	BOOST_TEST(ImageOverlay(unviewable_image).empty());
+}
+
+BOOST_AUTO_TEST_CASE(exposes_overlay_without_certificate_table)
+{
+	std::vector<char> file = build_image();
+	const std::string expected = append_overlay(file, 0x123, '\x5a');
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const ImageOverlay overlay { image };
+
+	BOOST_TEST(!overlay.empty());
+	BOOST_TEST(overlay.offset().value() == std::ptrdiff_t(SECTIONS_END));
+	BOOST_CHECK(overlay.size() == std::optional<std::size_t>(expected.size()));
+	BOOST_CHECK(overlay.view() == std::optional<std::string_view>(expected));
+	BOOST_TEST(streamed_overlay<local_buffer>(file) == expected);
+	BOOST_TEST(streamed_overlay<unviewable_overlay_buffer>(file) == expected);
+
+	const FileImage<64, unviewable_overlay_buffer> unviewable_image { LocalBuffer(file.data(), file.size()) };
+	const ImageOverlay unviewable_overlay { unviewable_image };
+	BOOST_TEST(!unviewable_overlay.empty());
+	BOOST_TEST(!unviewable_overlay.size());
+}
+
+BOOST_AUTO_TEST_CASE(excludes_trailing_certificate_table)
+{
+	std::vector<char> file = build_image();
+	const std::string expected = append_overlay(file, 0x100, '\x5a');
+	append_certificate(file);
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const ImageOverlay overlay { image };
+
+	BOOST_TEST(!overlay.empty());
+	BOOST_CHECK(overlay.size() == std::optional<std::size_t>(expected.size()));
+	BOOST_TEST(streamed_overlay<local_buffer>(file) == expected);
+	BOOST_TEST(streamed_overlay<unviewable_overlay_buffer>(file) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(skips_certificate_table_inside_overlay)
+{
+	std::vector<char> file = build_image();
+	const std::string leading = append_overlay(file, 0x40, '\x5a');
+	append_certificate(file);
+	const std::string trailing = append_overlay(file, 0x30, '\xa5');
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const ImageOverlay overlay { image };
+
+	BOOST_TEST(!overlay.empty());
+	BOOST_TEST(overlay.ranges().size() == 2u);
+	BOOST_CHECK(overlay.size() == std::optional<std::size_t>(leading.size() + trailing.size()));
+	BOOST_TEST(!overlay.view());
+	BOOST_TEST(streamed_overlay<local_buffer>(file) == leading + trailing);
+	BOOST_TEST(streamed_overlay<unviewable_overlay_buffer>(file) == leading + trailing);
+}
+
+BOOST_AUTO_TEST_CASE(starts_after_certificate_table_at_sections_end)
+{
+	std::vector<char> file = build_image();
+	append_certificate(file);
+	const std::string expected = append_overlay(file, 0x21, '\xa5');
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const ImageOverlay overlay { image };
+
+	BOOST_TEST(overlay.offset().value() == std::ptrdiff_t(SECTIONS_END + CERTIFICATE_SIZE));
+	BOOST_CHECK(overlay.view() == std::optional<std::string_view>(expected));
+	BOOST_TEST(streamed_overlay<unviewable_overlay_buffer>(file) == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
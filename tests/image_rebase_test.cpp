@@ -0,0 +1,157 @@
+#include "image_builder.hpp"
+
+#include <peplus/image_rebase.hpp>
+#include <peplus/virtual_image.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace peplus;
+using detail::load_le_value;
+using detail::store_le_value;
+
+namespace {
+
+const DWORD SECTION_CHARACTERISTICS = 0x60000020;
+const DWORD RELOC_CHARACTERISTICS = 0x42000040;
+
+std::vector<char> build_relocated_image(unsigned int bits, ULONGLONG image_base, std::vector<char> data,
+                                        const std::vector<char> & relocations)
+{
+	test::ImageBuilder builder { bits, image_base };
+	builder.add_section(".data", std::move(data), SECTION_CHARACTERISTICS);
+	const DWORD reloc_rva = builder.next_section_rva();
+	builder.set_data_directory(DIRECTORY_ENTRY_BASERELOC, reloc_rva, static_cast<DWORD>(relocations.size()));
+	builder.add_section(".reloc", relocations, RELOC_CHARACTERISTICS);
+	return builder.build_mapped();
+}
+
+std::size_t relocate(std::vector<char> & image_mem, std::size_t page_rva, const std::vector<WORD> & type_offsets,
+                     std::int64_t delta)
+{
+	return detail::relocate_block(image_mem.data(), image_mem.size(), page_rva, type_offsets.data(),
+	                              type_offsets.size(), delta);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(image_rebase)
+
+BOOST_AUTO_TEST_CASE(rebases_dir64_blocks)
+{
+	const ULONGLONG image_base = 0x140000000;
+	const ULONGLONG new_base = 0x7ff612340000;
+
+	std::vector<char> data (0x2000);
+	for (DWORD offset = 0; offset < data.size(); offset += 0x18)
+		store_le_value<QWORD>(data.data() + offset, image_base + 0x1000 + offset);
+
+	std::vector<char> relocations;
+	for (DWORD page = 0; page < data.size(); page += 0x1000) {
+		std::vector<WORD> type_offsets;
+		for (DWORD offset = (page + 0x17) / 0x18 * 0x18; offset < page + 0x1000 && offset < data.size(); offset += 0x18)
+			type_offsets.push_back(static_cast<WORD>(REL_BASED_DIR64 << 12 | (offset - page)));
+		test::append_relocation_block(relocations, 0x1000 + page, type_offsets);
+	}
+
+	std::vector<char> image_mem = build_relocated_image(64, image_base, data, relocations);
+	const std::size_t relocations_applied = rebase_image<64>(image_mem.data(), image_mem.size(), new_base);
+
+	BOOST_TEST(relocations_applied == (data.size() + 0x17) / 0x18);
+	for (DWORD offset = 0; offset < data.size(); offset += 0x18)
+		BOOST_TEST(load_le_value<QWORD>(image_mem.data() + 0x1000 + offset) == new_base + 0x1000 + offset);
+
+	const VirtualImage64<local_buffer> image { LocalBuffer(image_mem.data(), image_mem.size()) };
+	BOOST_TEST(image.optional_header().image_base == new_base);
+}
+
+BOOST_AUTO_TEST_CASE(rebases_highlow_blocks_with_padding)
+{
+	const DWORD image_base = 0x400000;
+	const DWORD new_base = 0x10000000;
+
+	std::vector<char> data (0x1000);
+	store_le_value<DWORD>(data.data() + 0x000, 0x401000);
+	store_le_value<DWORD>(data.data() + 0x010, 0x402345);
+	store_le_value<DWORD>(data.data() + 0xffc, 0x4fffff);
+
+	std::vector<char> relocations;
+	test::append_relocation_block(relocations, 0x1000, {
+		REL_BASED_HIGHLOW << 12 | 0x000, REL_BASED_HIGHLOW << 12 | 0x010,
+		REL_BASED_HIGHLOW << 12 | 0xffc, REL_BASED_ABSOLUTE << 12
+	});
+
+	std::vector<char> image_mem = build_relocated_image(32, image_base, data, relocations);
+	BOOST_TEST(rebase_image<32>(image_mem.data(), image_mem.size(), new_base) == 3u);
+	BOOST_TEST(load_le_value<DWORD>(image_mem.data() + 0x1000) == 0x10001000u);
+	BOOST_TEST(load_le_value<DWORD>(image_mem.data() + 0x1010) == 0x10002345u);
+	BOOST_TEST(load_le_value<DWORD>(image_mem.data() + 0x1ffc) == 0x100fffffu);
+
+	BOOST_TEST(rebase_image<32>(image_mem.data(), image_mem.size(), image_base) == 3u);
+	BOOST_TEST(load_le_value<DWORD>(image_mem.data() + 0x1000) == 0x401000u);
+	BOOST_TEST(load_le_value<DWORD>(image_mem.data() + 0x1ffc) == 0x4fffffu);
+}
+
+BOOST_AUTO_TEST_CASE(rebases_highadj_entries)
+{
+	std::vector<char> image_mem (0x2000);
+	store_le_value<WORD>(image_mem.data() + 0x1000, 0x8765);
+	store_le_value<WORD>(image_mem.data() + 0x1002, 0x1234);
+	store_le_value<WORD>(image_mem.data() + 0x1004, 0xffff);
+
+	const std::vector<WORD> type_offsets {
+		REL_BASED_HIGHADJ << 12 | 0x000, 0x0123,
+		REL_BASED_HIGHADJ << 12 | 0x002, 0x9000,
+		REL_BASED_HIGHADJ << 12 | 0x004, 0x0123,
+	};
+	BOOST_TEST(relocate(image_mem, 0x1000, type_offsets, 0x00018000) == 3u);
+	BOOST_TEST(load_le_value<WORD>(image_mem.data() + 0x1000) == 0x8767);
+	BOOST_TEST(load_le_value<WORD>(image_mem.data() + 0x1002) == 0x1235);
+	BOOST_TEST(load_le_value<WORD>(image_mem.data() + 0x1004) == 0x0001);
+
+	BOOST_TEST(relocate(image_mem, 0x1000, { REL_BASED_HIGHADJ << 12 | 0x000, 0x0000 }, -0x00010000) == 1u);
+	BOOST_TEST(load_le_value<WORD>(image_mem.data() + 0x1000) == 0x8766);
+}
+
+BOOST_AUTO_TEST_CASE(rebases_mixed_blocks)
+{
+	std::vector<char> image_mem (0x3000);
+	store_le_value<WORD>(image_mem.data() + 0x2000, 0x0040);
+	store_le_value<WORD>(image_mem.data() + 0x2002, 0xfff0);
+	store_le_value<DWORD>(image_mem.data() + 0x2004, 0x00401000);
+	store_le_value<QWORD>(image_mem.data() + 0x2008, 0x140001000);
+	store_le_value<WORD>(image_mem.data() + 0x2010, 0x0040);
+	store_le_value<QWORD>(image_mem.data() + 0x2ff8, 0x140002000);
+
+	const std::vector<WORD> type_offsets {
+		REL_BASED_HIGH << 12 | 0x000,
+		REL_BASED_LOW << 12 | 0x002,
+		REL_BASED_ABSOLUTE << 12,
+		REL_BASED_HIGHLOW << 12 | 0x004,
+		REL_BASED_DIR64 << 12 | 0x008,
+		REL_BASED_HIGHADJ << 12 | 0x010, 0x1000,
+		REL_BASED_DIR64 << 12 | 0xff8,
+		REL_BASED_ABSOLUTE << 12,
+	};
+	BOOST_TEST(relocate(image_mem, 0x2000, type_offsets, 0x00120020) == 6u);
+	BOOST_TEST(load_le_value<WORD>(image_mem.data() + 0x2000) == 0x0052);
+	BOOST_TEST(load_le_value<WORD>(image_mem.data() + 0x2002) == 0x0010);
+	BOOST_TEST(load_le_value<DWORD>(image_mem.data() + 0x2004) == 0x00521020u);
+	BOOST_TEST(load_le_value<QWORD>(image_mem.data() + 0x2008) == 0x140121020u);
+	BOOST_TEST(load_le_value<WORD>(image_mem.data() + 0x2010) == 0x0052);
+	BOOST_TEST(load_le_value<QWORD>(image_mem.data() + 0x2ff8) == 0x140122020u);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_malformed_blocks)
+{
+	std::vector<char> image_mem (0x2000);
+	BOOST_CHECK_THROW(relocate(image_mem, 0x1000, { REL_BASED_HIGHADJ << 12 | 0x000 }, 0x10000), std::runtime_error);
+	BOOST_CHECK_THROW(relocate(image_mem, 0x1000, { REL_BASED_DIR64 << 12 | 0xffc }, 0x10000), std::runtime_error);
+	BOOST_CHECK_THROW(relocate(image_mem, 0x1000, { 0xb000 | 0x000 }, 0x10000), std::runtime_error);
+	BOOST_TEST(relocate(image_mem, 0x1000, { REL_BASED_ABSOLUTE << 12, REL_BASED_ABSOLUTE << 12 }, 0x10000) == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
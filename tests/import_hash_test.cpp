@@ -0,0 +1,116 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/import_hash.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+struct ImportedModule
+{
+	std::string              name;
+	std::vector<std::string> symbols;
+};
+
+struct RecordingHash
+{
+	std::string data;
+
+	void update(const char * bytes, std::size_t size) { data.append(bytes, size); }
+};
+
+std::vector<char> build_import_image(const std::vector<ImportedModule> & modules)
+{
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	const DWORD idata_rva = builder.next_section_rva();
+
+	std::vector<char> idata ((modules.size() + 1) * sizeof(ImportDescriptor));
+	const auto append = [&idata] (std::size_t size) {
+		const std::size_t offset = idata.size();
+		idata.resize(offset + size);
+		return offset;
+	};
+
+	for (std::size_t module = 0; module < modules.size(); ++module) {
+		const ImportedModule & imported_module = modules[module];
+		const std::size_t name_offset = append(imported_module.name.size() + 1);
+		std::copy(imported_module.name.begin(), imported_module.name.end(), idata.begin() + name_offset);
+
+		const std::size_t thunks_offset = append((imported_module.symbols.size() + 1) * sizeof(ThunkData<64>));
+		for (std::size_t i = 0; i < imported_module.symbols.size(); ++i) {
+			const std::string & symbol = imported_module.symbols[i];
+			ULONGLONG thunk;
+			if (symbol[0] == '#') {
+				thunk = ORDINAL_FLAG<64> | std::stoul(symbol.substr(1));
+			} else {
+				if (idata.size() % 2 != 0) append(1);
+				const std::size_t hint_name_offset = append(sizeof(WORD) + symbol.size() + 1);
+				std::copy(symbol.begin(), symbol.end(), idata.begin() + hint_name_offset + sizeof(WORD));
+				thunk = idata_rva + hint_name_offset;
+			}
+			detail::store_le_value<ULONGLONG>(idata.data() + thunks_offset + i * sizeof(ThunkData<64>), thunk);
+		}
+
+		char * const descriptor = idata.data() + module * sizeof(ImportDescriptor);
+		detail::store_le_value<DWORD>(descriptor + offsetof(ImportDescriptor, original_first_thunk), static_cast<DWORD>(idata_rva + thunks_offset));
+		detail::store_le_value<DWORD>(descriptor + offsetof(ImportDescriptor, name), static_cast<DWORD>(idata_rva + name_offset));
+		detail::store_le_value<DWORD>(descriptor + offsetof(ImportDescriptor, first_thunk), static_cast<DWORD>(idata_rva + thunks_offset));
+	}
+
+	builder.add_section(".idata", idata, 0x40000040);
+	builder.set_data_directory(DIRECTORY_ENTRY_IMPORT, idata_rva, static_cast<DWORD>((modules.size() + 1) * sizeof(ImportDescriptor)));
+	return builder.build_file();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(import_hash_suite)
+
+BOOST_AUTO_TEST_CASE(matches_pefile_imphash_input)
+{
+	const std::vector<char> file = build_import_image({
+		{ "KERNEL32.dll", { "CreateFileW", "#17" } },
+		{ "WS2_32.dll",   { "#23", "#115" } },
+		{ "OLEAUT32.DLL", { "#2", "VariantInit" } },
+		{ "comctl.ocx",   { "DllRegisterServer" } },
+		{ "HAL.SYS",      { "KfRaiseIrql" } },
+		{ "mylib",        { "Init" } },
+		{ "helper.exe",   { "Run" } },
+	});
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+
+	RecordingHash hash;
+	BOOST_TEST(import_hash(image, hash).data == "kernel32.createfilew,kernel32.ord17,"
+	                                           "ws2_32.socket,ws2_32.wsastartup,"
+	                                           "oleaut32.sysallocstring,oleaut32.variantinit,"
+	                                           "comctl.dllregisterserver,hal.kfraiseirql,mylib.init,helper.exe.run");
+}
+
+BOOST_AUTO_TEST_CASE(fingerprint_ignores_import_order)
+{
+	const std::vector<char> file = build_import_image({
+		{ "KERNEL32.dll", { "CreateFileW", "CloseHandle" } },
+		{ "WS2_32.dll",   { "#23" } },
+	});
+	const std::vector<char> reordered_file = build_import_image({
+		{ "ws2_32.DLL",   { "#23" } },
+		{ "kernel32.dll", { "CloseHandle", "CreateFileW", "CloseHandle" } },
+	});
+
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const FileImage<64, local_buffer> reordered_image { LocalBuffer(reordered_file.data(), reordered_file.size()) };
+	BOOST_TEST(import_fingerprint(image) == import_fingerprint(reordered_image));
+	BOOST_TEST(import_name_hashes(image).size() == 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,190 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/import_resolver.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+struct TestExport
+{
+	std::string_view name;
+	DWORD            rva;
+	std::string_view forwarder;
+};
+
+std::shared_ptr<const ExportIndex> make_export_index(std::string_view module_name, ULONGLONG image_base,
+                                                     const std::vector<TestExport> & exports)
+{
+	test::ImageBuilder builder { 64, image_base };
+	const DWORD edata_rva = builder.next_section_rva();
+
+	std::vector<char> edata (sizeof(ExportDirectory) + exports.size() * (2 * sizeof(DWORD) + sizeof(WORD)));
+	const std::size_t functions_offset = sizeof(ExportDirectory);
+	const std::size_t names_offset = functions_offset + exports.size() * sizeof(DWORD);
+	const std::size_t ordinals_offset = names_offset + exports.size() * sizeof(DWORD);
+	const auto append_string = [&edata, edata_rva] (std::string_view value) {
+		const std::size_t offset = edata.size();
+		edata.insert(edata.end(), value.begin(), value.end());
+		edata.push_back('\0');
+		return static_cast<DWORD>(edata_rva + offset);
+	};
+
+	const DWORD name_rva = append_string(module_name);
+	for (std::size_t i = 0; i < exports.size(); ++i) {
+		const DWORD function_rva = exports[i].forwarder.empty() ? exports[i].rva : append_string(exports[i].forwarder);
+		detail::store_le_value<DWORD>(edata.data() + functions_offset + i * sizeof(DWORD), function_rva);
+		detail::store_le_value<DWORD>(edata.data() + names_offset + i * sizeof(DWORD), append_string(exports[i].name));
+		detail::store_le_value<WORD>(edata.data() + ordinals_offset + i * sizeof(WORD), static_cast<WORD>(i));
+	}
+
+	char * const export_dir = edata.data();
+	detail::store_le_value<DWORD>(export_dir + offsetof(ExportDirectory, name), name_rva);
+	detail::store_le_value<DWORD>(export_dir + offsetof(ExportDirectory, base), 1);
+	detail::store_le_value<DWORD>(export_dir + offsetof(ExportDirectory, number_of_functions), static_cast<DWORD>(exports.size()));
+	detail::store_le_value<DWORD>(export_dir + offsetof(ExportDirectory, number_of_names), static_cast<DWORD>(exports.size()));
+	detail::store_le_value<DWORD>(export_dir + offsetof(ExportDirectory, address_of_functions), static_cast<DWORD>(edata_rva + functions_offset));
+	detail::store_le_value<DWORD>(export_dir + offsetof(ExportDirectory, address_of_names), static_cast<DWORD>(edata_rva + names_offset));
+	detail::store_le_value<DWORD>(export_dir + offsetof(ExportDirectory, address_of_name_ordinals), static_cast<DWORD>(edata_rva + ordinals_offset));
+
+	const DWORD edata_size = static_cast<DWORD>(edata.size());
+	builder.add_section(".edata", std::move(edata), 0x40000040);
+	builder.set_data_directory(DIRECTORY_ENTRY_EXPORT, edata_rva, edata_size);
+
+	const std::vector<char> file = builder.build_file();
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	return std::make_shared<const ExportIndex>(image);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(import_resolver_suite)
+
+BOOST_AUTO_TEST_CASE(follows_forwarder_chains)
+{
+	ModuleSet modules;
+	modules.add("kernel32.dll", make_export_index("KERNEL32.dll", 0x180000000, {
+		{ "HeapAlloc", 0, "NTDLL.RtlAllocateHeap" },
+		{ "Loop",      0, "kernel32.Loop" },
+	}));
+	modules.add("ntdll.dll", make_export_index("ntdll.dll", 0x7ff000000000, {
+		{ "RtlAllocateHeap", 0x1230, {} },
+	}));
+
+	const ImportBinding binding = modules.resolve("KERNEL32", "HeapAlloc");
+	BOOST_TEST((binding.status == ImportBindingStatus::Bound));
+	BOOST_TEST(binding.address == 0x7ff000001230u);
+	BOOST_TEST(binding.forwarder_count == 1u);
+	BOOST_TEST(binding.module->name() == "ntdll.dll");
+	BOOST_TEST(modules.cached_forwarder_count() == 1u);
+
+	const ImportBinding cached_binding = modules.resolve("kernel32.dll", "HeapAlloc");
+	BOOST_TEST(cached_binding.address == binding.address);
+	BOOST_TEST(cached_binding.forwarder_count == 1u);
+
+	BOOST_TEST((modules.resolve("kernel32", "Loop").status == ImportBindingStatus::ForwarderCycle));
+	BOOST_TEST((modules.resolve("user32", "MessageBoxA").status == ImportBindingStatus::ModuleNotFound));
+	BOOST_TEST((modules.resolve("ntdll", "Missing").status == ImportBindingStatus::ExportNotFound));
+}
+
+BOOST_AUTO_TEST_CASE(bindings_outlive_replaced_modules)
+{
+	ModuleSet modules;
+	modules.add("kernel32.dll", make_export_index("KERNEL32.dll", 0x180000000, {
+		{ "HeapAlloc", 0, "NTDLL.RtlAllocateHeap" },
+	}));
+	modules.add("ntdll.dll", make_export_index("ntdll.dll", 0x7ff000000000, {
+		{ "RtlAllocateHeap", 0x1230, {} },
+	}));
+
+	const std::shared_ptr<const ExportIndex> old_ntdll = modules.find("ntdll");
+	const ImportBinding old_binding = modules.resolve("kernel32", "HeapAlloc");
+
+	modules.add("ntdll.dll", make_export_index("ntdll.dll", 0x7ff100000000, {
+		{ "RtlAllocateHeap", 0x4560, {} },
+	}));
+	BOOST_TEST(modules.cached_forwarder_count() == 0u);
+
+	BOOST_TEST(old_ntdll->image_base() == 0x7ff000000000u);
+	BOOST_TEST(old_binding.module == old_ntdll);
+	BOOST_TEST(old_binding.module->find("RtlAllocateHeap")->rva.value() == 0x1230);
+
+	const ImportBinding new_binding = modules.resolve("kernel32", "HeapAlloc");
+	BOOST_TEST(new_binding.address == 0x7ff100004560u);
+	BOOST_TEST(new_binding.module != old_ntdll);
+}
+
+BOOST_AUTO_TEST_CASE(forwarder_cache_drops_stale_generations)
+{
+	const std::shared_ptr<const ExportIndex> module = make_export_index("ntdll.dll", 0x7ff000000000, {
+		{ "RtlAllocateHeap", 0x1230, {} },
+	});
+	const ImportBinding binding { ImportBindingStatus::Bound, module, 1, VirtualOffset(0x1230), 0x7ff000001230, 0 };
+
+	detail::ForwarderCache forwarder_cache;
+	const std::uint64_t stale_generation = forwarder_cache.generation();
+	forwarder_cache.clear();
+	forwarder_cache.insert(module, 1, binding, stale_generation);
+	BOOST_TEST(forwarder_cache.size() == 0u);
+
+	const std::uint64_t generation = forwarder_cache.generation();
+	forwarder_cache.insert(module, 1, binding, generation);
+	BOOST_TEST(forwarder_cache.size() == 1u);
+	BOOST_TEST(forwarder_cache.find(module, 1, generation).has_value());
+	BOOST_TEST(!forwarder_cache.find(module, 1, stale_generation).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(resolves_while_modules_are_replaced)
+{
+	ModuleSet modules;
+	modules.add("kernel32.dll", make_export_index("KERNEL32.dll", 0x180000000, {
+		{ "HeapAlloc", 0, "NTDLL.RtlAllocateHeap" },
+	}));
+
+	std::vector<std::shared_ptr<const ExportIndex>> ntdll_versions;
+	for (ULONGLONG i = 0; i < 8; ++i) {
+		ntdll_versions.push_back(make_export_index("ntdll.dll", 0x7ff000000000 + (i << 32), {
+			{ "RtlAllocateHeap", 0x1230, {} },
+		}));
+	}
+	modules.add("ntdll.dll", ntdll_versions[0]);
+
+	std::atomic<bool> stop { false };
+	std::atomic<bool> failed { false };
+	std::vector<std::thread> resolvers;
+	for (unsigned int i = 0; i < 2; ++i) {
+		resolvers.emplace_back([&] {
+			while (!stop) {
+				const ImportBinding binding = modules.resolve("kernel32", "HeapAlloc");
+				if (binding.status != ImportBindingStatus::Bound || binding.address != binding.module->image_base() + 0x1230)
+					failed = true;
+			}
+		});
+	}
+	for (std::size_t i = 1; i < 400; ++i) {
+		modules.add("ntdll.dll", ntdll_versions[i % ntdll_versions.size()]);
+		std::this_thread::yield();
+	}
+	stop = true;
+	for (std::thread & resolver : resolvers)
+		resolver.join();
+
+	BOOST_TEST(!failed);
+	const ImportBinding binding = modules.resolve("kernel32", "HeapAlloc");
+	BOOST_TEST(binding.module == ntdll_versions[399 % ntdll_versions.size()]);
+	BOOST_TEST(binding.address == ntdll_versions[399 % ntdll_versions.size()]->image_base() + 0x1230);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
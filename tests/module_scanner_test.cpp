@@ -0,0 +1,51 @@
+#if defined(__linux__)
+
+#include "image_builder.hpp"
+
+#include <peplus/module_scanner.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace peplus;
+
+BOOST_AUTO_TEST_SUITE(module_scanner)
+
+BOOST_AUTO_TEST_CASE(finds_images_mapped_in_current_process)
+{
+	test::ImageBuilder builder { 64, 0x140000000 };
+	builder.add_section(".text", std::vector<char>(0x100, '\xcc'), 0x60000020);
+	const std::vector<char> image_mem = builder.build_mapped();
+
+	void * const mapping = ::mmap(nullptr, image_mem.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	BOOST_REQUIRE(mapping != MAP_FAILED);
+	std::copy(image_mem.begin(), image_mem.end(), static_cast<char *>(mapping));
+
+	const auto mapping_address = reinterpret_cast<std::uintptr_t>(mapping);
+	for (unsigned int thread_count : { 1u, 4u }) {
+		const std::vector<LoadedModule> loaded_modules = scan_process_modules(::getpid(), thread_count);
+		BOOST_TEST(std::is_sorted(loaded_modules.begin(), loaded_modules.end(), [] (const LoadedModule & lhs, const LoadedModule & rhs) {
+			return lhs.base_address < rhs.base_address;
+		}));
+
+		const auto module_it = std::find_if(loaded_modules.begin(), loaded_modules.end(), [&] (const LoadedModule & loaded_module) {
+			return loaded_module.base_address == mapping_address;
+		});
+		BOOST_REQUIRE(module_it != loaded_modules.end());
+		BOOST_TEST(module_it->bitness == 64u);
+		BOOST_TEST(module_it->size_of_image == image_mem.size());
+		BOOST_TEST(module_it->image<64>().optional_header().image_base == 0x140000000u);
+	}
+
+	::munmap(mapping, image_mem.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
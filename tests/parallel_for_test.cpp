@@ -0,0 +1,46 @@
+#include <peplus/detail/parallel_for.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using peplus::detail::parallel_for;
+
+BOOST_AUTO_TEST_SUITE(parallel_for_suite)
+
+BOOST_AUTO_TEST_CASE(runs_every_task_once)
+{
+	for (unsigned int thread_count : { 1u, 2u, 8u }) {
+		std::vector<std::atomic<unsigned int>> task_runs (1000);
+		parallel_for(task_runs.size(), thread_count, [&] (std::size_t task) {
+			++task_runs[task];
+		});
+		for (const std::atomic<unsigned int> & runs : task_runs)
+			BOOST_TEST(runs == 1u);
+	}
+
+	parallel_for(0, 4, [] (std::size_t) { BOOST_FAIL("Unexpected task"); });
+}
+
+BOOST_AUTO_TEST_CASE(propagates_exceptions)
+{
+	for (unsigned int thread_count : { 1u, 4u }) {
+		BOOST_CHECK_THROW(parallel_for(100, thread_count, [] (std::size_t task) {
+			if (task == 42) throw std::runtime_error("Task failed");
+		}), std::runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(supports_nested_loops)
+{
+	std::atomic<std::size_t> task_runs { 0 };
+	parallel_for(16, 4, [&] (std::size_t) {
+		parallel_for(16, 4, [&] (std::size_t) { ++task_runs; });
+	});
+	BOOST_TEST(task_runs == 256u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+#if defined(__linux__)
+
+#include <peplus/process_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace peplus;
+
+namespace {
+
+const std::size_t PAGE_COUNT = 4;
+
+struct GuardedPagesFixture
+{
+	GuardedPagesFixture()
+	{
+		page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+		void * const mapping = ::mmap(nullptr, PAGE_COUNT * page_size, PROT_READ | PROT_WRITE,
+		                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		BOOST_REQUIRE(mapping != MAP_FAILED);
+		pages = static_cast<char *>(mapping);
+		for (std::size_t i = 0; i < PAGE_COUNT * page_size; ++i)
+			pages[i] = static_cast<char>(i * 7 + 1);
+		BOOST_REQUIRE(::mprotect(pages + 2 * page_size, page_size, PROT_NONE) == 0);
+	}
+
+	~GuardedPagesFixture()
+	{
+		::munmap(pages, PAGE_COUNT * page_size);
+	}
+
+	std::size_t   page_size;
+	char        * pages;
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(process_buffer_suite, GuardedPagesFixture)
+
+BOOST_AUTO_TEST_CASE(reads_current_process)
+{
+	const ProcessMemory memory { ::getpid(), reinterpret_cast<std::uintptr_t>(pages) };
+
+	std::vector<char> data (page_size + 0x20);
+	BOOST_TEST(process_buffer::read(memory, 0x10, data.size(), data.data()) == data.size());
+	BOOST_TEST(std::memcmp(data.data(), pages + 0x10, data.size()) == 0);
+
+	pages[0x10] = 0x55;
+	BOOST_TEST(process_buffer::read(memory, 0x10, 1, data.data()) == 1u);
+	BOOST_TEST(data[0] != 0x55);
+	memory.invalidate();
+	BOOST_TEST(process_buffer::read(memory, 0x10, 1, data.data()) == 1u);
+	BOOST_TEST(data[0] == 0x55);
+}
+
+BOOST_AUTO_TEST_CASE(returns_readable_prefix)
+{
+	const ProcessMemory memory { ::getpid(), reinterpret_cast<std::uintptr_t>(pages) };
+
+	std::vector<char> data (2 * page_size);
+	BOOST_TEST(process_buffer::read(memory, page_size + 0x100, data.size(), data.data()) == page_size - 0x100);
+	BOOST_TEST(std::memcmp(data.data(), pages + page_size + 0x100, page_size - 0x100) == 0);
+
+	std::vector<char> large_data (PAGE_COUNT * page_size);
+	BOOST_TEST(process_buffer::read(memory, 0x20, large_data.size() - 0x20, large_data.data()) == 2 * page_size - 0x20);
+	BOOST_TEST(std::memcmp(large_data.data(), pages + 0x20, 2 * page_size - 0x20) == 0);
+
+	BOOST_TEST(process_buffer::read(memory, 2 * page_size, 0x10, data.data()) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(returns_short_read_for_missing_process)
+{
+	const ProcessMemory memory { -1, reinterpret_cast<std::uintptr_t>(pages) };
+
+	std::vector<char> data (0x10);
+	BOOST_TEST(process_buffer::read(memory, 0, data.size(), data.data()) == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,77 @@
+#include "image_builder.hpp"
+
+#include <peplus/relocation_index.hpp>
+#include <peplus/virtual_image.hpp>
+#include <peplus/local_buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+std::vector<char> build_relocated_image()
+{
+	test::ImageBuilder builder { 32, 0x400000ull };
+	const DWORD data_rva = builder.add_section(".data", std::vector<char>(0x2000, '\x5a'), 0xc0000040);
+
+	std::vector<char> relocations;
+	test::append_relocation_block(relocations, data_rva, {
+		static_cast<WORD>(REL_BASED_HIGHLOW << 12 | 0x010),
+		static_cast<WORD>(REL_BASED_HIGHADJ << 12 | 0x100), 0x3200,
+		static_cast<WORD>(REL_BASED_DIR64 << 12 | 0xffc),
+		static_cast<WORD>(REL_BASED_ABSOLUTE << 12),
+	});
+
+	const DWORD reloc_rva = builder.next_section_rva();
+	builder.set_data_directory(DIRECTORY_ENTRY_BASERELOC, reloc_rva, static_cast<DWORD>(relocations.size()));
+	builder.add_section(".reloc", relocations, 0x42000040);
+	return builder.build_mapped();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(relocation_index_suite)
+
+BOOST_AUTO_TEST_CASE(indexes_relocated_bytes_across_pages)
+{
+	const std::vector<char> image_mem = build_relocated_image();
+	const VirtualImage<32, local_buffer> image { LocalBuffer(image_mem.data(), image_mem.size()) };
+	const RelocationIndex relocation_index { image };
+	BOOST_TEST(relocation_index.size() == 3u);
+
+	BOOST_TEST(!relocation_index.contains(VirtualOffset(0x100f)));
+	BOOST_TEST(relocation_index.contains(VirtualOffset(0x1010)));
+	BOOST_TEST(relocation_index.contains(VirtualOffset(0x1013)));
+	BOOST_TEST(!relocation_index.contains(VirtualOffset(0x1014)));
+
+	BOOST_TEST(relocation_index.contains(VirtualOffset(0x1101)));
+	BOOST_TEST(!relocation_index.contains(VirtualOffset(0x1102)));
+	BOOST_TEST(!relocation_index.contains(VirtualOffset(0x1200)));
+
+	BOOST_TEST(relocation_index.contains(VirtualOffset(0x1ffc)));
+	BOOST_TEST(relocation_index.contains(VirtualOffset(0x2003)));
+	BOOST_TEST(!relocation_index.contains(VirtualOffset(0x2004)));
+	BOOST_TEST(!relocation_index.contains(VirtualOffset(0x1000)));
+
+	BOOST_TEST(relocation_index.overlaps(VirtualOffset(0x1ff0), 0x10));
+	BOOST_TEST(relocation_index.overlaps(VirtualOffset(0x2000), 1));
+	BOOST_TEST(relocation_index.overlaps(VirtualOffset(0x1014), 0x1000));
+	BOOST_TEST(!relocation_index.overlaps(VirtualOffset(0x1014), 0xec));
+	BOOST_TEST(!relocation_index.overlaps(VirtualOffset(0x2004), 0x100));
+	BOOST_TEST(!relocation_index.overlaps(VirtualOffset(0x1ff0), 0));
+	BOOST_TEST(relocation_index.overlaps(VirtualOffset(0x1ff0), std::numeric_limits<std::size_t>::max()));
+	BOOST_TEST(!relocation_index.overlaps(VirtualOffset(0x2004), std::numeric_limits<std::size_t>::max()));
+	BOOST_TEST(!relocation_index.overlaps(VirtualOffset(-1), 0x10));
+
+	std::vector<char> bytes (0x20, 'x');
+	relocation_index.mask_bytes(VirtualOffset(0x1ff0), bytes.data(), bytes.size(), '?');
+	for (std::size_t i = 0; i < bytes.size(); ++i)
+		BOOST_TEST(bytes[i] == (i >= 0xc && i < 0x14 ? '?' : 'x'));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+#include <peplus/section_statistics.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+std::vector<char> pseudo_random_bytes(std::size_t size, std::uint32_t seed)
+{
+	std::vector<char> bytes (size);
+	for (char & byte : bytes) {
+		seed = seed * 1664525 + 1013904223;
+		byte = static_cast<char>(seed >> 24);
+	}
+	return bytes;
+}
+
+std::array<std::uint64_t, 256> reference_histogram(const char * data, std::size_t size)
+{
+	std::array<std::uint64_t, 256> histogram {};
+	for (std::size_t offset = 0; offset < size; ++offset)
+		++histogram[static_cast<BYTE>(data[offset])];
+	return histogram;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(section_statistics_suite)
+
+BOOST_AUTO_TEST_CASE(hash_does_not_depend_on_chunking)
+{
+	const std::vector<char> data = pseudo_random_bytes(0x4005, 1);
+	const ByteStatistics expected = byte_statistics(data.data(), data.size());
+
+	for (std::size_t chunk_size : { std::size_t(1), std::size_t(3), std::size_t(7), std::size_t(9), std::size_t(0x1001) }) {
+		detail::ByteStatisticsBuilder statistics_builder;
+		for (std::size_t offset = 0; offset < data.size(); offset += chunk_size)
+			statistics_builder.update(data.data() + offset, std::min(chunk_size, data.size() - offset));
+
+		const ByteStatistics statistics = statistics_builder.finish();
+		BOOST_TEST(statistics.hash == expected.hash);
+		BOOST_TEST(statistics.size == expected.size);
+		BOOST_TEST(statistics.histogram == expected.histogram);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(counts_uniform_runs)
+{
+	std::vector<char> data = pseudo_random_bytes(0x2000, 5);
+	std::fill(data.begin() + 0x100, data.begin() + 0x900, '\0');
+	std::fill(data.begin() + 0x913, data.begin() + 0xa27, '\xff');
+	std::fill(data.begin() + 0x1000, data.begin() + 0x1040, '\xcc');
+	data[0x1020] = '\xcd';
+
+	for (std::size_t first : { 0, 1, 15, 31 }) {
+		for (std::size_t size : { std::size_t(0), std::size_t(16), std::size_t(33), std::size_t(0x1fc0) }) {
+			const ByteStatistics statistics = byte_statistics(data.data() + first, size);
+			BOOST_TEST(statistics.histogram == reference_histogram(data.data() + first, size));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(computes_sections_in_parallel)
+{
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	builder.add_section(".text", pseudo_random_bytes(0x90003, 2), 0x60000020);
+	builder.add_section(".data", pseudo_random_bytes(0x80000, 3), 0xc0000040);
+	builder.add_section(".rsrc", pseudo_random_bytes(0x101, 4), 0x40000040);
+	const std::vector<char> file = builder.build_file();
+
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const std::vector<SectionStatistics> statistics = section_statistics(image, 4);
+	BOOST_REQUIRE_EQUAL(statistics.size(), 3u);
+
+	for (const SectionStatistics & section : statistics) {
+		const ByteStatistics expected = byte_statistics(file.data() + section.section_header.pointer_to_raw_data,
+		                                                section.section_header.size_of_raw_data);
+		BOOST_TEST(section.statistics.hash == expected.hash);
+		BOOST_TEST(section.statistics.entropy == expected.entropy);
+		BOOST_TEST(section.statistics.histogram == expected.histogram);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,270 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+#include <peplus/signature_scanner.hpp>
+#include <peplus/virtual_image.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+using Matches = std::vector<std::pair<std::size_t, std::size_t>>;
+
+struct PatternByte
+{
+	BYTE value;
+	BYTE mask;
+};
+
+class PseudoRandom
+{
+public:
+	explicit PseudoRandom(std::uint32_t seed) : _seed { seed } {}
+
+	std::uint32_t next(std::uint32_t bound)
+	{
+		_seed = _seed * 1664525 + 1013904223;
+		return (_seed >> 8) % bound;
+	}
+
+private:
+	std::uint32_t _seed;
+};
+
+Matches scanned_matches(const SignatureScanner & scanner, std::string_view data)
+{
+	Matches matches;
+	scanner.for_each_match(data, [&matches] (std::size_t signature, std::size_t offset) {
+		matches.emplace_back(signature, offset);
+	});
+	std::sort(matches.begin(), matches.end());
+	return matches;
+}
+
+Matches naive_matches(const std::vector<std::vector<PatternByte>> & patterns, std::string_view data)
+{
+	Matches matches;
+	for (std::size_t signature = 0; signature < patterns.size(); ++signature) {
+		const std::vector<PatternByte> & pattern = patterns[signature];
+		for (std::size_t offset = 0; offset + pattern.size() <= data.size(); ++offset) {
+			std::size_t i = 0;
+			while (i < pattern.size() && (static_cast<BYTE>(data[offset + i]) & pattern[i].mask) == pattern[i].value) ++i;
+			if (i == pattern.size()) matches.emplace_back(signature, offset);
+		}
+	}
+	std::sort(matches.begin(), matches.end());
+	return matches;
+}
+
+std::string format_pattern(const std::vector<PatternByte> & pattern)
+{
+	static const char HEX_DIGITS[] = "0123456789ABCDEF";
+	std::string text;
+	for (const PatternByte & pattern_byte : pattern) {
+		if (!text.empty()) text += ' ';
+		text += (pattern_byte.mask & 0xf0) != 0 ? HEX_DIGITS[pattern_byte.value >> 4] : '?';
+		text += (pattern_byte.mask & 0x0f) != 0 ? HEX_DIGITS[pattern_byte.value & 0xf] : '?';
+	}
+	return text;
+}
+
+std::string pattern_anchor(const std::vector<PatternByte> & pattern)
+{
+	std::size_t anchor_offset = 0, anchor_size = 0;
+	for (std::size_t run_begin = 0; run_begin < pattern.size(); ) {
+		if (pattern[run_begin].mask != 0xff) { ++run_begin; continue; }
+
+		std::size_t run_end = run_begin;
+		while (run_end < pattern.size() && pattern[run_end].mask == 0xff) ++run_end;
+		if (run_end - run_begin > anchor_size) {
+			anchor_offset = run_begin;
+			anchor_size = std::min(run_end - run_begin, detail::MAX_SIGNATURE_ANCHOR_SIZE);
+		}
+		run_begin = run_end;
+	}
+
+	std::string anchor;
+	for (std::size_t i = anchor_offset; i < anchor_offset + anchor_size; ++i)
+		anchor += static_cast<char>(pattern[i].value);
+	return anchor;
+}
+
+std::vector<PatternByte> random_pattern(PseudoRandom & random)
+{
+	std::vector<PatternByte> pattern (2 + random.next(10));
+	for (PatternByte & pattern_byte : pattern) {
+		const std::uint32_t kind = random.next(8);
+		pattern_byte.mask = kind == 0 ? 0x00 : kind == 1 ? 0xf0 : kind == 2 ? 0x0f : 0xff;
+		pattern_byte.value = static_cast<BYTE>(random.next(4) == 0 ? random.next(4) : random.next(256)) & pattern_byte.mask;
+	}
+	const std::size_t anchor = random.next(static_cast<std::uint32_t>(pattern.size()));
+	pattern[anchor].mask = 0xff;
+	pattern[anchor].value = static_cast<BYTE>(random.next(256));
+	return pattern;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(signature_scanner_suite)
+
+BOOST_AUTO_TEST_CASE(follows_failure_and_output_links)
+{
+	SignatureScanner scanner;
+	const std::size_t abcd = scanner.add("61 62 63 64");
+	const std::size_t bc = scanner.add("62 63");
+	const std::size_t c = scanner.add("63");
+	const std::size_t abce = scanner.add("61 62 63 65");
+	const std::size_t bcd = scanner.add("62 63 64");
+	scanner.compile();
+
+	BOOST_TEST((scanned_matches(scanner, "xabcdabcebcd") == Matches {
+		{ abcd, 1 }, { bc, 2 }, { bc, 6 }, { bc, 9 }, { c, 3 }, { c, 7 }, { c, 10 }, { abce, 5 }, { bcd, 2 }, { bcd, 9 },
+	}));
+}
+
+BOOST_AUTO_TEST_CASE(applies_wildcard_and_nibble_masks)
+{
+	SignatureScanner scanner;
+	const std::size_t signature = scanner.add("48 8B ?? 4? ?5 C3");
+	scanner.compile();
+
+	BOOST_TEST((scanned_matches(scanner, std::string_view("\x48\x8b\x00\x41\x15\xc3\x48\x8b\xff\x4f\xf5\xc3", 12))
+	            == Matches { { signature, 0 }, { signature, 6 } }));
+	BOOST_TEST(scanned_matches(scanner, std::string_view("\x48\x8b\x00\x51\x15\xc3", 6)).empty());
+	BOOST_TEST(scanned_matches(scanner, std::string_view("\x48\x8b\x00\x41\x16\xc3", 6)).empty());
+	BOOST_TEST(scanned_matches(scanner, std::string_view("\x48\x8b\x00\x41\x15", 5)).empty());
+	BOOST_CHECK_THROW(scanner.add("48 8"), std::runtime_error);
+	BOOST_CHECK_THROW(scanner.add("?? ?4"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(anchors_inside_pattern)
+{
+	SignatureScanner scanner;
+	const std::size_t signature = scanner.add("?? E8 ?? 11 22 33 ??");
+	scanner.compile();
+
+	BOOST_TEST(scanned_matches(scanner, std::string_view("\x11\x22\x33\x00", 4)).empty());
+	BOOST_TEST((scanned_matches(scanner, std::string_view("\x90\xe8\x00\x11\x22\x33\x00\x90\xe8\x00\x11\x22\x33", 13))
+	            == Matches { { signature, 0 } }));
+}
+
+BOOST_AUTO_TEST_CASE(requires_compile)
+{
+	SignatureScanner scanner;
+	scanner.add("90 90");
+	BOOST_TEST(!scanner.is_compiled());
+	BOOST_CHECK_THROW(scanned_matches(scanner, "data"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(matches_naive_scan_past_dense_states)
+{
+	PseudoRandom random { 7 };
+	std::vector<std::vector<PatternByte>> patterns;
+	std::set<std::string> trie_states { std::string() };
+	SignatureScanner scanner;
+	while (patterns.size() < 600) {
+		patterns.push_back(random_pattern(random));
+		scanner.add(format_pattern(patterns.back()));
+		const std::string anchor = pattern_anchor(patterns.back());
+		for (std::size_t size = 1; size <= anchor.size(); ++size)
+			trie_states.insert(anchor.substr(0, size));
+	}
+	BOOST_REQUIRE_GT(trie_states.size(), detail::MAX_DENSE_SIGNATURE_STATES);
+	scanner.compile();
+
+	std::string data (0x8000, '\0');
+	for (char & byte : data)
+		byte = static_cast<char>(random.next(4) == 0 ? random.next(4) : random.next(256));
+	for (int planted = 0; planted < 2000; ++planted) {
+		const std::vector<PatternByte> & pattern = patterns[random.next(static_cast<std::uint32_t>(patterns.size()))];
+		const std::size_t offset = random.next(static_cast<std::uint32_t>(data.size() - pattern.size()));
+		for (std::size_t i = 0; i < pattern.size(); ++i) {
+			const BYTE filler = static_cast<BYTE>(random.next(256)) & ~pattern[i].mask;
+			data[offset + i] = static_cast<char>(pattern[i].value | filler);
+		}
+	}
+
+	const Matches expected = naive_matches(patterns, data);
+	BOOST_TEST(expected.size() > 1000u);
+	BOOST_TEST((scanned_matches(scanner, data) == expected));
+}
+
+BOOST_AUTO_TEST_CASE(filters_sections_by_characteristics)
+{
+	const std::vector<char> code { '\x90', '\x55', '\x48', '\x89', '\xe5', '\x90' };
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	const DWORD text_rva = builder.add_section(".text", code, SCN_CNT_CODE | SCN_MEM_EXECUTE | SCN_MEM_READ);
+	const DWORD data_rva = builder.add_section(".data", code, SCN_MEM_READ | SCN_MEM_WRITE);
+	const std::vector<char> file = builder.build_file();
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+
+	SignatureScanner scanner;
+	const std::size_t executable_only = scanner.add("55 48 89 E5", SCN_MEM_EXECUTE);
+	const std::size_t anywhere = scanner.add("48 89 E5");
+	const std::size_t writable_only = scanner.add("90 55", SCN_MEM_WRITE);
+	scanner.compile();
+
+	std::vector<SignatureMatch> matches = scanner.scan(image);
+	std::sort(matches.begin(), matches.end(), [] (const SignatureMatch & lhs, const SignatureMatch & rhs) {
+		return std::pair(lhs.rva, lhs.signature) < std::pair(rhs.rva, rhs.signature);
+	});
+	BOOST_REQUIRE_EQUAL(matches.size(), 4u);
+
+	BOOST_TEST(matches[0].signature == executable_only);
+	BOOST_TEST(matches[0].rva.value() == std::ptrdiff_t(text_rva + 1));
+	BOOST_TEST(matches[0].section_name == ".text");
+	BOOST_TEST(matches[0].section_index == 0u);
+	BOOST_REQUIRE(matches[0].file_offset);
+	BOOST_TEST(matches[0].file_offset->value() == 0x201);
+	BOOST_TEST(matches[1].signature == anywhere);
+	BOOST_TEST(matches[1].rva.value() == std::ptrdiff_t(text_rva + 2));
+	BOOST_TEST(matches[2].signature == writable_only);
+	BOOST_TEST(matches[2].rva.value() == std::ptrdiff_t(data_rva));
+	BOOST_TEST(matches[2].section_name == ".data");
+	BOOST_TEST(matches[2].section_index == 1u);
+	BOOST_TEST(matches[3].signature == anywhere);
+	BOOST_TEST(matches[3].rva.value() == std::ptrdiff_t(data_rva + 2));
+}
+
+BOOST_AUTO_TEST_CASE(omits_file_offset_in_virtual_tail)
+{
+	std::vector<char> data (0x300, '\0');
+	data[0x10] = '\xcc';
+	data[0x11] = '\xc3';
+	data[0x280] = '\xcc';
+	data[0x281] = '\xc3';
+
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	const DWORD data_rva = builder.add_section(".data", data, SCN_MEM_READ | SCN_MEM_WRITE);
+	std::vector<char> image_mem = builder.build_mapped();
+	const std::size_t section_header_offset = test::ImageBuilder::NT_HEADERS_OFFSET + 4 + sizeof(FileHeader) + sizeof(OptionalHeader<64>);
+	detail::store_le_value<DWORD>(image_mem.data() + section_header_offset + offsetof(SectionHeader, size_of_raw_data), 0x200);
+	const VirtualImage<64, local_buffer> image { LocalBuffer(image_mem.data(), image_mem.size()) };
+
+	SignatureScanner scanner;
+	scanner.add("CC C3");
+	scanner.compile();
+
+	const std::vector<SignatureMatch> matches = scanner.scan(image);
+	BOOST_REQUIRE_EQUAL(matches.size(), 2u);
+	BOOST_TEST(matches[0].rva.value() == std::ptrdiff_t(data_rva + 0x10));
+	BOOST_REQUIRE(matches[0].file_offset);
+	BOOST_TEST(matches[0].file_offset->value() == 0x210);
+	BOOST_TEST(matches[1].rva.value() == std::ptrdiff_t(data_rva + 0x280));
+	BOOST_TEST(!matches[1].file_offset);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
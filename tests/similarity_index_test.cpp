@@ -0,0 +1,89 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+#include <peplus/similarity_index.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+MinHashSignature signature_of(std::uint64_t first_feature, std::size_t feature_count)
+{
+	std::vector<std::uint64_t> features;
+	for (std::size_t i = 0; i < feature_count; ++i)
+		features.push_back((first_feature + i) * 0x9e3779b97f4a7c15);
+	return *minhash(features);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(similarity_index_suite)
+
+BOOST_AUTO_TEST_CASE(empty_feature_sets_have_no_signature)
+{
+	BOOST_TEST(!minhash(std::vector<std::uint64_t>()).has_value());
+	BOOST_TEST(minhash(std::vector<std::uint64_t> { 1 }).has_value());
+
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	builder.add_section(".text", std::vector<char>(0x200, '\xcc'), 0x60000020);
+	const std::vector<char> file = builder.build_file();
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	BOOST_TEST(!import_minhash(image).has_value());
+	BOOST_TEST(section_minhash(image).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(rejects_empty_signatures)
+{
+	MinHashSignature empty_signature;
+	empty_signature.fill(0xffffffff);
+
+	SimilarityIndex index;
+	BOOST_CHECK_THROW(index.insert(empty_signature), std::runtime_error);
+
+	const std::vector<MinHashSignature> signatures { signature_of(0, 10), empty_signature };
+	BOOST_CHECK_THROW(index.insert(signatures.begin(), signatures.end()), std::runtime_error);
+	BOOST_TEST(index.empty());
+
+	index.insert(signatures[0]);
+	BOOST_TEST(index.query(empty_signature).empty());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_insertion_matches_sequential)
+{
+	std::vector<MinHashSignature> signatures;
+	for (std::size_t i = 0; i < detail::SIMILARITY_PARALLEL_THRESHOLD + 0x123; ++i)
+		signatures.push_back(signature_of(i * 4, 16));
+
+	SimilarityIndex parallel_index, sequential_index;
+	parallel_index.insert(signatures.begin(), signatures.end(), 4);
+	for (const MinHashSignature & signature : signatures)
+		sequential_index.insert(signature);
+
+	for (std::size_t id : { std::size_t(0), std::size_t(0x800), signatures.size() - 1 }) {
+		const std::vector<SimilarityMatch> parallel_matches = parallel_index.query(signatures[id], 0.5);
+		const std::vector<SimilarityMatch> sequential_matches = sequential_index.query(signatures[id], 0.5);
+		BOOST_REQUIRE_EQUAL(parallel_matches.size(), sequential_matches.size());
+		BOOST_REQUIRE(!parallel_matches.empty());
+		BOOST_TEST(parallel_matches.front().id == id);
+		for (std::size_t i = 0; i < parallel_matches.size(); ++i)
+			BOOST_TEST(parallel_matches[i].id == sequential_matches[i].id);
+	}
+
+	std::stringstream stream;
+	parallel_index.save(stream);
+	const SimilarityIndex loaded_index = SimilarityIndex::load(stream, 4);
+	BOOST_TEST(loaded_index.size() == signatures.size());
+	BOOST_TEST(loaded_index.query(signatures[7], 1.0).front().id == 7u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
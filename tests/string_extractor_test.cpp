@@ -0,0 +1,137 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+#include <peplus/string_extractor.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+using namespace peplus;
+
+namespace {
+
+struct ExpectedRun
+{
+	StringEncoding encoding;
+	std::size_t    offset;
+	std::size_t    size;
+
+	bool operator==(const ExpectedRun & other) const
+	{
+		return encoding == other.encoding && offset == other.offset && size == other.size;
+	}
+};
+
+std::ostream & operator<<(std::ostream & os, const ExpectedRun & run)
+{
+	return os << (run.encoding == StringEncoding::Ascii ? "ascii" : "utf16") << '@' << run.offset << '+' << run.size;
+}
+
+std::vector<char> string_soup(std::size_t size, std::uint32_t seed)
+{
+	const std::string_view alphabet { "\0\0\0\0\0\tAbc xyz~\x7f\x80\xff\x01", 20 };
+	std::vector<char> bytes (size);
+	for (char & byte : bytes) {
+		seed = seed * 1664525 + 1013904223;
+		byte = alphabet[(seed >> 16) % alphabet.size()];
+	}
+	return bytes;
+}
+
+std::vector<ExpectedRun> reference_runs(std::string_view data, std::size_t min_length)
+{
+	std::vector<ExpectedRun> runs;
+	for (std::size_t begin = 0; begin < data.size(); ) {
+		std::size_t end = begin;
+		while (end < data.size() && detail::is_printable_char(data[end])) ++end;
+		if (end - begin >= min_length) runs.push_back(ExpectedRun { StringEncoding::Ascii, begin, end - begin });
+		begin = end + 1;
+	}
+
+	for (std::size_t phase = 0; phase < 2; ++phase) {
+		const auto is_wide = [&] (std::size_t offset) {
+			return offset + 1 < data.size() && detail::is_printable_char(data[offset]) && data[offset + 1] == '\0';
+		};
+		for (std::size_t begin = phase; begin < data.size(); ) {
+			std::size_t end = begin;
+			while (end < data.size() && is_wide(end)) end += 2;
+			if ((end - begin) / 2 >= min_length) runs.push_back(ExpectedRun { StringEncoding::Utf16, begin, end - begin });
+			begin = end + 2;
+		}
+	}
+
+	std::sort(runs.begin(), runs.end(), [] (const ExpectedRun & lhs, const ExpectedRun & rhs) {
+		return lhs.offset < rhs.offset || (lhs.offset == rhs.offset && lhs.encoding < rhs.encoding);
+	});
+	return runs;
+}
+
+std::vector<ExpectedRun> found_runs(std::string_view data, std::size_t min_length)
+{
+	std::vector<detail::StringRun> runs;
+	detail::find_string_runs(data, min_length, runs);
+
+	std::vector<ExpectedRun> expected_runs;
+	for (const detail::StringRun & run : runs)
+		expected_runs.push_back(ExpectedRun { run.encoding, run.offset, run.size });
+	return expected_runs;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(string_extractor_suite)
+
+BOOST_AUTO_TEST_CASE(counts_trailing_zeros)
+{
+	for (unsigned int bit = 0; bit < 32; ++bit) {
+		BOOST_TEST(detail::count_trailing_zeros(std::uint32_t(1) << bit) == bit);
+		BOOST_TEST(detail::count_trailing_zeros(~std::uint32_t(0) << bit) == bit);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(finds_runs_like_a_scalar_scan)
+{
+	const std::vector<char> data = string_soup(0x2003, 7);
+	for (std::size_t length : { std::size_t(0x2003), std::size_t(0x200), std::size_t(17), std::size_t(16), std::size_t(5) }) {
+		const std::string_view window { data.data(), length };
+		for (std::size_t min_length : { std::size_t(1), std::size_t(2), std::size_t(4) }) {
+			const std::vector<ExpectedRun> runs = found_runs(window, min_length);
+			const std::vector<ExpectedRun> expected = reference_runs(window, min_length);
+			BOOST_TEST(runs == expected, boost::test_tools::per_element());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(extracts_sections_in_parallel)
+{
+	test::ImageBuilder builder { 64, 0x140000000ull };
+	builder.add_section(".text", string_soup(0x80011, 1), 0x60000020);
+	builder.add_section(".rdata", string_soup(0x80000, 2), 0x40000040);
+	builder.add_section(".data", string_soup(0x1234, 3), 0xc0000040);
+	const std::vector<char> file = builder.build_file();
+
+	const FileImage<64, local_buffer> image { LocalBuffer(file.data(), file.size()) };
+	const std::vector<ExtractedString> parallel_strings = extract_strings(image, 6, 4);
+
+	std::vector<ExtractedString> sequential_strings;
+	for_each_string(image, [&] (const ExtractedString & extracted, std::string_view) {
+		sequential_strings.push_back(extracted);
+	}, 6);
+
+	BOOST_REQUIRE_EQUAL(parallel_strings.size(), sequential_strings.size());
+	BOOST_TEST(!parallel_strings.empty());
+	for (std::size_t i = 0; i < parallel_strings.size(); ++i) {
+		BOOST_TEST(parallel_strings[i].section_index == sequential_strings[i].section_index);
+		BOOST_TEST(parallel_strings[i].rva.value() == sequential_strings[i].rva.value());
+		BOOST_TEST(parallel_strings[i].size == sequential_strings[i].size);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,197 @@
+#include "image_builder.hpp"
+
+#include <peplus/file_image.hpp>
+#include <peplus/local_buffer.hpp>
+#include <peplus/x64_unwinder.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace peplus;
+using detail::store_le_value;
+
+namespace {
+
+const ULONGLONG IMAGE_BASE = 0x140000000;
+const ULONGLONG RETURN_ADDRESS = 0x7ff600001234;
+const DWORD TEXT_RVA = 0x1000;
+
+const DWORD SAVE_XMM128_FUNCTION = 0x000;
+const DWORD SAVE_XMM128_FAR_FUNCTION = 0x040;
+const DWORD MACHINE_FRAME_FUNCTION = 0x080;
+const DWORD EPILOG_V2_FUNCTION = 0x0c0;
+const DWORD SAVE_XMM_V1_FUNCTION = 0x100;
+const DWORD FUNCTION_SIZE = 0x40;
+
+WORD unwind_code(BYTE code_offset, unsigned int unwind_op, unsigned int op_info)
+{
+	return static_cast<WORD>(code_offset | unwind_op << 8 | op_info << 12);
+}
+
+DWORD append_unwind_info(std::vector<char> & xdata, BYTE version, BYTE size_of_prolog, const std::vector<WORD> & code_slots)
+{
+	const DWORD unwind_info_offset = static_cast<DWORD>(xdata.size());
+	xdata.push_back(static_cast<char>(version));
+	xdata.push_back(static_cast<char>(size_of_prolog));
+	xdata.push_back(static_cast<char>(code_slots.size()));
+	xdata.push_back(0);
+	for (const WORD code_slot : code_slots) {
+		xdata.resize(xdata.size() + sizeof(WORD));
+		store_le_value<WORD>(xdata.data() + xdata.size() - sizeof(WORD), code_slot);
+	}
+	xdata.resize(test::align_up(static_cast<DWORD>(xdata.size()), sizeof(DWORD)));
+	return unwind_info_offset;
+}
+
+std::vector<char> build_unwind_image()
+{
+	std::vector<char> xdata;
+	const std::vector<std::pair<DWORD, DWORD>> functions {
+		{ SAVE_XMM128_FUNCTION, append_unwind_info(xdata, 1, 10, {
+			unwind_code(10, UWOP_SAVE_XMM128, 6), 0x0003,
+			unwind_code(5, UWOP_ALLOC_SMALL, 8),
+			unwind_code(1, UWOP_PUSH_NONVOL, X64_RBX),
+		}) },
+		{ SAVE_XMM128_FAR_FUNCTION, append_unwind_info(xdata, 1, 13, {
+			unwind_code(13, UWOP_SAVE_XMM128_FAR, 7), 0x0030, 0x0000,
+			unwind_code(5, UWOP_ALLOC_SMALL, 8),
+			unwind_code(1, UWOP_PUSH_NONVOL, X64_RBX),
+		}) },
+		{ MACHINE_FRAME_FUNCTION, append_unwind_info(xdata, 1, 1, {
+			unwind_code(1, UWOP_PUSH_NONVOL, X64_RBX),
+			unwind_code(0, UWOP_PUSH_MACHFRAME, 0),
+		}) },
+		{ EPILOG_V2_FUNCTION, append_unwind_info(xdata, 2, 1, {
+			unwind_code(2, UWOP_EPILOG, 1),
+			unwind_code(1, UWOP_PUSH_NONVOL, X64_RBX),
+		}) },
+		{ SAVE_XMM_V1_FUNCTION, append_unwind_info(xdata, 1, 9, {
+			unwind_code(9, UWOP_SAVE_XMM, 7), 0x0004,
+			unwind_code(4, UWOP_ALLOC_SMALL, 5),
+		}) },
+	};
+
+	test::ImageBuilder builder { 64, IMAGE_BASE };
+	builder.add_section(".text", std::vector<char>(0x200, '\x90'), 0x60000020);
+	const DWORD xdata_rva = builder.add_section(".xdata", xdata, 0x40000040);
+
+	std::vector<char> pdata (functions.size() * sizeof(RuntimeFunction));
+	for (std::size_t i = 0; i < functions.size(); ++i) {
+		char * const runtime_function = pdata.data() + i * sizeof(RuntimeFunction);
+		store_le_value<DWORD>(runtime_function, TEXT_RVA + functions[i].first);
+		store_le_value<DWORD>(runtime_function + 4, TEXT_RVA + functions[i].first + FUNCTION_SIZE);
+		store_le_value<DWORD>(runtime_function + 8, xdata_rva + functions[i].second);
+	}
+	const DWORD pdata_rva = builder.next_section_rva();
+	builder.set_data_directory(DIRECTORY_ENTRY_EXCEPTION, pdata_rva, static_cast<DWORD>(pdata.size()));
+	builder.add_section(".pdata", pdata, 0x40000040);
+	return builder.build_file();
+}
+
+struct UnwindFixture
+{
+	UnwindFixture()
+		: image_data { build_unwind_image() }
+		, image { LocalBuffer(image_data.data(), image_data.size()) }
+		, unwinder { image }
+		, stack (0x1000)
+		, memory { stack.data(), stack.size() } {}
+
+	X64Context context_at(DWORD function_rva, ULONGLONG rsp) const
+	{
+		X64Context context {};
+		context.rip = IMAGE_BASE + TEXT_RVA + function_rva + 0x20;
+		context.gpr[X64_RSP] = rsp;
+		return context;
+	}
+
+	void put(ULONGLONG address, ULONGLONG value)
+	{
+		store_le_value<ULONGLONG>(stack.data() + address, value);
+	}
+
+	std::vector<char>                       image_data;
+	FileImage64<local_buffer>               image;
+	X64Unwinder<FileImage64<local_buffer>>  unwinder;
+	std::vector<char>                       stack;
+	LocalBuffer                             memory;
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(x64_unwinder, UnwindFixture)
+
+BOOST_AUTO_TEST_CASE(restores_xmm128_saves)
+{
+	X64Context context = context_at(SAVE_XMM128_FUNCTION, 0x100);
+	put(0x130, 0x1111), put(0x138, 0x2222), put(0x148, 0xbbbb), put(0x150, RETURN_ADDRESS);
+	BOOST_TEST(unwinder.unwind_frame<local_buffer>(context, memory));
+	BOOST_TEST(context.rip == RETURN_ADDRESS);
+	BOOST_TEST(context.gpr[X64_RSP] == 0x158u);
+	BOOST_TEST(context.gpr[X64_RBX] == 0xbbbbu);
+	BOOST_TEST(context.xmm[6][0] == 0x1111u);
+	BOOST_TEST(context.xmm[6][1] == 0x2222u);
+
+	context = context_at(SAVE_XMM128_FAR_FUNCTION, 0x200);
+	put(0x230, 0x3333), put(0x238, 0x4444), put(0x248, 0xcccc), put(0x250, RETURN_ADDRESS);
+	BOOST_TEST(unwinder.unwind_frame<local_buffer>(context, memory));
+	BOOST_TEST(context.rip == RETURN_ADDRESS);
+	BOOST_TEST(context.gpr[X64_RSP] == 0x258u);
+	BOOST_TEST(context.gpr[X64_RBX] == 0xccccu);
+	BOOST_TEST(context.xmm[7][0] == 0x3333u);
+	BOOST_TEST(context.xmm[7][1] == 0x4444u);
+}
+
+BOOST_AUTO_TEST_CASE(restores_machine_frames)
+{
+	X64Context context = context_at(MACHINE_FRAME_FUNCTION, 0x300);
+	put(0x300, 0xbbbb), put(0x308, RETURN_ADDRESS), put(0x320, 0x800);
+	BOOST_TEST(unwinder.unwind_frame<local_buffer>(context, memory));
+	BOOST_TEST(context.rip == RETURN_ADDRESS);
+	BOOST_TEST(context.gpr[X64_RSP] == 0x800u);
+	BOOST_TEST(context.gpr[X64_RBX] == 0xbbbbu);
+}
+
+BOOST_AUTO_TEST_CASE(decodes_codes_by_version)
+{
+	X64Context context = context_at(EPILOG_V2_FUNCTION, 0x400);
+	put(0x400, 0xbbbb), put(0x408, RETURN_ADDRESS);
+	BOOST_TEST(unwinder.unwind_frame<local_buffer>(context, memory));
+	BOOST_TEST(context.rip == RETURN_ADDRESS);
+	BOOST_TEST(context.gpr[X64_RSP] == 0x410u);
+	BOOST_TEST(context.gpr[X64_RBX] == 0xbbbbu);
+
+	context = context_at(SAVE_XMM_V1_FUNCTION, 0x500);
+	put(0x520, 0x5555), put(0x530, RETURN_ADDRESS);
+	BOOST_TEST(unwinder.unwind_frame<local_buffer>(context, memory));
+	BOOST_TEST(context.rip == RETURN_ADDRESS);
+	BOOST_TEST(context.gpr[X64_RSP] == 0x538u);
+	BOOST_TEST(context.xmm[7][0] == 0x5555u);
+}
+
+BOOST_AUTO_TEST_CASE(shares_unwind_cache_across_threads)
+{
+	put(0x130, 0x1111), put(0x138, 0x2222), put(0x148, 0xbbbb), put(0x150, RETURN_ADDRESS);
+	put(0x300, 0xbbbb), put(0x308, RETURN_ADDRESS), put(0x320, 0x800);
+
+	std::atomic<unsigned int> unwound_frames { 0 };
+	std::vector<std::thread> threads;
+	for (unsigned int i = 0; i < 4; ++i) {
+		threads.emplace_back([&] {
+			for (unsigned int j = 0; j < 1000; ++j) {
+				X64Context context = context_at(j % 2 == 0 ? SAVE_XMM128_FUNCTION : MACHINE_FRAME_FUNCTION, j % 2 == 0 ? 0x100 : 0x300);
+				if (unwinder.unwind_frame<local_buffer>(context, memory) && context.rip == RETURN_ADDRESS)
+					++unwound_frames;
+			}
+		});
+	}
+	for (std::thread & thread : threads)
+		thread.join();
+
+	BOOST_TEST(unwound_frames == 4000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()